@@ -34,12 +34,15 @@ source distribution.
 #include <crogine/core/MessageBus.hpp>
 #include <crogine/core/Window.hpp>
 #include <crogine/core/Clock.hpp>
+#include <crogine/core/WorkerPool.hpp>
 #include <crogine/detail/Types.hpp>
 
 #include <crogine/graphics/Colour.hpp>
+#include <crogine/graphics/StreamBuffer.hpp>
 
 #include <vector>
 #include <map>
+#include <memory>
 
 #ifdef _DEBUG_
 #define DPRINT(x, y) cro::App::debugPrint(x, y)
@@ -92,6 +95,31 @@ namespace cro
         */
         static Window& getWindow();
 
+        /*!
+        \brief Returns a reference to the application's pool of worker threads.
+        Systems use this to spread work such as culling across available cores.
+        The pool only exists once an App has been successfully created, which
+        can be checked with hasWorkerPool().
+        */
+        static WorkerPool& getWorkerPool();
+
+        /*!
+        \brief Returns true if there is an App instance with a valid WorkerPool
+        */
+        static bool hasWorkerPool();
+
+        /*!
+        \brief Returns a reference to the buffer shared by systems which
+        stream new vertex data to the GPU every frame.
+        This is only valid once the window has been created.
+        */
+        static StreamBuffer& getStreamBuffer();
+
+        /*!
+        \brief Returns true if there is an App instance with a valid StreamBuffer
+        */
+        static bool hasStreamBuffer();
+
         /*!
         \brief Returns a reference to the system message bus
         */
@@ -153,6 +181,9 @@ namespace cro
 
 		static App* m_instance;
 
+        std::unique_ptr<WorkerPool> m_workerPool;
+        std::unique_ptr<StreamBuffer> m_streamBuffer;
+
         std::map<int32, SDL_GameController*> m_controllers;
         std::map<int32, SDL_Joystick*> m_joysticks;
         friend class GameController;
@@ -0,0 +1,105 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#ifndef CRO_WORKER_POOL_HPP_
+#define CRO_WORKER_POOL_HPP_
+
+#include <crogine/Config.hpp>
+#include <crogine/detail/Types.hpp>
+
+#include <SDL_thread.h>
+#include <SDL_mutex.h>
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+namespace cro
+{
+    /*!
+    \brief A pool of worker threads used to spread work such as culling
+    across multiple CPU cores.
+    The App class owns a single pool which is available via App::getWorkerPool().
+    Work is submitted with parallelFor(), which blocks until all the work is complete,
+    so any data written by the tasks is safe to read once the function returns.
+    */
+    class CRO_EXPORT_API WorkerPool final
+    {
+    public:
+        /*!
+        \brief Constructor.
+        \param threadCount Number of worker threads to create. By default
+        this is one less than the number of available CPU cores, as the
+        thread calling parallelFor() also performs work.
+        */
+        explicit WorkerPool(std::size_t threadCount = 0);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool(WorkerPool&&) = delete;
+        WorkerPool& operator = (const WorkerPool&) = delete;
+        WorkerPool& operator = (WorkerPool&&) = delete;
+
+        /*!
+        \brief Returns the number of threads which perform work when
+        parallelFor() is called, including the calling thread.
+        */
+        std::size_t getThreadCount() const { return m_threads.size() + 1; }
+
+        /*!
+        \brief Calls the given task once for each index in the range 0 - count.
+        Indices are distributed across the worker threads with no guaranteed
+        order so tasks must not depend on each other. Blocks until every index
+        has been processed. If the pool is already busy (for instance if called
+        from within a task) the work is performed on the calling thread.
+        */
+        void parallelFor(std::size_t count, const std::function<void(std::size_t)>& task);
+
+    private:
+        std::vector<SDL_Thread*> m_threads;
+        SDL_mutex* m_mutex;
+        SDL_cond* m_jobCondition;
+        SDL_cond* m_doneCondition;
+
+        const std::function<void(std::size_t)>* m_task;
+        std::size_t m_taskCount;
+        std::atomic<std::size_t> m_nextTask;
+        std::atomic<std::size_t> m_completedTasks;
+        uint32 m_generation;
+        std::size_t m_activeThreads;
+        bool m_quit;
+
+        std::atomic<bool> m_busy;
+
+        static int threadFunc(void*);
+        void runTasks(const std::function<void(std::size_t)>&, std::size_t);
+    };
+}
+
+#endif //CRO_WORKER_POOL_HPP_
@@ -0,0 +1,175 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#ifndef CRO_CULLING_HPP_
+#define CRO_CULLING_HPP_
+
+#include <crogine/Config.hpp>
+#include <crogine/detail/Types.hpp>
+#include <crogine/graphics/Spatial.hpp>
+
+#include <array>
+#include <vector>
+
+namespace cro
+{
+    namespace Detail
+    {
+        /*!
+        \brief Stores bounding spheres as a structure of arrays.
+        Storage is padded to a multiple of BatchSize so that the
+        culling functions can process spheres in batches using
+        SIMD instructions without having to handle a remainder.
+        */
+        class CRO_EXPORT_API SphereArray final
+        {
+        public:
+            static constexpr std::size_t BatchSize = 8;
+
+            /*!
+            \brief Removes all spheres from the array
+            */
+            void clear();
+
+            /*!
+            \brief Reserves space for at least the given number of spheres
+            */
+            void reserve(std::size_t);
+
+            /*!
+            \brief Appends a sphere to the array
+            */
+            void push_back(const Sphere&);
+
+            /*!
+            \brief Returns the number of spheres in the array
+            */
+            std::size_t size() const { return m_count; }
+
+            /*!
+            \brief Returns the padded size of the array storage.
+            This is always a multiple of BatchSize.
+            */
+            std::size_t paddedSize() const { return m_radius.size(); }
+
+            const float* getX() const { return m_x.data(); }
+            const float* getY() const { return m_y.data(); }
+            const float* getZ() const { return m_z.data(); }
+            const float* getRadius() const { return m_radius.data(); }
+
+        private:
+            std::size_t m_count = 0;
+            std::vector<float> m_x;
+            std::vector<float> m_y;
+            std::vector<float> m_z;
+            std::vector<float> m_radius;
+        };
+
+        /*!
+        \brief Stores axis aligned bounding boxes as a structure of arrays.
+        Boxes are stored as their centre and half extents, and padded in
+        the same way as SphereArray.
+        */
+        class CRO_EXPORT_API BoxArray final
+        {
+        public:
+            static constexpr std::size_t BatchSize = SphereArray::BatchSize;
+
+            /*!
+            \brief Removes all boxes from the array
+            */
+            void clear();
+
+            /*!
+            \brief Reserves space for at least the given number of boxes
+            */
+            void reserve(std::size_t);
+
+            /*!
+            \brief Appends a box to the array
+            */
+            void push_back(const Box&);
+
+            /*!
+            \brief Returns the number of boxes in the array
+            */
+            std::size_t size() const { return m_count; }
+
+            /*!
+            \brief Returns the padded size of the array storage.
+            This is always a multiple of BatchSize.
+            */
+            std::size_t paddedSize() const { return m_x.size(); }
+
+            const float* getX() const { return m_x.data(); }
+            const float* getY() const { return m_y.data(); }
+            const float* getZ() const { return m_z.data(); }
+            const float* getExtentX() const { return m_extentX.data(); }
+            const float* getExtentY() const { return m_extentY.data(); }
+            const float* getExtentZ() const { return m_extentZ.data(); }
+
+        private:
+            std::size_t m_count = 0;
+            std::vector<float> m_x;
+            std::vector<float> m_y;
+            std::vector<float> m_z;
+            std::vector<float> m_extentX;
+            std::vector<float> m_extentY;
+            std::vector<float> m_extentZ;
+        };
+
+        namespace Culling
+        {
+            /*!
+            \brief Tests all spheres in the given array against the frustum.
+            Output is resized to the padded size of the sphere array and each
+            entry set to non-zero if the corresponding sphere is not completely
+            behind any one of the frustum planes. This is equivalent to testing
+            each sphere with Spatial::intersects() and rejecting it if the result
+            is Planar::Back, but uses SSE, AVX or NEON where available.
+            */
+            void CRO_EXPORT_API frustumCull(const Frustum&, const SphereArray&, std::vector<uint8>& output);
+
+            /*!
+            \brief Tests all boxes in the given array against the frustum.
+            \see frustumCull(const Frustum&, const SphereArray&, std::vector<uint8>&)
+            */
+            void CRO_EXPORT_API frustumCull(const Frustum&, const BoxArray&, std::vector<uint8>& output);
+
+            /*!
+            \brief Performs the same test as frustumCull() using the scalar
+            functions found in Spatial. Useful for validating the output of frustumCull()
+            */
+            void CRO_EXPORT_API frustumCullScalar(const Frustum&, const SphereArray&, std::vector<uint8>& output);
+            void CRO_EXPORT_API frustumCullScalar(const Frustum&, const BoxArray&, std::vector<uint8>& output);
+        }
+    }
+}
+
+#endif //CRO_CULLING_HPP_
@@ -0,0 +1,159 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#ifndef CRO_GL_RECORDER_HPP_
+#define CRO_GL_RECORDER_HPP_
+
+#include <crogine/Config.hpp>
+#include <crogine/detail/Types.hpp>
+
+#include <array>
+#include <vector>
+
+namespace cro
+{
+    namespace Detail
+    {
+        /*!
+        \brief Headless OpenGL backend which records the command stream.
+        When installed, the GL function pointers used by all of crogine's
+        renderers are replaced with functions which record each call instead
+        of passing it to the driver. No GL context (or GPU) is required, so
+        rendering systems can be run on headless machines for regression
+        testing and benchmarking CPU side render submission.
+        Object creation functions return unique IDs, shaders always compile
+        and link successfully, and framebuffers are always complete. Queries
+        return default values, with the exception of glIsEnabled() which
+        reflects the recorded state.
+        \begincode
+        GLRecorder::install();
+        //create resources and render a frame as usual
+        auto drawCalls = GLRecorder::getStats().drawCalls;
+        GLRecorder::uninstall();
+        \endcode
+        This is not thread safe, and should be installed before any
+        GL resources are created, and uninstalled after they are all
+        destroyed, else resources are mixed between the two backends.
+        Resources shared through the App, such as its StreamBuffer, were
+        created with the driver so systems which use them should be given
+        their own with ParticleSystem::setStreamBuffer(). The ModelRenderer
+        and ParticleSystem only use their WorkerPool for culling and simulation,
+        so GL calls are always made from the rendering thread. The App's pool
+        may be kept, or removed with setWorkerPool(nullptr) so that recorded
+        timings are not affected by other work queued on it.
+        */
+        class CRO_EXPORT_API GLRecorder final
+        {
+        public:
+            /*!
+            \brief A recorded GL command
+            */
+            struct Command final
+            {
+                enum Type
+                {
+                    Draw,
+                    Clear,
+                    UseProgram,
+                    BindBuffer,
+                    BindTexture,
+                    BindFramebuffer,
+                    BindVertexArray,
+                    Upload, //< buffer and texture data
+                    Uniform,
+                    State, //< enable, disable, blending, viewport etc
+                    VertexAttrib,
+                    Resource, //< object creation, deletion and shader compilation
+                    Query
+                }type = State;
+                const char* name = ""; //< name of the GL function, eg "glDrawElements"
+                std::array<int64, 4u> args{}; //< the first integer arguments of the call
+                std::size_t bytes = 0; //< number of bytes uploaded, if any
+            };
+
+            /*!
+            \brief Running totals of recorded commands
+            */
+            struct Stats final
+            {
+                std::size_t drawCalls = 0;
+                std::size_t elementsDrawn = 0; //< vertices or indices
+                std::size_t programChanges = 0;
+                std::size_t bufferBinds = 0;
+                std::size_t textureBinds = 0;
+                std::size_t framebufferBinds = 0;
+                std::size_t redundantBinds = 0; //< binds of a program, buffer or texture which was already bound
+                std::size_t uniformUpdates = 0;
+                std::size_t stateChanges = 0;
+                std::size_t uploads = 0;
+                std::size_t bytesUploaded = 0;
+            };
+
+            /*!
+            \brief Replaces the GL functions with recording functions
+            */
+            static void install();
+
+            /*!
+            \brief Restores the original GL functions
+            */
+            static void uninstall();
+
+            /*!
+            \brief Returns true if the recording backend is currently installed
+            */
+            static bool isInstalled();
+
+            /*!
+            \brief Clears the recorded commands and stats, for example at the
+            beginning of each frame. Bound object state is kept.
+            */
+            static void reset();
+
+            /*!
+            \brief Enables or disables storing of individual commands.
+            Stats are always updated, so disabling this keeps memory usage
+            constant when benchmarking many frames. Enabled by default.
+            */
+            static void setCommandsEnabled(bool enabled);
+
+            /*!
+            \brief Returns the commands recorded since the last reset()
+            */
+            static const std::vector<Command>& getCommands();
+
+            /*!
+            \brief Returns the stats recorded since the last reset()
+            */
+            static const Stats& getStats();
+        };
+    }
+}
+
+#endif //CRO_GL_RECORDER_HPP_
\ No newline at end of file
@@ -0,0 +1,113 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#ifndef CRO_OCCLUSION_BUFFER_HPP_
+#define CRO_OCCLUSION_BUFFER_HPP_
+
+#include <crogine/Config.hpp>
+#include <crogine/detail/Types.hpp>
+#include <crogine/graphics/Spatial.hpp>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+#include <vector>
+
+namespace cro
+{
+    namespace Detail
+    {
+        /*!
+        \brief Coarse depth buffer rasterised on the CPU.
+        Occluder triangles are rasterised into the buffer, after which
+        bounding boxes can be tested against it to see if they are completely
+        hidden. Depth is stored as normalised device Z. The test is conservative:
+        only pixels completely covered by a triangle are written, using the
+        farthest depth of the triangle within the pixel, and triangles which
+        cross the near plane are skipped, so a visible box is never reported
+        as hidden.
+        */
+        class CRO_EXPORT_API OcclusionBuffer final
+        {
+        public:
+            /*!
+            \brief Constructor.
+            \param width Width of the buffer in pixels. This is rounded up to a multiple of 8
+            \param height Height of the buffer in pixels.
+            */
+            OcclusionBuffer(uint32 width = 256, uint32 height = 128);
+
+            /*!
+            \brief Clears the buffer and sets the view-projection matrix
+            used by subsequent calls to rasterise() and isVisible()
+            */
+            void clear(const glm::mat4& viewProjection);
+
+            /*!
+            \brief Rasterises the given indexed triangle list into the buffer
+            \param worldMatrix Transform applied to the vertices
+            \param vertices Model space vertex positions
+            \param indices Triangle list indices into the vertex array
+            */
+            void rasterise(const glm::mat4& worldMatrix, const std::vector<glm::vec3>& vertices, const std::vector<uint16>& indices);
+
+            /*!
+            \brief Returns false if the given world space box is completely
+            hidden by previously rasterised occluders
+            */
+            bool isVisible(const Box& box) const;
+
+            /*!
+            \brief Returns true if no occluders have been rasterised since the last clear
+            */
+            bool empty() const { return m_empty; }
+
+            uint32 getWidth() const { return m_width; }
+            uint32 getHeight() const { return m_height; }
+
+            /*!
+            \brief Returns the depth buffer data, row by row from the bottom of the screen
+            */
+            const std::vector<float>& getDepthData() const { return m_depth; }
+
+        private:
+            uint32 m_width;
+            uint32 m_height;
+            std::vector<float> m_depth;
+            glm::mat4 m_viewProjection;
+            bool m_empty;
+
+            std::vector<glm::vec4> m_transformedVertices;
+
+            void rasteriseTriangle(glm::vec3, glm::vec3, glm::vec3);
+        };
+    }
+}
+
+#endif //CRO_OCCLUSION_BUFFER_HPP_
@@ -0,0 +1,81 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine test application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#ifndef CRO_SORT_HPP_
+#define CRO_SORT_HPP_
+
+#include <algorithm>
+#include <iterator>
+
+namespace cro
+{
+    namespace Detail
+    {
+        /*!
+        \brief Stable sorts a range which is expected to be nearly sorted already.
+        An insertion sort is used, which is linear on nearly sorted data, such as
+        a draw list which only changes a little from frame to frame. It is quadratic
+        when the order has changed a lot, so once it has moved more than maxMoves
+        elements the remainder of the work is passed to std::stable_sort().
+        The result is always the same as calling std::stable_sort() on the range.
+        \param maxMoves Number of moves per element before falling back to std::stable_sort()
+        \returns true if the order of the range was changed, else false
+        */
+        template <typename Iterator, typename Compare>
+        bool insertionSort(Iterator first, Iterator last, Compare isLess, std::size_t maxMoves = 8)
+        {
+            if (std::is_sorted(first, last, isLess))
+            {
+                return false;
+            }
+
+            const std::size_t limit = static_cast<std::size_t>(std::distance(first, last)) * maxMoves;
+            std::size_t moves = 0;
+            for (auto i = std::next(first); i != last && moves < limit; ++i)
+            {
+                auto item = std::move(*i);
+                auto j = i;
+                for (; j != first && isLess(item, *std::prev(j)); --j)
+                {
+                    *j = std::move(*std::prev(j));
+                    moves++;
+                }
+                *j = std::move(item);
+            }
+
+            if (moves >= limit)
+            {
+                std::stable_sort(first, last, isLess);
+            }
+            return true;
+        }
+    }
+}
+
+#endif //CRO_SORT_HPP_
\ No newline at end of file
@@ -36,6 +36,8 @@ source distribution.
 #include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
 
+#include <array>
+
 namespace cro
 {
     /*!
@@ -58,6 +60,8 @@ namespace cro
     class CRO_EXPORT_API Sunlight final
     {
     public:
+        static const std::size_t MaxCascades = 4;
+
         Sunlight();
         
         /*!
@@ -122,6 +126,21 @@ namespace cro
         */
         int32 getMapID() const;
 
+        /*!
+        \brief Returns the number of shadow map cascades last rendered
+        by the ShadowMapRenderer. This is 1 unless cascaded shadow maps
+        have been enabled.
+        */
+        std::size_t getCascadeCount() const { return m_cascadeCount; }
+
+        /*!
+        \brief Returns the view / projection matrices for each of the
+        shadow map cascades, nearest first. Only the first getCascadeCount()
+        matrices are valid. The first matrix is the same as that returned
+        by getViewProjectionMatrix()
+        */
+        const std::array<glm::mat4, MaxCascades>& getCascadeMatrices() const { return m_cascadeMatrices; }
+
     private:
         cro::Colour m_colour;
         glm::vec3 m_direction;
@@ -130,6 +149,9 @@ namespace cro
         glm::mat4 m_viewProjection;
 
         cro::int32 m_textureID;
+
+        std::size_t m_cascadeCount;
+        std::array<glm::mat4, MaxCascades> m_cascadeMatrices;
         friend class ShadowMapRenderer;
     };
 }
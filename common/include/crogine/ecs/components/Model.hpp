@@ -37,6 +37,8 @@ source distribution.
 
 #include <glm/mat4x4.hpp>
 
+#include <vector>
+
 namespace cro
 {
     class CRO_EXPORT_API Model final
@@ -64,7 +66,9 @@ namespace cro
         \brief Returns a reference to the mesh data for this model.
         This can be used to update vertex data, but care should be taken to
         not modify the attribute layout as this will already be bound to the
-        model's material.
+        model's material. If the model has multiple levels of detail this
+        returns the mesh data of the level currently being drawn, and any
+        changes are kept for that level when a different level is selected.
         */
         Mesh::Data& getMeshData() { return m_meshData; };
 
@@ -91,6 +95,40 @@ namespace cro
         */
         bool isVisible() const { return m_visible; }
 
+        /*!
+        \brief Adds a lower detail mesh to the model.
+        Levels of detail are selected by the ModelRenderer based on the
+        distance of the model from the active camera, and should be added
+        in order from most to least detailed. The mesh the model was
+        constructed with is always level 0. LOD meshes must have the same
+        vertex attributes and the same number of sub-meshes as the original
+        mesh, as they share its materials.
+        \param mesh Mesh data to use for this level
+        \param distance Distance from the camera beyond which this level is used
+        \param screenSize If this is greater than zero it is used instead of
+        distance, and the level is used once the model's bounding sphere covers
+        less than this proportion of the viewport height.
+        */
+        void addLevelOfDetail(const Mesh::Data& mesh, float distance, float screenSize = 0.f);
+
+        /*!
+        \brief Sets the proportion of a switching distance which the camera
+        has to move past before a level of detail is changed. This prevents
+        models 'popping' back and forth between levels when the camera is
+        near the switching distance. Defaults to 0.1 (10%)
+        */
+        void setLevelOfDetailHysteresis(float amount);
+
+        /*!
+        \brief Returns the number of levels of detail, including the original mesh
+        */
+        std::size_t getLevelOfDetailCount() const { return m_levelsOfDetail.empty() ? 1 : m_levelsOfDetail.size(); }
+
+        /*!
+        \brief Returns the index of the level of detail currently being drawn
+        */
+        std::size_t getCurrentLevelOfDetail() const { return m_currentLevelOfDetail; }
+
     private:
         bool m_visible;
 
@@ -103,6 +141,18 @@ namespace cro
         glm::mat4* m_skeleton;
         std::size_t m_jointCount;
 
+        struct LevelOfDetail final
+        {
+            Mesh::Data meshData;
+            float distance = 0.f;
+            float screenSize = 0.f;
+        };
+        std::vector<LevelOfDetail> m_levelsOfDetail; //< empty unless LODs have been added, else index 0 is the original mesh
+        std::size_t m_currentLevelOfDetail = 0;
+        float m_lodHysteresis = 0.1f;
+
+        void updateLevelOfDetail(float distance, float radiusScale);
+
         friend class ModelRenderer;
         friend class ShadowMapRenderer;
     };
@@ -0,0 +1,86 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#ifndef CRO_OCCLUDER_HPP_
+#define CRO_OCCLUDER_HPP_
+
+#include <crogine/Config.hpp>
+#include <crogine/detail/Types.hpp>
+#include <crogine/graphics/Spatial.hpp>
+
+#include <glm/vec3.hpp>
+
+#include <vector>
+
+namespace cro
+{
+    /*!
+    \brief Occluder component.
+    Entities which have an Occluder component as well as a Model
+    are rasterised into a small depth buffer on the CPU when
+    the ModelRenderer has occlusion culling enabled. Any models
+    whose bounding boxes are completely hidden behind occluders
+    are then skipped when drawing. Occluder geometry should be
+    a low polygon, model space triangle list which fits *inside*
+    the visible mesh - usually large, solid objects such as
+    walls or buildings make the best occluders.
+    */
+    struct CRO_EXPORT_API Occluder final
+    {
+        std::vector<glm::vec3> vertices;
+        std::vector<uint16> indices;
+
+        Occluder() = default;
+
+        /*!
+        \brief Constructs an occluder from the given model space box
+        */
+        explicit Occluder(const Box& box)
+        {
+            for (auto i = 0; i < 8; ++i)
+            {
+                vertices.emplace_back((i & 1) ? box[1].x : box[0].x,
+                                      (i & 2) ? box[1].y : box[0].y,
+                                      (i & 4) ? box[1].z : box[0].z);
+            }
+
+            indices =
+            {
+                0, 2, 1,  1, 2, 3, //back
+                4, 5, 6,  5, 7, 6, //front
+                0, 1, 4,  1, 5, 4, //bottom
+                2, 6, 3,  3, 6, 7, //top
+                0, 4, 2,  2, 4, 6, //left
+                1, 3, 5,  3, 7, 5  //right
+            };
+        }
+    };
+}
+
+#endif //CRO_OCCLUDER_HPP_
\ No newline at end of file
@@ -40,26 +40,12 @@ source distribution.
 #include <glm/vec3.hpp>
 
 #include <array>
+#include <random>
 
 namespace cro
 {
     class TextureResource;
 
-    /*!
-    \brief Data struct for a single particle
-    */
-    struct CRO_EXPORT_API Particle final
-    {
-        glm::vec3 position;
-        glm::vec3 velocity;
-        glm::vec3 gravity;
-        float lifetime = 0.f;
-        float maxLifeTime = 1.f;
-        Colour colour;
-        float rotation = 0.f;
-        float scale = 1.f;
-    };
-
     /*!
     \brief Encapsulates settings used by an emitter to
     initialise particles it creates
@@ -83,6 +69,7 @@ namespace cro
         float size = 1.f; //diameter of particle
         float emitRate = 1.f; //< particles per second
         float spawnRadius = 0.f;
+        uint32 maxParticles = 1000; //< maximum number of particles alive at once
         uint32 textureID = 0;
         bool loadFromFile(const std::string&, TextureResource&);
     };
@@ -101,19 +88,83 @@ namespace cro
         void start();
         void stop();
 
-        static const uint32 MaxParticles = 1000u;
+        /*!
+        \brief Spawns the given number of particles at the emitter's
+        current position the next time the emitter is updated.
+        Bursts are emitted whether or not the emitter is running.
+        */
+        void burst(uint32 count);
+
+        /*!
+        \brief Seeds the random number generator used when spawning particles.
+        Each emitter has its own generator so that emitters can be simulated
+        on different threads, and a given seed will always produce the same
+        particles regardless of how many threads are used. By default the
+        generator is seeded from cro::Util::Random when the emitter is created.
+        */
+        void setRandomSeed(uint32 seed);
+
+        /*!
+        \brief Returns the number of particles currently alive
+        */
+        std::size_t getParticleCount() const { return m_nextFreeParticle; }
+
+        /*!
+        \brief Returns the number of particles for which memory is
+        currently allocated. This is updated to match emitterSettings.maxParticles
+        when the emitter is next updated.
+        */
+        std::size_t getCapacity() const { return m_particles.capacity; }
+
         EmitterSettings emitterSettings;
 
     private:
-        uint32 m_vbo;
-        
-        std::array<Particle, MaxParticles> m_particles;
+        //each particle property is stored in its own array so
+        //that several particles can be updated at once with SIMD.
+        //The arrays are allocated as a single block from a pool
+        //shared by all emitters, sized by EmitterSettings::maxParticles
+        struct Particles final
+        {
+            float* positionX = nullptr; float* positionY = nullptr; float* positionZ = nullptr;
+            float* velocityX = nullptr; float* velocityY = nullptr; float* velocityZ = nullptr;
+            float* lifetime = nullptr;
+            float* inverseMaxLifetime = nullptr; //used to fade alpha
+            float* red = nullptr; float* green = nullptr; float* blue = nullptr; float* alpha = nullptr;
+            float* rotation = nullptr;
+            float* scale = nullptr;
+            std::size_t capacity = 0;
+
+            Particles() = default;
+            ~Particles();
+            Particles(const Particles&);
+            Particles(Particles&&) noexcept;
+            Particles& operator = (const Particles&);
+            Particles& operator = (Particles&&) noexcept;
+
+            //keeps the first count particles
+            void resize(std::size_t capacity, std::size_t count);
+            void copy(std::size_t src, std::size_t dst);
+
+        private:
+            float* m_data = nullptr;
+            std::size_t m_stride = 0;
+
+            void assign(float*, std::size_t);
+        }m_particles;
         std::size_t m_nextFreeParticle;
 
         bool m_running;
-        Clock m_emissionClock;
+        float m_emissionTime; //time accumulated towards the next particle
+        uint32 m_pendingBurst;
+
+        //particles spawned during a frame are placed along the path
+        //the emitter moved from its position in the previous frame
+        glm::vec3 m_previousPosition;
+        bool m_hasPreviousPosition;
         Sphere m_bounds;
 
+        std::mt19937 m_randomEngine;
+
         friend class ParticleSystem;
     };
 }
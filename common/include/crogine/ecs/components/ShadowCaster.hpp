@@ -37,6 +37,12 @@ namespace cro
     struct ShadowCaster final
     {
         bool skinned = false;
+
+        //static casters are drawn once into a cached layer of the depth
+        //map which is only redrawn when the light or a static caster
+        //changes. Moving a static caster redraws the entire layer, so
+        //only set this on casters which rarely, if ever, move.
+        bool isStatic = false;
     };
 }
 
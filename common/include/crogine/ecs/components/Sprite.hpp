@@ -38,6 +38,7 @@ source distribution.
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
 
 #include <array>
 
@@ -154,10 +155,13 @@ namespace cro
         };
         std::array<Vertex, 4u> m_quad;
         bool m_dirty;
+        uint32 m_vbo; //the VBO containing this sprite's vertices
         int32 m_vboOffset; //where this sprite starts in its VBO - used when updating sub buffer data
+        uint32 m_batchTextureIndex; //index of this sprite's texture in its batch
 
         FloatRect m_localBounds;
         FloatRect m_globalBounds;
+        glm::mat4 m_lastWorldTransform; //global bounds are only updated when this changes
 
         bool m_visible; //used in culling
         Material::BlendMode m_blendMode;
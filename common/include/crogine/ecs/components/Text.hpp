@@ -153,7 +153,11 @@ namespace cro
             glm::vec2 UV;
         };
         std::vector<Vertex> m_vertices;
-        int32 m_vboOffset; //starting index in parent VBO
+        uint32 m_vbo; //the VBO containing this text's vertices
+        int32 m_vboOffset; //starting byte offset in parent VBO
+        uint32 m_vertexCapacity; //number of vertices reserved in the VBO
+        uint32 m_transformIndex; //index of the world transform used by this text's batch
+        uint32 m_atlasGeneration; //the vertices are rebuilt if the font atlas evicts glyphs
         std::array<std::size_t, 2u> m_batchIndex;
 
         mutable FloatRect m_localBounds;
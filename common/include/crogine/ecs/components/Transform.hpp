@@ -131,6 +131,14 @@ namespace cro
         */
         glm::mat4 getWorldTransform() const;
 
+        /*!
+        \brief Returns a value which changes whenever the world transform
+        changes, either directly or because a parent moved. Systems can
+        compare this with a previously stored value to cheaply find out
+        if the transform needs to be read again.
+        */
+        uint32 getRevision() const { return m_revision; }
+
 
         /*!
         \brief Sets the parent entity if this node in the scene graph.
@@ -168,6 +176,7 @@ namespace cro
         int32 m_id;
         std::array<int32, MaxChildren> m_children;
         std::vector<int32> m_removedChildren;
+        uint32 m_revision;
 
         enum Flags
         {
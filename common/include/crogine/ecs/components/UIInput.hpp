@@ -51,6 +51,9 @@ namespace cro
             MouseDown,
             MouseUp,
             MouseMotion,
+            Drag, //movement of a single finger after it was pressed on this control
+            Pinch, //x is the change in scale and y the change in rotation of two fingers
+            Swipe, //a quick stroke started on this control. The direction and length is passed
             Count
         };
 
@@ -58,6 +61,17 @@ namespace cro
         bool active;
         std::array<uint32, CallbackID::Count> callbacks{};
         int32 ID = -1;
+
+    private:
+        //the UISystem caches the world area and only
+        //updates its hit test grid when the control moves
+        FloatRect m_worldArea;
+        FloatRect m_previousArea;
+        uint32 m_transformRevision = 0;
+        float m_depth = 0.f;
+        bool m_inGrid = false;
+
+        friend class UISystem;
     };
 }
 
@@ -36,6 +36,8 @@ source distribution.
 #include <crogine/ecs/Renderable.hpp>
 #include <crogine/graphics/MaterialData.hpp>
 #include <crogine/detail/SDLResource.hpp>
+#include <crogine/detail/Culling.hpp>
+#include <crogine/detail/OcclusionBuffer.hpp>
 
 #include <vector>
 
@@ -43,6 +45,7 @@ namespace cro
 {
     class MessageBus;
     class Model;
+    class WorkerPool;
 
     //don't export this, used internally.
     struct SortData final
@@ -71,7 +74,8 @@ namespace cro
         explicit ModelRenderer(MessageBus& mb);
 
         /*!
-        \brief Performs frustum culling and Material sorting by depth and blend mode
+        \brief Performs frustum culling, level of detail selection
+        and Material sorting by depth and blend mode
         */
         void process(Time) override;
 
@@ -80,11 +84,78 @@ namespace cro
         */
         void render(Entity) override;
 
+        /*!
+        \brief Sets the type of bounding volume used when frustum culling.
+        Spheres are the default and are the cheapest to test, but boxes
+        usually fit meshes more tightly so that fewer models outside of
+        the view are drawn.
+        */
+        void setCullingVolume(BoundingVolume volume) { m_cullingVolume = volume; }
+
+        /*!
+        \brief Returns the type of bounding volume currently used when culling
+        */
+        BoundingVolume getCullingVolume() const { return m_cullingVolume; }
+
+        /*!
+        \brief Enables or disables occlusion culling.
+        When enabled any entities with an Occluder component are rendered
+        into a low resolution depth buffer on the CPU each frame, and models
+        whose bounding boxes are completely hidden behind them are not drawn.
+        This is disabled by default, and has no effect if there are no
+        Occluders in the scene.
+        */
+        void setOcclusionCulling(bool enabled) { m_occlusionCulling = enabled; }
+
+        /*!
+        \brief Returns true if occlusion culling is enabled
+        */
+        bool getOcclusionCulling() const { return m_occlusionCulling; }
+
+        /*!
+        \brief Sets the WorkerPool used to cull models.
+        By default this is the pool owned by the App, if there is one.
+        Passing nullptr culls all models on the thread calling process().
+        */
+        void setWorkerPool(WorkerPool* pool) { m_workerPool = pool; }
+
+        /*!
+        \brief Returns the number of draw calls made during the last render.
+        Each visible submesh requires its own draw call, so this can be used
+        to measure the effect of frustum and occlusion culling.
+        */
+        std::size_t getDrawCount() const { return m_drawCount; }
+
     private:
         MaterialList m_visibleEntities;
         //TODO list of lighting
 
+        BoundingVolume m_cullingVolume;
+
+        //culling is split into chunks which are processed
+        //in parallel, then merged in order before sorting
+        struct CullChunk final
+        {
+            Detail::SphereArray spheres;
+            Detail::BoxArray boxes;
+            std::vector<uint8> results;
+            MaterialList drawList;
+        };
+        std::vector<CullChunk> m_cullChunks;
+        WorkerPool* m_workerPool;
+        void cullRange(const Frustum&, std::size_t, std::size_t, CullChunk&);
+        void buildDrawList(std::size_t, std::size_t, CullChunk&, glm::vec3, float);
+
+        bool m_occlusionCulling;
+        Detail::OcclusionBuffer m_occlusionBuffer;
+        std::vector<Entity> m_occluders;
+        bool updateOcclusionBuffer(Entity);
+
+        void onEntityAdded(Entity) override;
+        void onEntityRemoved(Entity) override;
+
         uint32 m_currentTextureUnit;
+        std::size_t m_drawCount;
         void applyProperties(const Material::Data&, const Model&);
 
         void applyBlendMode(Material::BlendMode);
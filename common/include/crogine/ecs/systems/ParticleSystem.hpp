@@ -34,20 +34,35 @@ source distribution.
 #include <crogine/ecs/Renderable.hpp>
 
 #include <crogine/graphics/Shader.hpp>
+#include <crogine/graphics/StreamBuffer.hpp>
 
+#include <glm/vec3.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <memory>
 #include <vector>
 
 namespace cro
 {
+    class ParticleEmitter;
+    class Transform;
+    class WorkerPool;
+
     /*!
     \brief Particle system.
-    Updates and renders all particle emitters in the scene
+    Updates and renders all particle emitters in the scene.
+    The vertex data of all visible emitters is written to a single
+    stream buffer allocation each frame, and emitters which share
+    a texture and blend mode are drawn together with a single call.
+    Emitters are simulated in parallel across the App's WorkerPool,
+    after which their vertex data is built on the calling thread. The
+    vertex data is uploaded when the particles are first rendered, so
+    particles can be updated without a GL context.
     */
     class CRO_EXPORT_API ParticleSystem final : public Renderable, public System
     {
     public:
         explicit ParticleSystem(MessageBus&);
-        ~ParticleSystem();
 
         ParticleSystem(const ParticleSystem&) = delete;
         ParticleSystem(ParticleSystem&&) = delete;
@@ -58,26 +73,88 @@ namespace cro
 
         void render(Entity) override;
 
+        /*!
+        \brief Enables or disables depth sorting of particles.
+        When enabled particles drawn with the Alpha blend mode are sorted
+        back to front from the active camera, so that overlapping emitters
+        blend correctly. This has a CPU cost proportional to the number of
+        visible particles so is disabled by default. Additive and multiplied
+        particles are order independent and are never sorted.
+        */
+        void setDepthSorting(bool enabled) { m_depthSorting = enabled; }
+
+        /*!
+        \brief Returns true if depth sorting is enabled
+        */
+        bool getDepthSorting() const { return m_depthSorting; }
+
+        /*!
+        \brief Returns the number of draw calls made to render
+        the particles in the previous frame
+        */
+        std::size_t getDrawCount() const { return m_batches.size(); }
+
+        /*!
+        \brief Sets the WorkerPool used to simulate emitters.
+        By default this is the pool owned by the App, if there is one. Passing nullptr
+        simulates all emitters on the thread calling process(). The
+        results are the same regardless of the number of threads used.
+        */
+        void setWorkerPool(WorkerPool* pool) { m_workerPool = pool; }
+
+        /*!
+        \brief Sets the StreamBuffer used to upload vertex data.
+        The owner of the buffer is responsible for calling beginFrame()
+        on it once per frame. By default, or if nullptr is passed, the
+        App's buffer is used. If there is no App buffer the system
+        creates and manages its own when it is first rendered.
+        */
+        void setStreamBuffer(StreamBuffer* buffer) { m_streamBuffer = buffer; }
+
     private:
-        
-        void onEntityAdded(Entity) override;
-        void onEntityRemoved(Entity) override;
 
         std::vector<float> m_dataBuffer;
-        std::vector<uint32> m_vboIDs;
-        std::size_t m_nextBuffer;
-        std::size_t m_bufferCount;
 
         std::size_t m_visibleCount;
         std::vector<Entity> m_visibleSystems;
-        void allocateBuffer();
+        std::vector<uint8> m_visibleFlags; //< written by each thread per entity
+
+        WorkerPool* m_workerPool;
+
+        //visible emitters which share a texture and blend mode
+        struct Batch final
+        {
+            uint32 textureID = 0;
+            int32 blendMode = 0;
+            std::size_t firstEmitter = 0; //< index in to m_visibleSystems
+            std::size_t emitterCount = 0;
+            std::size_t firstVertex = 0;
+            std::size_t vertexCount = 0;
+            float depth = 0.f;
+        };
+        std::vector<Batch> m_batches;
+
+        struct SortItem final
+        {
+            float depth = 0.f;
+            uint32 emitter = 0;
+            uint32 particle = 0;
+        };
+        std::vector<SortItem> m_sortBuffer;
+        bool m_depthSorting;
+
+        StreamBuffer* m_streamBuffer;
+        std::unique_ptr<StreamBuffer> m_ownStreamBuffer;
+        std::size_t m_vertexCount; //< waiting to be uploaded, or 0 once uploaded
+        uint32 m_vbo;
+        std::size_t m_vboOffset;
+        StreamBuffer& getStreamBuffer();
 
         Shader m_shader;
         int32 m_projectionUniform;
         int32 m_textureUniform;
         int32 m_viewProjUniform;
         int32 m_viewportUniform;
-        int32 m_sizeUniform;
 
         struct AttribData final
         {
@@ -86,6 +163,13 @@ namespace cro
             int32 offset = 0;
         };
         std::array<AttribData, 3u> m_attribData;
+
+        static void spawnParticles(ParticleEmitter&, const Transform&, float);
+        static void spawnParticle(ParticleEmitter&, glm::vec3, const glm::quat&, float);
+        static void updateParticles(ParticleEmitter&, float);
+
+        std::size_t buildBatches(glm::vec3, glm::vec3);
+        std::size_t writeVertex(std::size_t, const ParticleEmitter&, std::size_t);
     };
 }
 
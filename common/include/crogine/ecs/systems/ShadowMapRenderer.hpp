@@ -32,7 +32,10 @@ source distribution.
 
 #include <crogine/ecs/System.hpp>
 #include <crogine/ecs/Renderable.hpp>
+#include <crogine/ecs/Sunlight.hpp>
 #include <crogine/graphics/RenderTexture.hpp>
+#include <crogine/graphics/Shader.hpp>
+#include <crogine/detail/Culling.hpp>
 
 namespace cro
 {
@@ -46,7 +49,24 @@ namespace cro
     render target. This system should be added to the scene
     before the ModelRenderer system (or any system which
     employs the depth map rendered by this system) in order
-    that the depth map data be up to date.
+    that the depth map data be up to date. Shadow casters are
+    culled against the Sunlight's frustum rather than the
+    camera's, so that casters outside of the view may still
+    cast shadows into it.
+
+    On desktop platforms the shadow map can be split into
+    2 - 4 cascades, each covering a successively larger part
+    of the camera's view and packed into a single texture atlas.
+    This allows shadows to cover much greater view distances
+    for the same number of texels.
+
+    Casters whose ShadowCaster component is marked as static are
+    drawn into a separate cached layer, which is only redrawn when
+    the light's projection changes or a static caster moves. Each
+    frame the cached layer is copied into the depth map and only
+    dynamic casters are drawn on top. Static caching is only available
+    on desktop platforms, elsewhere static casters are drawn every
+    frame like any other caster.
     */
     class CRO_EXPORT_API ShadowMapRenderer final : public cro::System, public cro::Renderable
     {
@@ -56,7 +76,12 @@ namespace cro
         \param mb Message bus instance
         */
         explicit ShadowMapRenderer(MessageBus& mb);
+        ~ShadowMapRenderer();
 
+        /*!
+        \brief Updates the Sunlight view-projection matrix, culls shadow
+        casters against it and sorts the visible casters by shader
+        */
         void process(cro::Time) override;
 
         void render(Entity) override;
@@ -64,7 +89,8 @@ namespace cro
         /*!
         \brief Sets the offset of the Scene's sunlight object relative to the camera.
         Use this to best align the shadow map with the visible scene. This value is added
-        to the camera's current position.
+        to the camera's current position. This only applies when using a single cascade,
+        as cascades are automatically fitted to the camera's view.
         */
         void setProjectionOffset(glm::vec3);
 
@@ -73,10 +99,92 @@ namespace cro
         */
         const Texture& getDepthMapTexture() const;
 
+        /*!
+        \brief Sets the number of shadow map cascades.
+        By default this is 1, which uses a single shadow map positioned with
+        the Sunlight's projection matrix and the projection offset. Setting
+        this to 2 - 4 splits the active camera's view along its depth, and
+        fits an orthographic projection to each split, snapped to whole
+        texels to prevent shimmering as the camera moves. Cascades are
+        packed into a 2x2 atlas, each with the same resolution as the
+        default shadow map. Cascades are only available on desktop
+        platforms, elsewhere this is always 1.
+        */
+        void setCascadeCount(std::size_t count);
+
+        /*!
+        \brief Returns the current number of shadow map cascades
+        */
+        std::size_t getCascadeCount() const { return m_cascadeCount; }
+
+        /*!
+        \brief Sets the distance from the camera to which shadow cascades are
+        drawn. This is clamped to the far plane of the camera's projection.
+        Defaults to 50 units.
+        */
+        void setMaxDistance(float distance);
+
+        /*!
+        \brief Returns the distance from the camera to which shadow cascades are drawn
+        */
+        float getMaxDistance() const { return m_maxDistance; }
+
+        /*!
+        \brief Forces the cached layer of static casters to be redrawn
+        on the next frame. Changes to the light, or to the transform or
+        mesh of static casters are detected automatically, but this can
+        be used if, for example, the material of a static caster is changed.
+        */
+        void invalidateStaticCache() { m_staticCacheDirty = true; }
+
     private:
         RenderTexture m_target;
-        std::vector<Entity> m_visibleEntities;
         glm::vec3 m_projectionOffset;
+
+        std::size_t m_cascadeCount;
+        float m_maxDistance;
+        std::array<glm::mat4, Sunlight::MaxCascades> m_viewMatrices;
+        std::array<glm::mat4, Sunlight::MaxCascades> m_projectionMatrices;
+        void updateCascades(Entity);
+
+        Detail::SphereArray m_bounds;
+        std::vector<uint8> m_cullResults;
+
+        struct Drawable final
+        {
+            Entity entity;
+            uint32 shader = 0;
+            uint32 vbo = 0;
+            std::size_t submesh = 0;
+        };
+        std::array<std::vector<Drawable>, Sunlight::MaxCascades> m_drawLists;
+        void drawCascades(const std::array<std::vector<Drawable>, Sunlight::MaxCascades>&);
+
+        //static casters are drawn in a separate layer which is only updated when
+        //the light or a static caster changes. Comparing the state of the static
+        //casters with the previous frame is what detects changes.
+        struct StaticState final
+        {
+            Entity::ID entity = 0;
+            uint32 vbo = 0;
+            glm::mat4 worldTransform;
+
+            bool operator != (const StaticState& other) const
+            {
+                return entity != other.entity || vbo != other.vbo || worldTransform != other.worldTransform;
+            }
+        };
+        std::vector<StaticState> m_staticState;
+        std::vector<StaticState> m_previousStaticState;
+        std::vector<uint8> m_staticFlags;
+        std::array<glm::mat4, Sunlight::MaxCascades> m_cachedMatrices;
+
+        bool m_staticCacheDirty;
+        RenderTexture m_staticTarget;
+        std::array<std::vector<Drawable>, Sunlight::MaxCascades> m_staticDrawLists;
+        Shader m_cacheShader;
+        uint32 m_cacheVbo;
+        void drawStaticCache();
     };
 }
 
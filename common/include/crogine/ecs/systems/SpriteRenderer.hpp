@@ -40,8 +40,10 @@ source distribution.
 
 #include <glm/mat4x4.hpp>
 
+#include <array>
 #include <map>
 #include <set>
+#include <vector>
 
 namespace cro
 {
@@ -98,14 +100,62 @@ namespace cro
         */
         void render(Entity) override;
 
+        /*!
+        \brief Returns the number of draw calls made during the last render.
+        Sprites sharing a texture, such as those loaded in to a TextureAtlas,
+        are batched in to fewer draw calls.
+        */
+        std::size_t getDrawCount() const { return m_drawCount; }
+
+        /*!
+        \brief Returns the number of sprites which were inside the active
+        camera's view during the last update. Sprites outside the view are
+        culled and not added to any batch.
+        */
+        std::size_t getVisibleCount() const { return m_visibleEntities.size(); }
+
+        /*!
+        \brief Returns the sprites which were inside the active camera's
+        view during the last update, in the order in which they are drawn.
+        */
+        const std::vector<Entity>& getVisibleEntities() const { return m_visibleEntities; }
+
+        /*!
+        \brief Returns the maximum number of sprites stored in a single VBO.
+        This depends on the number of uniform vectors available on the
+        current platform.
+        */
+        std::size_t getSpritesPerBuffer() const;
+
+        /*!
+        \brief Describes the sprites drawn by a single draw call.
+        \see getBatches()
+        */
+        struct BatchInfo final
+        {
+            uint32 vbo = 0; //!< the VBO the sprites are drawn from
+            std::size_t firstSprite = 0; //!< index of the first sprite in getVisibleEntities()
+            std::size_t spriteCount = 0;
+            std::vector<int32> textures; //!< texture handles bound to consecutive units
+            Material::BlendMode blendMode = Material::BlendMode::Alpha;
+        };
+
+        /*!
+        \brief Returns the batches created by the last rebuild in draw order.
+        Useful for checking how the visible sprites have been partitioned
+        between VBOs and draw calls.
+        */
+        std::vector<BatchInfo> getBatches() const;
+
     private:
         
         //maps VBO to textures
         struct Batch final
         {
-            int32 texture = 0;
-            uint32 start = 0;
-            uint32 count = 0; //this is the COUNT not the final index
+            std::array<int32, 8u> textures = {}; //bound to consecutive texture units
+            uint32 textureCount = 0;
+            uint32 start = 0; //first index in the index buffer
+            uint32 count = 0; //this is the COUNT of indices not the final index
             Material::BlendMode blendMode = Material::BlendMode::Alpha;
         };
         std::vector<std::pair<uint32, std::vector<Batch>>> m_buffers;
@@ -127,13 +177,29 @@ namespace cro
         int32 m_matrixIndex;
         int32 m_textureIndex;
         int32 m_projectionIndex;
+        uint32 m_indexBuffer;
+        std::size_t m_drawCount;
 
         DepthAxis m_depthAxis;
 
         bool m_pendingRebuild;
-        bool m_pendingSorting;
         void rebuildBatch();
 
+        //sprites inside the camera view, in draw order. Only these are batched
+        std::vector<Entity> m_visibleEntities;
+        FloatRect getViewRect();
+
+        //sort keys are calculated once per sprite rather than per comparison
+        struct SortItem final
+        {
+            uint64 key = 0;
+            Entity entity;
+        };
+        std::vector<SortItem> m_sortItems;
+        static uint64 sortKey(float, const Sprite&);
+        bool sortEntities(); //returns true if the order changed
+
+        static void copyVertices(const Sprite&, uint32, float*);
         void updateGlobalBounds(Sprite&, const glm::mat4&);
         void applyBlendMode(Material::BlendMode);
 
@@ -39,10 +39,13 @@ source distribution.
 
 #include <glm/mat4x4.hpp>
 
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace cro
 {
+    class Font;
     class Text;
 
     /*!
@@ -75,11 +78,20 @@ namespace cro
         */
         void render(Entity) override;
 
+        /*!
+        \brief Returns the number of Text components whose vertex data
+        was uploaded during the last call to process().
+        Texts which have not changed are not updated, and texts which
+        change within their reserved space are updated individually.
+        */
+        std::size_t getUpdateCount() const { return m_updateCount; }
+
     private:
 
         struct Batch final
         {
             int32 texture = 0; //font texture atlas
+            uint32 shader = 0; //index of the shader for the font type
             uint32 start = 0; //first vert of this batch in the VBO
             uint32 count = 0; //number of verts in the batch
             Material::BlendMode blendMode = Material::BlendMode::Alpha;
@@ -116,8 +128,36 @@ namespace cro
         
         bool m_pendingRebuild;
         bool m_pendingSorting;
+        std::size_t m_updateCount;
         void rebuildBatch();
         void updateVerts(Text&);
+        void uploadVerts(const Text&);
+        static void copyVertices(const Text&, float*);
+
+        //glyph layouts are cached so that texts which repeatedly
+        //show the same strings, such as counters, skip regenerating them
+        struct LayoutKey final
+        {
+            std::string string;
+            const Font* font = nullptr;
+            uint32 charSize = 0;
+            int32 alignment = 0;
+            bool operator == (const LayoutKey&) const;
+        };
+        struct LayoutKeyHash final
+        {
+            std::size_t operator()(const LayoutKey&) const;
+        };
+        struct Layout final
+        {
+            std::vector<float> vertices; //position and UV pairs
+            FloatRect bounds;
+            uint32 atlasGeneration = 0; //layouts are invalid if the font evicts glyphs
+            uint64 lastUsed = 0;
+        };
+        std::unordered_map<LayoutKey, Layout, LayoutKeyHash> m_layoutCache;
+        uint64 m_frameCount;
+        void createLayout(const Text&, Layout&);
 
         void applyBlendMode(Material::BlendMode);
         void applyScissor(const FloatRect&, const glm::mat4&);
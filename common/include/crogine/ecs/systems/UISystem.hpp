@@ -36,6 +36,8 @@ source distribution.
 #include <glm/mat4x4.hpp>
 
 #include <functional>
+#include <unordered_map>
+#include <vector>
 
 namespace cro
 {
@@ -77,7 +79,7 @@ namespace cro
         \brief Adds a mouse or touch input movement callback.
         This is similar to button even callbacks, only the movement delta is
         passed in as a parameter instead of a button ID. These are also used for
-        mouse enter/exit events
+        mouse enter/exit events, and the drag, pinch and swipe touch gestures
         */
         uint32 addCallback(const MovementCallback&);
 
@@ -103,11 +105,54 @@ namespace cro
         glm::vec2 m_eventPosition;
         glm::vec2 m_movementDelta; //in world coords
 
-        std::vector<Flags> m_downEvents;
-        std::vector<Flags> m_upEvents;
+        //button events are tested against the
+        //controls at the position they occurred
+        struct ButtonEvent final
+        {
+            Flags flag;
+            glm::vec2 position;
+        };
+        std::vector<ButtonEvent> m_downEvents;
+        std::vector<ButtonEvent> m_upEvents;
+
+        //each finger is tracked individually. Motion events only update the
+        //finger's position, and gestures are recognised once per frame
+        struct Touch final
+        {
+            int64 id = 0;
+            glm::vec2 start; //normalised screen coords
+            glm::vec2 position;
+            glm::vec2 previousPosition;
+            float duration = 0.f;
+            bool dragging = false;
+            bool released = false;
+            std::vector<Entity> targets; //controls under the finger when pressed
+        };
+        std::vector<Touch> m_touches;
+        std::vector<Entity> m_pinchTargets; //controls under the fingers when the pinch started
+        float m_pinchDistance;
+        float m_pinchAngle;
+        bool m_pinching;
+
+        void processTouches(float);
 
         glm::uvec2 m_windowSize;
 
+        //hit areas are stored in a uniform grid in world space so that
+        //only the controls in the cell under the pointer need testing
+        std::unordered_map<uint64, std::vector<Entity>> m_grid;
+        std::vector<Entity> m_hitEntities; //controls currently under the pointer, in z-order
+        std::vector<Entity> m_candidates; //scratch space for grid queries
+        bool m_queryPending; //the pointer or a control moved since the last query
+
+        void updateGrid();
+        void addToGrid(Entity);
+        void removeFromGrid(Entity);
+        void queryGrid(glm::vec2, std::vector<Entity>&);
+
+        void onEntityAdded(Entity) override;
+        void onEntityRemoved(Entity) override;
+
         //void setViewPort(int32, int32);
         glm::vec2 toWorldCoords(int32 x, int32 y); //converts screen coords
         glm::vec2 toWorldCoords(float, float); //converts normalised coords
@@ -36,6 +36,7 @@ source distribution.
 
 #include <map>
 #include <vector>
+#include <string>
 
 struct _TTF_Font;
 namespace cro
@@ -47,6 +48,9 @@ namespace cro
     Fonts are created from a given texture atlas which may be a standard
     greyscale image or a signed distance field. Atlases use only the first (red)
     colour channel to multiply the colour of the given text instance when drawn.
+    Bitmap fonts rasterise a separate atlas for each character size, whereas
+    signed distance field fonts share a single atlas between all sizes, so that
+    scaling text requires no new glyphs to be created.
     */
     class CRO_EXPORT_API Font final : public Detail::SDLResource
     {
@@ -74,9 +78,11 @@ namespace cro
         /*!
         \brief Attempts to load a font from a ttf file on disk.
         \param path Path to font file
+        \param type Whether glyphs should be rasterised as bitmaps or
+        signed distance fields
         \returns true if successful else false
         */
-        bool loadFromFile(const std::string& path);
+        bool loadFromFile(const std::string& path, Type type = Type::Bitmap);
 
         /*!
         \brief Creates a font from the given Image
@@ -89,9 +95,52 @@ namespace cro
 
         /*!
         \brief Attempts to return a float rect representing the sub rectangle of the atlas
-        for the give character. Currently only ASCII chars are supported.
+        for the given Unicode codepoint. Glyphs are rasterised in to the atlas the first
+        time they are requested, so that only glyphs which are actually displayed are
+        created. Codepoints outside the basic multilingual plane are not supported.
         */
-        FloatRect getGlyph(char c, uint32 charSize) const;
+        FloatRect getGlyph(uint32 codepoint, uint32 charSize) const;
+
+        /*!
+        \brief Returns a value which is incremented each time glyphs are evicted from
+        the atlas for the given character size to make space for new ones.
+        When the atlas is full the least recently used glyphs are replaced, so when
+        this value changes hasEvictedGlyphs() can be used to find out whether any
+        glyph rectangles retrieved beforehand need to be fetched again.
+        */
+        uint32 getAtlasGeneration(uint32 charSize) const;
+
+        /*!
+        \brief Returns true if any of the glyphs for the given codepoints have been
+        evicted from the atlas for the given character size since getAtlasGeneration()
+        returned the given generation. Text which only uses glyphs that are still in
+        the atlas can keep the glyph rectangles it already has.
+        */
+        bool hasEvictedGlyphs(const std::vector<uint32>& codepoints, uint32 charSize, uint32 generation) const;
+
+        /*!
+        \brief Rasterises the given codepoints in to the atlas for the given character
+        size ahead of time, rather than when they are first displayed.
+        When creating signed distance fields the glyphs are processed in parallel,
+        so this is considerably faster than adding large glyph sets on demand.
+        */
+        void preloadGlyphs(const std::vector<uint32>& codepoints, uint32 charSize);
+
+        /*!
+        \brief Writes the current signed distance field atlas and its glyph data
+        to a file, so that it can be loaded with loadCache() instead of generating
+        the glyphs again. Only supported by SDF fonts.
+        \returns true on success, else false
+        */
+        bool saveCache(const std::string& path) const;
+
+        /*!
+        \brief Loads a signed distance field atlas previously written with saveCache().
+        If the font was loaded from a ttf file first then glyphs missing from the cache
+        are still created on demand, else only the cached glyphs are available.
+        \returns true on success, else false
+        */
+        bool loadCache(const std::string& path);
 
         /*!
         \brief Returns a reference to the texture used by the font
@@ -104,37 +153,76 @@ namespace cro
         Type getType() const;
 
         /*!
-        \brief Returns the lineheight of bitmap fonts or the default height
-        of SDF fonts before resizing
+        \brief Returns the line height of the font at the given character size
         */
         float getLineHeight(uint32 charSize) const;
 
+        /*!
+        \brief Returns the amount by which glyph rectangles should be scaled
+        when drawn at the given character size. This is always 1 for bitmap
+        fonts, as their glyphs are rasterised at each size.
+        */
+        float getScale(uint32 charSize) const;
+
+        /*!
+        \brief Returns the width of the anti-aliased edge of SDF glyphs, in
+        distance field units, when drawn at the given character size.
+        This is always 0 for bitmap fonts.
+        */
+        float getSmoothing(uint32 charSize) const;
+
     private:
 
         Type m_type;
         std::string m_path;
 
-        mutable _TTF_Font* m_font;
+        //glyphs are packed in to rows (shelves) of the atlas as they are requested
+        struct Shelf final
+        {
+            uint32 bottom = 0;
+            uint32 height = 0;
+            uint32 width = 0; //amount of the shelf currently used
+        };
 
-        struct GlyphData final
+        struct Slot final
         {
-            uint32 width, height;
-            std::vector<uint8> data;
+            std::size_t shelf = 0;
+            uint32 left = 0;
+            uint32 width = 0;
         };
 
-        struct MetricData final
+        struct AtlasGlyph final
         {
-            int32 minx, maxx, miny, maxy;
+            FloatRect rect;
+            Slot slot;
+            uint64 lastUsed = 0;
         };
 
         struct Page final
         {
             Texture texture;
+            _TTF_Font* font = nullptr;
             float lineHeight = 0.f;
-            std::map<uint8, FloatRect> subrects;
+            std::map<uint32, AtlasGlyph> glyphs;
+            std::vector<Shelf> shelves;
+            std::vector<Slot> freeSlots; //space left by evicted glyphs
+            std::vector<uint8> pixels; //copy of SDF atlases so they can be cached
+            uint64 useCount = 0;
+            uint32 generation = 0;
+            uint32 resetGeneration = 0; //every glyph fetched before this is invalid
+            std::map<uint32, uint32> evictions; //generation at which each codepoint was last evicted
         };
         mutable std::map<uint32, Page> m_pages;
+        uint32 getPageID(uint32 charSize) const;
         bool createPage(uint32 charSize) const;
+        bool insertGlyph(Page&, uint32 codepoint) const;
+
+        struct GlyphData;
+        bool rasteriseGlyph(const Page&, uint32 codepoint, GlyphData&) const;
+        bool addGlyph(Page&, uint32 codepoint, const GlyphData&) const;
+        bool allocateSlot(Page&, uint32 width, uint32 height, Slot&) const;
+        void evict(Page&, std::map<uint32, AtlasGlyph>::iterator) const;
+        void clearPages();
     };
 }
 
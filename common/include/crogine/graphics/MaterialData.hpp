@@ -63,6 +63,8 @@ namespace cro
             ProjectionMapCount,
             ShadowMapProjection,
             ShadowMapSampler,
+            ShadowMapCascades,
+            ShadowMapCascadeCount,
             SunlightDirection,
             SunlightColour,
             Total
@@ -133,7 +135,7 @@ namespace cro
             //for example skinning and projection map data which is
             //used internally, and nor user-definable
             std::size_t optionalUniformCount = 0;
-            std::array<int32, 3> optionalUniforms{};
+            std::array<int32, Uniform::Total> optionalUniforms{};
 
             BlendMode blendMode = BlendMode::None;
 
@@ -42,6 +42,7 @@ source distribution.
 
 #include <array>
 #include <memory>
+#include <vector>
 
 namespace cro
 {
@@ -110,6 +111,24 @@ namespace cro
         */
         bool hasSkeleton() const { return m_skeleton != nullptr; }
 
+        /*!
+        \brief Returns the number of additional levels of detail
+        declared in the loaded definition.
+        LOD meshes are declared with lod objects in the model definition,
+        each of which has a mesh property and either a distance or
+        screen_size property:
+        \code
+        lod
+        {
+            mesh = "assets/models/tree_lod1.cmf"
+            distance = 40
+        }
+        \endcode
+        The model may also have an optional lod_hysteresis property.
+        \see Model::addLevelOfDetail()
+        */
+        std::size_t getLevelOfDetailCount() const { return m_levelsOfDetail.size(); }
+
     private:
         int32 m_meshID = 0; //< ID of the mesh in the mesh resource
         std::array<int32, Mesh::IndexData::MaxBuffers> m_materialIDs{}; //< list of material IDs in the order in which they appear on the model
@@ -117,6 +136,15 @@ namespace cro
         std::size_t m_materialCount = 0; //< number of active materials
         std::unique_ptr<Skeleton> m_skeleton; //< nullptr if no skeleton exists
         bool m_castShadows = false; //< if this is true the model entity also requires a shadow cast component
+
+        struct LevelOfDetail final
+        {
+            int32 meshID = 0;
+            float distance = 0.f;
+            float screenSize = 0.f;
+        };
+        std::vector<LevelOfDetail> m_levelsOfDetail; //< optional lower detail meshes
+        float m_lodHysteresis = 0.1f;
     };
 }
 
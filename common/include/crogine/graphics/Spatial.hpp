@@ -34,6 +34,7 @@ source distribution.
 
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
 
 #include <array>
 
@@ -41,6 +42,7 @@ namespace cro
 {
     using Plane = glm::vec4;
     using Box = std::array<glm::vec3, 2u>;
+    using Frustum = std::array<Plane, 6u>;
     struct CRO_EXPORT_API Sphere final
     {
         float radius = 0.f;
@@ -52,6 +54,15 @@ namespace cro
         Intersection, Front, Back
     };
 
+    /*!
+    \brief Type of bounding volume used by systems which perform
+    spatial tests, such as frustum culling
+    */
+    enum class BoundingVolume
+    {
+        Sphere, Box
+    };
+
     namespace Spatial
     {
         /*!
@@ -71,6 +82,27 @@ namespace cro
         */
         Planar CRO_EXPORT_API intersects(Plane plane, Box box);
 
+        /*!
+        \brief Transforms a bounding sphere by the given matrix.
+        The radius is scaled by the largest axis scale found in the matrix
+        so that the sphere still completely contains its volume when
+        the matrix contains non-uniform scale.
+        */
+        Sphere CRO_EXPORT_API transform(const glm::mat4& matrix, Sphere sphere);
+
+        /*!
+        \brief Transforms an axis aligned bounding box by the given matrix.
+        \returns The axis aligned box which completely contains the
+        transformed box.
+        */
+        Box CRO_EXPORT_API transform(const glm::mat4& matrix, Box box);
+
+        /*!
+        \brief Extracts the normalised frustum planes from a view-projection matrix.
+        Plane normals point towards the inside of the frustum.
+        */
+        Frustum CRO_EXPORT_API getFrustum(const glm::mat4& viewProjection);
+
     }
 }
 
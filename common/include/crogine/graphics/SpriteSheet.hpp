@@ -39,6 +39,8 @@ source distribution.
 namespace cro
 {
     class TextureResource;
+    class TextureAtlas;
+    class ConfigObject;
 
     /*!
     \brief Supports loading multiple sprites from a single
@@ -57,6 +59,16 @@ namespace cro
         */
         bool loadFromFile(const std::string& path, TextureResource& rx);
 
+        /*!
+        \brief Attempts to load a ConfigFile from the given path, packing
+        the sprite sheet image in to the given TextureAtlas.
+        Sprite sheets loaded in to the same atlas share a texture, so their
+        sprites can be batched together by the SpriteRenderer. The atlas
+        must outlive any sprites created from this sheet.
+        \returns true if successful, else false
+        */
+        bool loadFromFile(const std::string& path, TextureAtlas& atlas);
+
         /*!
         \brief Returns a sprite component with the given name as it
         appears in the sprite sheet. If the sprite does not exist an
@@ -67,6 +79,8 @@ namespace cro
     private:
         mutable std::unordered_map<std::string, Sprite> m_sprites;
 
+        bool loadSprites(const ConfigObject&, const Texture&, URect);
+
     };
 }
 
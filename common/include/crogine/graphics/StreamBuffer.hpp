@@ -0,0 +1,149 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#ifndef CRO_STREAM_BUFFER_HPP_
+#define CRO_STREAM_BUFFER_HPP_
+
+#include <crogine/Config.hpp>
+#include <crogine/detail/Types.hpp>
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+namespace cro
+{
+    /*!
+    \brief Ring buffer for streaming transient vertex data to the GPU.
+    Systems which create new vertex data every frame, such as particles,
+    write it to this shared buffer rather than re-specifying their own VBOs,
+    which can cause the driver to stall while waiting for the GPU to finish
+    reading them.
+    When the GL version supports it (desktop GL 3 and GLES 3) data is written
+    with unsynchronised buffer mapping, and each frame's region of the buffer
+    is protected by a fence. On GLES 2 the buffer is orphaned at the start of
+    a frame when there is not enough space left for another frame's data.
+    Data written to the buffer is valid until the end of the frame, after
+    which it may be overwritten. The buffer grows automatically should a
+    single frame require more space than is available.
+    The App owns a single instance which is available via App::getStreamBuffer()
+    */
+    class CRO_EXPORT_API StreamBuffer final
+    {
+    public:
+        /*!
+        \brief Constructor.
+        Requires a valid GL context
+        \param capacity Initial size of the buffer in bytes
+        */
+        explicit StreamBuffer(std::size_t capacity = 4 * 1024 * 1024);
+        ~StreamBuffer();
+
+        StreamBuffer(const StreamBuffer&) = delete;
+        StreamBuffer(StreamBuffer&&) = delete;
+        StreamBuffer& operator = (const StreamBuffer&) = delete;
+        StreamBuffer& operator = (StreamBuffer&&) = delete;
+
+        /*!
+        \brief Location of uploaded data in the buffer
+        */
+        struct Allocation final
+        {
+            uint32 vbo = 0; //< VBO to bind when drawing this data
+            std::size_t offset = 0; //< offset in bytes of the data within the VBO
+            std::size_t size = 0; //< size in bytes of the data
+        };
+
+        /*!
+        \brief Copies the given data to the buffer.
+        The buffer is left bound to GL_ARRAY_BUFFER. The returned
+        allocation is only valid until the end of the current frame.
+        \param data Pointer to the data to upload
+        \param size Size of the data in bytes
+        */
+        Allocation upload(const void* data, std::size_t size);
+
+        /*!
+        \brief Marks the end of the frame for all data uploaded so far.
+        This is called automatically by the App after the window is displayed.
+        */
+        void beginFrame();
+
+        /*!
+        \brief Returns true if the buffer is updated via mapping,
+        or false if it falls back to orphaning.
+        */
+        bool usesMapping() const { return m_useMapping; }
+
+        /*!
+        \brief Buffer statistics for a single frame
+        */
+        struct Stats final
+        {
+            std::size_t bytesUploaded = 0;
+            std::size_t uploads = 0;
+            std::size_t stalls = 0; //< number of times the CPU had to wait for the GPU, or without mapping, wrapped on to data which may still be in use
+            std::size_t orphans = 0;
+            std::size_t resizes = 0;
+            std::size_t capacity = 0;
+        };
+
+        /*!
+        \brief Returns the stats of the last completed frame
+        */
+        const Stats& getStats() const { return m_lastStats; }
+
+    private:
+        uint32 m_vbo;
+        std::size_t m_capacity;
+        std::size_t m_offset;
+        std::size_t m_frameStart;
+        std::size_t m_frameUsed;
+        bool m_useMapping;
+
+        //the region of the buffer in use by a previous frame
+        struct Fence final
+        {
+            void* sync = nullptr;
+            std::size_t start = 0;
+            std::size_t size = 0;
+        };
+        std::deque<Fence> m_fences;
+        std::vector<uint32> m_retiredBuffers;
+
+        Stats m_stats;
+        Stats m_lastStats;
+
+        void createBuffer(std::size_t);
+        void waitForRange(std::size_t, std::size_t);
+        void clearFences();
+    };
+}
+
+#endif //CRO_STREAM_BUFFER_HPP_
\ No newline at end of file
@@ -0,0 +1,148 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#ifndef CRO_TEXTURE_ATLAS_HPP_
+#define CRO_TEXTURE_ATLAS_HPP_
+
+#include <crogine/Config.hpp>
+#include <crogine/detail/Types.hpp>
+#include <crogine/graphics/Rectangle.hpp>
+#include <crogine/graphics/Texture.hpp>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cro
+{
+    class Image;
+
+    /*!
+    \brief Packs multiple images into one or more shared textures at runtime.
+    Sprites are only batched together while they share a texture, so loading
+    several sprite sheets into the same atlas (see SpriteSheet::loadFromFile())
+    allows 2D scenes to be drawn with far fewer draw calls. Images are packed
+    as they are added, using a skyline packer, and a new page (texture) is
+    created when the current pages are full.
+    TextureAtlases are non-copyable, and must outlive any sprites which use them.
+    */
+    class CRO_EXPORT_API TextureAtlas final
+    {
+    public:
+        /*!
+        \brief Constructor.
+        \param pageSize Width and height of each atlas texture. This is clamped
+        to the maximum texture size of the current platform.
+        \param padding Number of pixels to leave between each image to prevent
+        bleeding when textures are filtered.
+        */
+        explicit TextureAtlas(uint32 pageSize = 2048, uint32 padding = 2);
+
+        TextureAtlas(const TextureAtlas&) = delete;
+        TextureAtlas(TextureAtlas&&) = delete;
+        TextureAtlas& operator = (const TextureAtlas&) = delete;
+        TextureAtlas& operator = (TextureAtlas&&) = delete;
+
+        /*!
+        \brief Describes where an image was packed
+        */
+        struct Region final
+        {
+            const Texture* texture = nullptr; //< the atlas page containing the image
+            URect area; //< the area of the page covered by the image
+        };
+
+        /*!
+        \brief Adds the given image to the atlas.
+        If an image has already been added with the same name the existing
+        region is returned instead, so that sheets sharing the same source
+        image only pack it once.
+        \param name Unique name of the image, usually its file path
+        \param image The image to pack. RGB images are converted to RGBA.
+        \returns Pointer to the region containing the image or nullptr if the
+        image is too large to fit on a page.
+        */
+        const Region* add(const std::string& name, const Image& image);
+
+        /*!
+        \brief Returns the region for the image with the given name or nullptr
+        if it has not been added.
+        */
+        const Region* getRegion(const std::string& name) const;
+
+        /*!
+        \brief Returns the number of texture pages in the atlas
+        */
+        std::size_t getPageCount() const { return m_pages.size(); }
+
+        /*!
+        \brief Returns the texture for the given page
+        */
+        const Texture& getTexture(std::size_t page) const;
+
+        /*!
+        \brief Sets the smoothing of all pages in the atlas
+        */
+        void setSmooth(bool);
+
+        /*!
+        \brief Returns the proportion of the atlas pages covered by
+        images, in the range 0 - 1.
+        */
+        float getPackingEfficiency() const;
+
+    private:
+        uint32 m_pageSize;
+        uint32 m_padding;
+
+        struct SkylineNode final
+        {
+            uint32 x = 0;
+            uint32 y = 0;
+            uint32 width = 0;
+        };
+
+        struct Page final
+        {
+            std::unique_ptr<Texture> texture;
+            std::vector<SkylineNode> skyline;
+            uint64 usedArea = 0;
+        };
+        std::vector<Page> m_pages;
+
+        std::unordered_map<std::string, std::unique_ptr<Region>> m_regions;
+
+        Page& createPage();
+        bool insert(Page&, uint32, uint32, glm::uvec2&);
+        bool fit(const Page&, std::size_t, uint32, uint32, uint32&) const;
+    };
+}
+
+#endif //CRO_TEXTURE_ATLAS_HPP_
\ No newline at end of file
@@ -35,6 +35,7 @@ source distribution.
 #include <SDL_rwops.h>
 
 #include <string>
+#include <vector>
 #include <algorithm>
 
 namespace cro
@@ -209,6 +210,60 @@ namespace cro
                 }
                 return currPos;
             }
+
+            /*!
+            \brief Decodes a UTF-8 encoded string in to a vector of Unicode codepoints.
+            Bytes which are not part of a valid UTF-8 sequence are returned as
+            they are, so that strings containing extended ASCII still display.
+            */
+            static inline std::vector<uint32> getCodepoints(const std::string& str)
+            {
+                std::vector<uint32> codepoints;
+                codepoints.reserve(str.size());
+
+                std::size_t i = 0;
+                while (i < str.size())
+                {
+                    auto c = static_cast<uint8>(str[i]);
+                    uint32 codepoint = c;
+                    std::size_t trailCount = 0;
+                    if ((c & 0xE0) == 0xC0)
+                    {
+                        codepoint = c & 0x1F;
+                        trailCount = 1;
+                    }
+                    else if ((c & 0xF0) == 0xE0)
+                    {
+                        codepoint = c & 0x0F;
+                        trailCount = 2;
+                    }
+                    else if ((c & 0xF8) == 0xF0)
+                    {
+                        codepoint = c & 0x07;
+                        trailCount = 3;
+                    }
+
+                    bool valid = (i + trailCount < str.size());
+                    for (auto j = 1u; j <= trailCount && valid; ++j)
+                    {
+                        auto trail = static_cast<uint8>(str[i + j]);
+                        valid = ((trail & 0xC0) == 0x80);
+                        codepoint = (codepoint << 6) | (trail & 0x3F);
+                    }
+
+                    if (valid)
+                    {
+                        codepoints.push_back(codepoint);
+                        i += trailCount + 1;
+                    }
+                    else
+                    {
+                        codepoints.push_back(c);
+                        i++;
+                    }
+                }
+                return codepoints;
+            }
         }
     }
 }
@@ -108,12 +108,16 @@ App::App()
         char* pp = SDL_GetPrefPath(ORG_PATH, APP_PATH);
         m_prefPath = std::string(pp);
         SDL_free(pp);
+
+        m_workerPool = std::make_unique<WorkerPool>();
 	}
 }
 
 App::~App()
 {
     AudioRenderer::shutdown();
+
+    m_workerPool.reset();
     
     for (auto js : m_joysticks)
     {
@@ -167,6 +171,7 @@ void App::run()
 			Logger::log("Failed loading OpenGL", Logger::Type::Error);
 			return;
 		}
+        m_streamBuffer = std::make_unique<StreamBuffer>();
         IMGUI_INIT(m_window.m_window);
         m_window.setIcon(defaultIcon);
         m_window.setFullScreen(fullscreen);
@@ -205,6 +210,7 @@ void App::run()
         render();
         IMGUI_RENDER;
 		m_window.display();
+        m_streamBuffer->beginFrame();
 
         //SDL_Delay((frameTime - timeSinceLastUpdate).asMilliseconds());
 	}
@@ -221,6 +227,7 @@ void App::run()
     m_messageBus.disable(); //prevents spamming a load of quit messages
     finalise();
     IMGUI_UNINIT;
+    m_streamBuffer.reset();
     m_window.close();
 }
 
@@ -258,6 +265,28 @@ Window& App::getWindow()
     return m_instance->m_window;
 }
 
+WorkerPool& App::getWorkerPool()
+{
+    CRO_ASSERT(hasWorkerPool(), "No valid worker pool");
+    return *m_instance->m_workerPool;
+}
+
+bool App::hasWorkerPool()
+{
+    return m_instance && m_instance->m_workerPool;
+}
+
+StreamBuffer& App::getStreamBuffer()
+{
+    CRO_ASSERT(hasStreamBuffer(), "No valid stream buffer");
+    return *m_instance->m_streamBuffer;
+}
+
+bool App::hasStreamBuffer()
+{
+    return m_instance && m_instance->m_streamBuffer;
+}
+
 const std::string& App::getPreferencePath()
 {
     CRO_ASSERT(m_instance, "No valid app instance");
@@ -398,6 +427,10 @@ void App::doImGui()
         }
 
         ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+
+        const auto& streamStats = m_streamBuffer->getStats();
+        ImGui::Text("Streamed %.1f KB in %u uploads, %u stalls", static_cast<float>(streamStats.bytesUploaded) / 1024.f,
+            static_cast<uint32>(streamStats.uploads), static_cast<uint32>(streamStats.stalls));
         ImGui::NewLine();
 
         //display any registered controls
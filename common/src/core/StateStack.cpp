@@ -34,6 +34,8 @@ source distribution.
 
 #include <crogine/detail/Assert.hpp>
 
+#include "../detail/ParticlePool.hpp"
+
 using namespace cro;
 
 StateStack::StateStack(State::Context context)
@@ -132,6 +134,7 @@ State::Ptr StateStack::createState(StateID id)
 void StateStack::applyPendingChanges()
 {
 	m_activeChanges.swap(m_pendingChanges);
+	bool statesDestroyed = false;
 	for (const auto& change : m_activeChanges)
 	{
 		switch (change.action)
@@ -160,6 +163,7 @@ void StateStack::applyPendingChanges()
             msg->id = id;
 
 			m_stack.pop_back();
+			statesDestroyed = true;
 
 			if (!m_suspended.empty() && m_suspended.back().first == id)
 			{
@@ -172,6 +176,7 @@ void StateStack::applyPendingChanges()
 		case Action::Clear:
 			m_stack.clear();
 			m_suspended.clear();
+			statesDestroyed = true;
         {
             auto* msg = m_messageBus.post<Message::StateEvent>(Message::StateMessage);
             msg->action = Message::StateEvent::Cleared;
@@ -180,4 +185,10 @@ void StateStack::applyPendingChanges()
 		}
 	}
 	m_activeChanges.clear();
+
+	if (statesDestroyed)
+	{
+		//particle blocks freed by the destroyed scenes are unlikely to be reused
+		Detail::ParticlePool::trim();
+	}
 }
@@ -0,0 +1,175 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include <crogine/core/WorkerPool.hpp>
+#include <crogine/core/Log.hpp>
+
+#include <SDL_cpuinfo.h>
+
+#include <algorithm>
+
+using namespace cro;
+
+WorkerPool::WorkerPool(std::size_t threadCount)
+    : m_mutex       (SDL_CreateMutex()),
+    m_jobCondition  (SDL_CreateCond()),
+    m_doneCondition (SDL_CreateCond()),
+    m_task          (nullptr),
+    m_taskCount     (0),
+    m_nextTask      (0),
+    m_completedTasks(0),
+    m_generation    (0),
+    m_activeThreads (0),
+    m_quit          (false),
+    m_busy          (false)
+{
+    if (threadCount == 0)
+    {
+        threadCount = static_cast<std::size_t>(std::max(1, SDL_GetCPUCount() - 1));
+    }
+
+    for (auto i = 0u; i < threadCount; ++i)
+    {
+        auto* thread = SDL_CreateThread(threadFunc, "Worker Thread", this);
+        if (thread)
+        {
+            m_threads.push_back(thread);
+        }
+        else
+        {
+            Logger::log("Failed creating worker thread: " + std::string(SDL_GetError()), Logger::Type::Warning);
+            break;
+        }
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    SDL_LockMutex(m_mutex);
+    m_quit = true;
+    SDL_CondBroadcast(m_jobCondition);
+    SDL_UnlockMutex(m_mutex);
+
+    for (auto* thread : m_threads)
+    {
+        SDL_WaitThread(thread, nullptr);
+    }
+
+    SDL_DestroyCond(m_doneCondition);
+    SDL_DestroyCond(m_jobCondition);
+    SDL_DestroyMutex(m_mutex);
+}
+
+//public
+void WorkerPool::parallelFor(std::size_t count, const std::function<void(std::size_t)>& task)
+{
+    bool expected = false;
+    if (count < 2 || m_threads.empty()
+        || !m_busy.compare_exchange_strong(expected, true))
+    {
+        for (auto i = 0u; i < count; ++i)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    SDL_LockMutex(m_mutex);
+    m_task = &task;
+    m_taskCount = count;
+    m_nextTask = 0;
+    m_completedTasks = 0;
+    m_generation++;
+    SDL_CondBroadcast(m_jobCondition);
+    SDL_UnlockMutex(m_mutex);
+
+    //do our share of the work while we wait
+    runTasks(task, count);
+
+    //wait for the workers to finish, including any which
+    //woke up too late to find any work, so that they don't
+    //pick up tasks from the next job with this one's function
+    SDL_LockMutex(m_mutex);
+    while (m_completedTasks < count || m_activeThreads > 0)
+    {
+        SDL_CondWait(m_doneCondition, m_mutex);
+    }
+    m_task = nullptr;
+    SDL_UnlockMutex(m_mutex);
+
+    m_busy = false;
+}
+
+//private
+int WorkerPool::threadFunc(void* data)
+{
+    auto& pool = *static_cast<WorkerPool*>(data);
+    uint32 generation = 0;
+
+    while (true)
+    {
+        SDL_LockMutex(pool.m_mutex);
+        while (!pool.m_quit && (pool.m_generation == generation || pool.m_task == nullptr))
+        {
+            SDL_CondWait(pool.m_jobCondition, pool.m_mutex);
+        }
+
+        if (pool.m_quit)
+        {
+            SDL_UnlockMutex(pool.m_mutex);
+            break;
+        }
+
+        generation = pool.m_generation;
+        const auto& task = *pool.m_task;
+        const auto count = pool.m_taskCount;
+        pool.m_activeThreads++;
+        SDL_UnlockMutex(pool.m_mutex);
+
+        pool.runTasks(task, count);
+
+        SDL_LockMutex(pool.m_mutex);
+        pool.m_activeThreads--;
+        SDL_CondSignal(pool.m_doneCondition);
+        SDL_UnlockMutex(pool.m_mutex);
+    }
+
+    return 0;
+}
+
+void WorkerPool::runTasks(const std::function<void(std::size_t)>& task, std::size_t count)
+{
+    auto i = m_nextTask++;
+    while (i < count)
+    {
+        task(i);
+        m_completedTasks++;
+        i = m_nextTask++;
+    }
+}
@@ -0,0 +1,291 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include <crogine/detail/Culling.hpp>
+
+#include "Simd.hpp"
+
+#include <cmath>
+
+using namespace cro;
+using namespace cro::Detail;
+
+namespace
+{
+    std::size_t padSize(std::size_t count)
+    {
+        return ((count + SphereArray::BatchSize - 1) / SphereArray::BatchSize) * SphereArray::BatchSize;
+    }
+
+#ifdef CRO_SIMD
+    using namespace Detail::Simd;
+
+    struct SimdPlane final
+    {
+        Vec x, y, z, w;
+        Vec absX, absY, absZ;
+    };
+
+    void loadPlanes(const Frustum& frustum, SimdPlane* planes)
+    {
+        for (auto i = 0u; i < frustum.size(); ++i)
+        {
+            planes[i].x = splat(frustum[i].x);
+            planes[i].y = splat(frustum[i].y);
+            planes[i].z = splat(frustum[i].z);
+            planes[i].w = splat(frustum[i].w);
+            planes[i].absX = splat(std::abs(frustum[i].x));
+            planes[i].absY = splat(std::abs(frustum[i].y));
+            planes[i].absZ = splat(std::abs(frustum[i].z));
+        }
+    }
+
+    //additions are performed in the same order as the scalar
+    //functions in Spatial so that results match exactly
+    inline Vec distance(const SimdPlane& p, Vec x, Vec y, Vec z)
+    {
+        return add(add(add(mul(p.x, x), mul(p.y, y)), mul(p.z, z)), p.w);
+    }
+
+    //volumes are rejected if they are behind any plane, ie distance < -radius
+    void cullSpheres(const Frustum& frustum, const SphereArray& spheres, uint8* output)
+    {
+        SimdPlane planes[6];
+        loadPlanes(frustum, planes);
+
+        const float* x = spheres.getX();
+        const float* y = spheres.getY();
+        const float* z = spheres.getZ();
+        const float* r = spheres.getRadius();
+
+        for (auto i = 0u; i < spheres.size(); i += Width)
+        {
+            const Vec px = load(x + i);
+            const Vec py = load(y + i);
+            const Vec pz = load(z + i);
+            const Vec negRadius = negate(load(r + i));
+
+            Mask mask = allTrue();
+            for (const auto& p : planes)
+            {
+                mask = logicalAnd(mask, greaterEqual(distance(p, px, py, pz), negRadius));
+            }
+            storeMask(mask, output + i);
+        }
+    }
+
+    void cullBoxes(const Frustum& frustum, const BoxArray& boxes, uint8* output)
+    {
+        SimdPlane planes[6];
+        loadPlanes(frustum, planes);
+
+        const float* x = boxes.getX();
+        const float* y = boxes.getY();
+        const float* z = boxes.getZ();
+        const float* ex = boxes.getExtentX();
+        const float* ey = boxes.getExtentY();
+        const float* ez = boxes.getExtentZ();
+
+        for (auto i = 0u; i < boxes.size(); i += Width)
+        {
+            const Vec px = load(x + i);
+            const Vec py = load(y + i);
+            const Vec pz = load(z + i);
+            const Vec extX = load(ex + i);
+            const Vec extY = load(ey + i);
+            const Vec extZ = load(ez + i);
+
+            Mask mask = allTrue();
+            for (const auto& p : planes)
+            {
+                //projected radius of the box onto the plane normal
+                const Vec radius = add(add(mul(extX, p.absX), mul(extY, p.absY)), mul(extZ, p.absZ));
+                mask = logicalAnd(mask, greaterEqual(distance(p, px, py, pz), negate(radius)));
+            }
+            storeMask(mask, output + i);
+        }
+    }
+#endif
+}
+
+void SphereArray::clear()
+{
+    m_count = 0;
+    m_x.clear();
+    m_y.clear();
+    m_z.clear();
+    m_radius.clear();
+}
+
+void SphereArray::reserve(std::size_t count)
+{
+    count = padSize(count);
+    m_x.reserve(count);
+    m_y.reserve(count);
+    m_z.reserve(count);
+    m_radius.reserve(count);
+}
+
+void SphereArray::push_back(const Sphere& sphere)
+{
+    //grow a whole batch at a time so there's always padding
+    if (m_count == m_radius.size())
+    {
+        const auto size = m_count + BatchSize;
+        m_x.resize(size);
+        m_y.resize(size);
+        m_z.resize(size);
+        m_radius.resize(size);
+    }
+
+    m_x[m_count] = sphere.centre.x;
+    m_y[m_count] = sphere.centre.y;
+    m_z[m_count] = sphere.centre.z;
+    m_radius[m_count] = sphere.radius;
+    m_count++;
+}
+
+void BoxArray::clear()
+{
+    m_count = 0;
+    m_x.clear();
+    m_y.clear();
+    m_z.clear();
+    m_extentX.clear();
+    m_extentY.clear();
+    m_extentZ.clear();
+}
+
+void BoxArray::reserve(std::size_t count)
+{
+    count = padSize(count);
+    m_x.reserve(count);
+    m_y.reserve(count);
+    m_z.reserve(count);
+    m_extentX.reserve(count);
+    m_extentY.reserve(count);
+    m_extentZ.reserve(count);
+}
+
+void BoxArray::push_back(const Box& box)
+{
+    if (m_count == m_x.size())
+    {
+        const auto size = m_count + BatchSize;
+        m_x.resize(size);
+        m_y.resize(size);
+        m_z.resize(size);
+        m_extentX.resize(size);
+        m_extentY.resize(size);
+        m_extentZ.resize(size);
+    }
+
+    const glm::vec3 centre = (box[0] + box[1]) / 2.f;
+    const glm::vec3 extents = (box[1] - box[0]) / 2.f;
+
+    m_x[m_count] = centre.x;
+    m_y[m_count] = centre.y;
+    m_z[m_count] = centre.z;
+    m_extentX[m_count] = std::abs(extents.x);
+    m_extentY[m_count] = std::abs(extents.y);
+    m_extentZ[m_count] = std::abs(extents.z);
+    m_count++;
+}
+
+void Culling::frustumCull(const Frustum& frustum, const SphereArray& spheres, std::vector<uint8>& output)
+{
+#ifdef CRO_SIMD
+    output.resize(spheres.paddedSize());
+    cullSpheres(frustum, spheres, output.data());
+#else
+    frustumCullScalar(frustum, spheres, output);
+#endif
+}
+
+void Culling::frustumCull(const Frustum& frustum, const BoxArray& boxes, std::vector<uint8>& output)
+{
+#ifdef CRO_SIMD
+    output.resize(boxes.paddedSize());
+    cullBoxes(frustum, boxes, output.data());
+#else
+    frustumCullScalar(frustum, boxes, output);
+#endif
+}
+
+void Culling::frustumCullScalar(const Frustum& frustum, const SphereArray& spheres, std::vector<uint8>& output)
+{
+    output.resize(spheres.paddedSize());
+
+    const float* x = spheres.getX();
+    const float* y = spheres.getY();
+    const float* z = spheres.getZ();
+    const float* r = spheres.getRadius();
+
+    for (auto i = 0u; i < spheres.size(); ++i)
+    {
+        Sphere sphere;
+        sphere.centre = { x[i], y[i], z[i] };
+        sphere.radius = r[i];
+
+        bool visible = true;
+        std::size_t j = 0;
+        while (visible && j < frustum.size())
+        {
+            visible = (Spatial::intersects(frustum[j++], sphere) != Planar::Back);
+        }
+        output[i] = visible ? 1 : 0;
+    }
+}
+
+void Culling::frustumCullScalar(const Frustum& frustum, const BoxArray& boxes, std::vector<uint8>& output)
+{
+    output.resize(boxes.paddedSize());
+
+    const float* x = boxes.getX();
+    const float* y = boxes.getY();
+    const float* z = boxes.getZ();
+    const float* ex = boxes.getExtentX();
+    const float* ey = boxes.getExtentY();
+    const float* ez = boxes.getExtentZ();
+
+    for (auto i = 0u; i < boxes.size(); ++i)
+    {
+        const glm::vec3 centre(x[i], y[i], z[i]);
+        const glm::vec3 extents(ex[i], ey[i], ez[i]);
+        const Box box = { centre - extents, centre + extents };
+
+        bool visible = true;
+        std::size_t j = 0;
+        while (visible && j < frustum.size())
+        {
+            visible = (Spatial::intersects(frustum[j++], box) != Planar::Back);
+        }
+        output[i] = visible ? 1 : 0;
+    }
+}
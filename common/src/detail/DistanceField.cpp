@@ -28,10 +28,11 @@ source distribution.
 -----------------------------------------------------------------------*/
 
 #include "DistanceField.hpp"
+#include "Simd.hpp"
+
+#include <crogine/core/App.hpp>
 
 #include <cmath>
-#include <climits>
-#include <cstring>
 #include <algorithm>
 
 using namespace cro;
@@ -39,126 +40,215 @@ using namespace cro::Detail;
 
 namespace
 {
-    const float INF = 1e20;
-    inline int32 square(int32 x)
+    const float INF = 1e20f;
+    const std::size_t BitmapsPerChunk = 4;
+}
+
+void DistanceField::toSDF(Bitmap& bitmap, float spread)
+{
+    Workspace workspace;
+    process(bitmap, spread, workspace);
+}
+
+void DistanceField::toSDF(std::vector<Bitmap>& bitmaps, float spread)
+{
+    //bitmaps are processed in small chunks, which the worker
+    //threads take in turn, as glyphs vary in size
+    const auto chunkCount = (bitmaps.size() + BitmapsPerChunk - 1) / BitmapsPerChunk;
+    auto work = [&](std::size_t chunk)
     {
-        return x * x;
+        Workspace workspace;
+        const auto first = chunk * BitmapsPerChunk;
+        const auto last = std::min(bitmaps.size(), first + BitmapsPerChunk);
+        for (auto i = first; i < last; ++i)
+        {
+            process(bitmaps[i], spread, workspace);
+        }
+    };
+
+    if (App::hasWorkerPool())
+    {
+        App::getWorkerPool().parallelFor(chunkCount, work);
+    }
+    else
+    {
+        for (auto i = 0u; i < chunkCount; ++i)
+        {
+            work(i);
+        }
     }
 }
 
-std::vector<uint8> DistanceField::toDF(const SDL_Surface* input)
+//private
+void DistanceField::process(Bitmap& bitmap, float spread, Workspace& workspace)
 {
-    std::size_t size = input->pitch * input->h;
-    std::vector<float> floatData(size);
-    uint8* pixels = static_cast<uint8*>(input->pixels);
-    for (auto i = 0u; i < size; ++i)
+    const auto size = static_cast<std::size_t>(bitmap.width * bitmap.height);
+    if (size == 0)
     {
-        floatData[i] = (pixels[i] > 240) ? 0.f : INF;
+        return;
     }
 
-    twoD(floatData, input->pitch, input->h);
+    //pixels at least half covered are treated as inside the shape
+    workspace.outside.resize(size);
+    workspace.inside.resize(size);
+    for (auto i = 0u; i < size; ++i)
+    {
+        bool inside = bitmap.pixels[i] > 127;
+        workspace.outside[i] = inside ? 0.f : 1.f;
+        workspace.inside[i] = inside ? 1.f : 0.f;
+    }
 
-    for (auto& f : floatData)
+    columns(workspace.outside, bitmap.width, bitmap.height);
+    columns(workspace.inside, bitmap.width, bitmap.height);
+    rows(workspace.outside, bitmap.width, bitmap.height, workspace);
+    rows(workspace.inside, bitmap.width, bitmap.height, workspace);
+
+    //signed distance is positive inside the shape, and is then
+    //scaled so that +/- spread maps to the full range of a byte
+    const float scale = 0.5f / spread;
+    workspace.result.resize(size);
+    std::size_t i = 0;
+#ifdef CRO_SIMD
+    using namespace Simd;
+    const Vec half = splat(0.5f);
+    const Vec scaleV = splat(scale);
+    const Vec zero = splat(0.f);
+    const Vec one = splat(1.f);
+    const Vec byteMax = splat(255.f);
+    for (; i + Width <= size; i += Width)
     {
-        f = std::sqrt(f);
+        Vec dist = sub(sqrt(load(&workspace.inside[i])), sqrt(load(&workspace.outside[i])));
+        Vec value = min(max(add(half, mul(dist, scaleV)), zero), one);
+        store(&workspace.result[i], add(mul(value, byteMax), half));
+    }
+#endif
+    for (; i < size; ++i)
+    {
+        float dist = std::sqrt(workspace.inside[i]) - std::sqrt(workspace.outside[i]);
+        float value = std::min(std::max(0.5f + (dist * scale), 0.f), 1.f);
+        workspace.result[i] = (value * 255.f) + 0.5f;
     }
 
-    return toBytes(floatData);
+    for (i = 0; i < size; ++i)
+    {
+        bitmap.pixels[i] = static_cast<uint8>(workspace.result[i]);
+    }
 }
 
-//private
-void DistanceField::twoD(std::vector<float>& floatData, int32 width, int32 height)
+void DistanceField::columns(std::vector<float>& data, int32 width, int32 height)
 {
-    std::vector<float> f(std::max(width, height));
+    //on input 0 marks the pixels to measure the distance to. For a binary image
+    //the distance along each column is found with a scan in each direction, which
+    //processes a whole row of columns at once. Output is the squared distance
+    const float far = static_cast<float>(width + height);
+    for (auto x = 0; x < width; ++x)
+    {
+        data[x] = (data[x] == 0.f) ? 0.f : far;
+    }
 
-    for (auto x = 0; x < width; x++) 
+    for (auto y = 1; y < height; ++y)
     {
-        for (auto y = 0; y < height; y++)
+        float* row = &data[y * width];
+        const float* prev = row - width;
+        auto x = 0;
+#ifdef CRO_SIMD
+        using namespace Simd;
+        const Vec zero = splat(0.f);
+        const Vec one = splat(1.f);
+        for (; x + static_cast<int32>(Width) <= width; x += Width)
         {
-            f[y] = floatData[y * width + x];
+            //a pixel is either 0 or the distance to the one above, plus one
+            Vec current = load(row + x);
+            Vec above = add(load(prev + x), one);
+            store(row + x, select(greaterEqual(zero, current), zero, above));
         }
-        auto d = oneD(f, height);
-
-        for (auto y = 0; y < height; y++)
+#endif
+        for (; x < width; ++x)
         {
-            floatData[y * width + x] = d[y];
+            row[x] = (row[x] == 0.f) ? 0.f : prev[x] + 1.f;
         }
     }
 
-    for (auto y = 0; y < height; y++)
+    for (auto y = height - 2; y >= 0; --y)
     {
-        for (auto x = 0; x < width; x++)
+        float* row = &data[y * width];
+        const float* next = row + width;
+        auto x = 0;
+#ifdef CRO_SIMD
+        using namespace Simd;
+        const Vec one = splat(1.f);
+        for (; x + static_cast<int32>(Width) <= width; x += Width)
         {
-            f[x] = floatData[y * width + x];
+            store(row + x, min(load(row + x), add(load(next + x), one)));
         }
-        auto d = oneD(f, width);
-
-        for (auto x = 0; x < width; x++)
+#endif
+        for (; x < width; ++x)
         {
-            floatData[y * width + x] = d[x];
+            row[x] = std::min(row[x], next[x] + 1.f);
         }
     }
+
+    std::size_t i = 0;
+    const auto size = data.size();
+#ifdef CRO_SIMD
+    using namespace Simd;
+    for (; i + Width <= size; i += Width)
+    {
+        Vec d = load(&data[i]);
+        store(&data[i], mul(d, d));
+    }
+#endif
+    for (; i < size; ++i)
+    {
+        data[i] *= data[i];
+    }
 }
 
-std::vector<float> DistanceField::oneD(const std::vector<float>& floatData, std::size_t size)
+void DistanceField::rows(std::vector<float>& data, int32 width, int32 height, Workspace& workspace)
 {
-    std::vector<float> d(size);
-    std::vector<int32> v(size);
-    std::vector<float> z(size + 1);
+    workspace.row.resize(width);
+    for (auto y = 0; y < height; ++y)
+    {
+        float* row = &data[y * width];
+        std::copy(row, row + width, workspace.row.begin());
+        oneD(workspace.row.data(), row, width, workspace);
+    }
+}
+
+void DistanceField::oneD(const float* f, float* d, int32 size, Workspace& workspace)
+{
+    //lower envelope of parabolas, Felzenszwalb & Huttenlocher
+    auto& v = workspace.v;
+    auto& z = workspace.z;
+    v.resize(size);
+    z.resize(size + 1);
 
     int32 k = 0;
     v[0] = 0;
     z[0] = -INF;
     z[1] = INF;
 
-    for (auto q = 1u; q <= size - 1; q++)
+    for (auto q = 1; q < size; ++q)
     {
-        float s = ((floatData[q] + square(q)) - (floatData[v[k]] + square(v[k]))) / (2 * q - 2 * v[k]);
-        while (s <= z[k]) 
+        float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        while (s <= z[k])
         {
             k--;
-            s = ((floatData[q] + square(q)) - (floatData[v[k]] + square(v[k]))) / (2 * q - 2 * v[k]);
+            s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
         }
         k++;
         v[k] = q;
         z[k] = s;
-        z[k + 1] = +INF;
+        z[k + 1] = INF;
     }
 
     k = 0;
-    for (auto q = 0u; q <= size - 1; q++) 
+    for (auto q = 0; q < size; ++q)
     {
         while (z[k + 1] < q)
+        {
             k++;
-        d[q] = square(q - v[k]) + floatData[v[k]];
-    }
-
-    return d;
-}
-
-std::vector<uint8> DistanceField::toBytes(const std::vector<float>& floatData)
-{
-    float min, max;
-    min = max = floatData[0];
-    for (auto f : floatData)
-    {
-        if (f < min) min = f;
-        if (f > max) max = f;
-    }
-
-    std::vector<uint8> retVal(floatData.size());
-    std::memset(retVal.data(), 0, retVal.size());
-    if (min == max)
-    {
-        return retVal;
-    }
-
-    float scale = UCHAR_MAX / (max - min);
-    for (auto i = 0u; i < retVal.size(); ++i)
-    {
-        uint8 val = static_cast<uint8>(255.f - ((floatData[i] - min) * scale));
-        retVal[i] = val;
+        }
+        d[q] = static_cast<float>((q - v[k]) * (q - v[k])) + f[v[k]];
     }
-
-    return retVal;
 }
@@ -33,23 +33,55 @@ source distribution.
 #include <crogine/Config.hpp>
 #include <crogine/detail/Types.hpp>
 
-#include <SDL_surface.h>
-
 #include <vector>
 
 namespace cro
 {
     namespace Detail
     {
+        /*!
+        \brief Converts 8 bit coverage images, such as rasterised glyphs,
+        in to signed distance fields using an exact Euclidean distance transform.
+        Distances are clamped to +/- spread pixels and mapped to 0 - 255 with
+        the edge of the shape at 128, so that the result can be stored in a
+        single channel texture.
+        */
         class DistanceField final
         {
         public:
-            static std::vector<uint8> toDF(const SDL_Surface* input);
+            struct Bitmap final
+            {
+                std::vector<uint8> pixels; //tightly packed rows, replaced with the distance field
+                int32 width = 0;
+                int32 height = 0;
+            };
+
+            /*!
+            \brief Converts the given bitmap in place
+            */
+            static void toSDF(Bitmap&, float spread);
+
+            /*!
+            \brief Converts a set of bitmaps in place, spreading
+            the work across the App's WorkerPool if there is one
+            */
+            static void toSDF(std::vector<Bitmap>&, float spread);
 
         private:
-            static void twoD(std::vector<float>&, int32, int32);
-            static std::vector<float> oneD(const std::vector<float>&, std::size_t);
-            static std::vector<uint8> toBytes(const std::vector<float>&);
+            //scratch space reused between bitmaps processed on the same thread
+            struct Workspace final
+            {
+                std::vector<float> outside; //squared distance to the nearest inside pixel
+                std::vector<float> inside; //squared distance to the nearest outside pixel
+                std::vector<float> row;
+                std::vector<float> result;
+                std::vector<int32> v;
+                std::vector<float> z;
+            };
+            static void process(Bitmap&, float spread, Workspace&);
+            static void columns(std::vector<float>&, int32, int32);
+            static void rows(std::vector<float>&, int32, int32, Workspace&);
+            static void oneD(const float*, float*, int32, Workspace&);
         };
     }
 }
@@ -0,0 +1,1052 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include <crogine/detail/GLRecorder.hpp>
+#include <crogine/core/Log.hpp>
+
+#include "glad.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+using namespace cro;
+using namespace cro::Detail;
+
+//every GL function replaced by the recorder
+#define CRO_GL_RECORDER_FUNCTIONS \
+    X(ActiveTexture) X(AttachShader) X(BindBuffer) X(BindFramebuffer) X(BindRenderbuffer) X(BindTexture) \
+    X(BindVertexArray) X(BlendEquation) X(BlendEquationSeparate) X(BlendFunc) X(BlendFuncSeparate) \
+    X(BufferData) X(BufferSubData) X(CheckFramebufferStatus) X(Clear) X(ClientWaitSync) X(ClearColor) X(ColorMask) \
+    X(CompileShader) X(CreateProgram) X(CreateShader) X(CullFace) X(DeleteBuffers) X(DeleteFramebuffers) \
+    X(DeleteProgram) X(DeleteRenderbuffers) X(DeleteShader) X(DeleteSync) X(DeleteTextures) X(DeleteVertexArrays) \
+    X(DepthFunc) X(DepthMask) X(DetachShader) X(Disable) X(DisableVertexAttribArray) X(DrawArrays) \
+    X(DrawElements) X(Enable) X(EnableVertexAttribArray) X(FenceSync) X(Finish) X(Flush) X(FramebufferRenderbuffer) \
+    X(FramebufferTexture2D) X(GenBuffers) X(GenerateMipmap) X(GenFramebuffers) X(GenRenderbuffers) \
+    X(GenTextures) X(GenVertexArrays) X(GetActiveAttrib) X(GetActiveUniform) X(GetAttribLocation) \
+    X(GetError) X(GetFloatv) X(GetIntegerv) X(GetProgramInfoLog) X(GetProgramiv) X(GetShaderInfoLog) \
+    X(GetShaderiv) X(GetUniformLocation) X(IsEnabled) X(LinkProgram) X(MapBufferRange) X(PixelStorei) X(RenderbufferStorage) \
+    X(Scissor) X(ShaderSource) X(TexImage2D) X(TexParameteri) X(TexSubImage2D) X(Uniform1f) X(Uniform1fv) \
+    X(Uniform1i) X(Uniform1iv) X(Uniform2f) X(Uniform2fv) X(Uniform3f) X(Uniform3fv) X(Uniform4f) \
+    X(Uniform4fv) X(UniformMatrix3fv) X(UniformMatrix4fv) X(UnmapBuffer) X(UseProgram) X(VertexAttribPointer) X(Viewport)
+
+namespace
+{
+    //a uniform or attribute parsed from shader source
+    struct Variable final
+    {
+        std::string name;
+        GLint size = 1;
+        GLenum type = GL_FLOAT;
+        GLint location = 0;
+    };
+
+    struct Program final
+    {
+        std::vector<GLuint> shaders;
+        std::vector<Variable> attributes;
+        std::vector<Variable> uniforms;
+    };
+
+    const std::size_t MaxTextureUnits = 32;
+
+    struct State final
+    {
+        bool installed = false;
+        bool commandsEnabled = true;
+        std::vector<GLRecorder::Command> commands;
+        GLRecorder::Stats stats;
+
+        GLuint nextID = 1;
+        GLuint program = 0;
+        GLuint arrayBuffer = 0;
+        GLuint elementBuffer = 0;
+        GLuint framebuffer = 0;
+        GLuint renderbuffer = 0;
+        GLuint vertexArray = 0;
+        std::size_t activeUnit = 0;
+        std::array<GLuint, MaxTextureUnits> textures = {};
+
+        std::vector<GLenum> enabledCaps;
+        std::array<GLint, 4u> viewport = {};
+        std::array<GLint, 4u> scissor = {};
+        std::array<GLfloat, 4u> clearColour = {};
+
+        std::vector<std::uint8_t> mappedBuffer;
+        GLuint nextSync = 1;
+
+        std::unordered_map<GLuint, std::string> shaderSources;
+        std::unordered_map<GLuint, Program> programs;
+    }state;
+
+    //storage for the original function pointers
+    struct Originals final
+    {
+#define X(fn) decltype(glad_gl##fn) fn = nullptr;
+        CRO_GL_RECORDER_FUNCTIONS
+#undef X
+    }originals;
+
+    void record(GLRecorder::Command::Type type, const char* name, int64 a = 0, int64 b = 0, int64 c = 0, int64 d = 0, std::size_t bytes = 0)
+    {
+        using Command = GLRecorder::Command;
+        auto& stats = state.stats;
+        switch (type)
+        {
+        default: break;
+        case Command::UseProgram:
+            stats.programChanges++;
+            break;
+        case Command::BindBuffer:
+            stats.bufferBinds++;
+            break;
+        case Command::BindTexture:
+            stats.textureBinds++;
+            break;
+        case Command::BindFramebuffer:
+            stats.framebufferBinds++;
+            break;
+        case Command::Upload:
+            stats.uploads++;
+            stats.bytesUploaded += bytes;
+            break;
+        case Command::Uniform:
+            stats.uniformUpdates++;
+            break;
+        case Command::State:
+            stats.stateChanges++;
+            break;
+        }
+
+        if (state.commandsEnabled)
+        {
+            Command cmd;
+            cmd.type = type;
+            cmd.name = name;
+            cmd.args = { {a, b, c, d} };
+            cmd.bytes = bytes;
+            state.commands.push_back(cmd);
+        }
+    }
+
+    void bind(GLRecorder::Command::Type type, const char* name, GLuint& current, GLuint id, GLenum target = 0)
+    {
+        if (current == id)
+        {
+            state.stats.redundantBinds++;
+        }
+        current = id;
+        record(type, name, target, id);
+    }
+
+    std::size_t pixelSize(GLenum format, GLenum type)
+    {
+        switch (type)
+        {
+        default: break;
+        case GL_UNSIGNED_SHORT_5_6_5:
+        case GL_UNSIGNED_SHORT_4_4_4_4:
+        case GL_UNSIGNED_SHORT_5_5_5_1:
+            return 2;
+        }
+
+        std::size_t channels = 4;
+        switch (format)
+        {
+        default: break;
+        case GL_RGB:
+            channels = 3;
+            break;
+        case GL_RG:
+            channels = 2;
+            break;
+        case GL_RED:
+        case GL_ALPHA:
+        case GL_DEPTH_COMPONENT:
+            channels = 1;
+            break;
+        }
+
+        switch (type)
+        {
+        default: return channels;
+        case GL_UNSIGNED_SHORT:
+        case GL_SHORT:
+        case GL_HALF_FLOAT:
+            return channels * 2;
+        case GL_UNSIGNED_INT:
+        case GL_INT:
+        case GL_FLOAT:
+            return channels * 4;
+        }
+    }
+
+    GLenum typeFromString(const std::string& str)
+    {
+        static const std::unordered_map<std::string, GLenum> types =
+        {
+            std::make_pair("float", GL_FLOAT),
+            std::make_pair("vec2", GL_FLOAT_VEC2),
+            std::make_pair("vec3", GL_FLOAT_VEC3),
+            std::make_pair("vec4", GL_FLOAT_VEC4),
+            std::make_pair("int", GL_INT),
+            std::make_pair("ivec2", GL_INT_VEC2),
+            std::make_pair("ivec3", GL_INT_VEC3),
+            std::make_pair("ivec4", GL_INT_VEC4),
+            std::make_pair("bool", GL_BOOL),
+            std::make_pair("mat2", GL_FLOAT_MAT2),
+            std::make_pair("mat3", GL_FLOAT_MAT3),
+            std::make_pair("mat4", GL_FLOAT_MAT4),
+            std::make_pair("sampler2D", GL_SAMPLER_2D),
+            std::make_pair("samplerCube", GL_SAMPLER_CUBE)
+        };
+
+        auto result = types.find(str);
+        return result == types.end() ? GL_FLOAT : result->second;
+    }
+
+    //finds all variables declared with the given keyword. Preprocessor
+    //conditions are ignored so declarations in disabled blocks are also returned,
+    //which is harmless when nothing is actually drawn.
+    void parseVariables(const std::string& src, const std::string& keyword, std::vector<Variable>& dst)
+    {
+        auto isIdentifier = [](char c)
+        {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+        };
+
+        auto pos = src.find(keyword);
+        while (pos != std::string::npos)
+        {
+            auto start = pos + keyword.size();
+            if ((pos > 0 && isIdentifier(src[pos - 1]))
+                || start == src.size() || isIdentifier(src[start]))
+            {
+                pos = src.find(keyword, start);
+                continue;
+            }
+
+            auto end = src.find(';', start);
+            if (end == std::string::npos)
+            {
+                break;
+            }
+
+            //strip any array size
+            GLint size = 1;
+            auto declaration = src.substr(start, end - start);
+            auto bracket = declaration.find('[');
+            if (bracket != std::string::npos)
+            {
+                auto sizeStr = declaration.substr(bracket + 1, declaration.find(']', bracket) - bracket - 1);
+                sizeStr.erase(std::remove_if(sizeStr.begin(), sizeStr.end(), [](char c) {return std::isspace(static_cast<unsigned char>(c)); }), sizeStr.end());
+                if (!sizeStr.empty() && !std::isdigit(static_cast<unsigned char>(sizeStr[0])))
+                {
+                    //look for the value of the macro
+                    auto define = src.find("#define " + sizeStr + " ");
+                    sizeStr = (define == std::string::npos) ? "1" : src.substr(define + 9 + sizeStr.size());
+                }
+                size = std::max(1, std::atoi(sizeStr.c_str()));
+                declaration = declaration.substr(0, bracket);
+            }
+
+            //split into identifiers, the last is the name and the one before the type
+            std::vector<std::string> tokens;
+            for (auto i = 0u; i < declaration.size();)
+            {
+                if (isIdentifier(declaration[i]))
+                {
+                    auto j = i;
+                    while (j < declaration.size() && isIdentifier(declaration[j])) { ++j; }
+                    tokens.push_back(declaration.substr(i, j - i));
+                    i = j;
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+
+            if (tokens.size() > 1)
+            {
+                Variable var;
+                var.name = tokens.back();
+                var.type = typeFromString(tokens[tokens.size() - 2]);
+                var.size = size;
+                if (size > 1)
+                {
+                    var.name += "[0]";
+                }
+
+                auto existing = std::find_if(dst.begin(), dst.end(), [&var](const Variable& v) {return v.name == var.name; });
+                if (existing == dst.end())
+                {
+                    var.location = dst.empty() ? 0 : dst.back().location + dst.back().size;
+                    dst.push_back(var);
+                }
+            }
+            pos = src.find(keyword, end);
+        }
+    }
+
+    const Variable* findVariable(GLuint program, GLuint index, bool uniform)
+    {
+        auto result = state.programs.find(program);
+        if (result != state.programs.end())
+        {
+            const auto& vars = uniform ? result->second.uniforms : result->second.attributes;
+            if (index < vars.size())
+            {
+                return &vars[index];
+            }
+        }
+        return nullptr;
+    }
+
+    GLint findLocation(GLuint program, const GLchar* name, bool uniform)
+    {
+        auto result = state.programs.find(program);
+        if (result != state.programs.end())
+        {
+            const auto& vars = uniform ? result->second.uniforms : result->second.attributes;
+            std::string str(name);
+            auto var = std::find_if(vars.begin(), vars.end(), [&str](const Variable& v) {return v.name == str; });
+            if (var != vars.end())
+            {
+                return var->location;
+            }
+        }
+        return -1;
+    }
+
+    void getActive(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name, bool uniform)
+    {
+        const auto* var = findVariable(program, index, uniform);
+        GLsizei count = 0;
+        if (var && bufSize > 0)
+        {
+            count = static_cast<GLsizei>(std::min(var->name.size(), static_cast<std::size_t>(bufSize - 1)));
+            std::memcpy(name, var->name.data(), count);
+            name[count] = 0;
+        }
+        else if (bufSize > 0)
+        {
+            name[0] = 0;
+        }
+
+        if (length) *length = count;
+        if (size) *size = var ? var->size : 0;
+        if (type) *type = var ? var->type : GL_FLOAT;
+    }
+
+    void generate(GLsizei n, GLuint* ids)
+    {
+        for (auto i = 0; i < n; ++i)
+        {
+            ids[i] = state.nextID++;
+        }
+    }
+
+    void release(GLsizei n, const GLuint* ids, GLuint& bound)
+    {
+        for (auto i = 0; i < n; ++i)
+        {
+            if (ids[i] == bound)
+            {
+                bound = 0;
+            }
+        }
+    }
+
+    //the first of a set of IDs, or 0 if the set is empty, for recording
+    GLuint firstID(GLsizei n, const GLuint* ids)
+    {
+        return (n > 0) ? ids[0] : 0;
+    }
+
+    //recording functions, named after the GL function they replace
+    void APIENTRY ActiveTexture(GLenum texture)
+    {
+        state.activeUnit = std::min(static_cast<std::size_t>(texture - GL_TEXTURE0), MaxTextureUnits - 1);
+        record(GLRecorder::Command::State, "glActiveTexture", texture);
+    }
+
+    void APIENTRY AttachShader(GLuint program, GLuint shader)
+    {
+        state.programs[program].shaders.push_back(shader);
+        record(GLRecorder::Command::Resource, "glAttachShader", program, shader);
+    }
+
+    void APIENTRY BindBuffer(GLenum target, GLuint buffer)
+    {
+        auto& current = (target == GL_ELEMENT_ARRAY_BUFFER) ? state.elementBuffer : state.arrayBuffer;
+        bind(GLRecorder::Command::BindBuffer, "glBindBuffer", current, buffer, target);
+    }
+
+    void APIENTRY BindFramebuffer(GLenum target, GLuint framebuffer)
+    {
+        bind(GLRecorder::Command::BindFramebuffer, "glBindFramebuffer", state.framebuffer, framebuffer, target);
+    }
+
+    void APIENTRY BindRenderbuffer(GLenum target, GLuint renderbuffer)
+    {
+        state.renderbuffer = renderbuffer;
+        record(GLRecorder::Command::Resource, "glBindRenderbuffer", target, renderbuffer);
+    }
+
+    void APIENTRY BindTexture(GLenum target, GLuint texture)
+    {
+        bind(GLRecorder::Command::BindTexture, "glBindTexture", state.textures[state.activeUnit], texture, target);
+    }
+
+    void APIENTRY BindVertexArray(GLuint array)
+    {
+        bind(GLRecorder::Command::BindVertexArray, "glBindVertexArray", state.vertexArray, array);
+    }
+
+    void APIENTRY BlendEquation(GLenum mode)
+    {
+        record(GLRecorder::Command::State, "glBlendEquation", mode);
+    }
+
+    void APIENTRY BlendEquationSeparate(GLenum modeRGB, GLenum modeAlpha)
+    {
+        record(GLRecorder::Command::State, "glBlendEquationSeparate", modeRGB, modeAlpha);
+    }
+
+    void APIENTRY BlendFunc(GLenum sfactor, GLenum dfactor)
+    {
+        record(GLRecorder::Command::State, "glBlendFunc", sfactor, dfactor);
+    }
+
+    void APIENTRY BlendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
+    {
+        record(GLRecorder::Command::State, "glBlendFuncSeparate", srcRGB, dstRGB, srcAlpha, dstAlpha);
+    }
+
+    void APIENTRY BufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+    {
+        record(GLRecorder::Command::Upload, "glBufferData", target, size, usage, 0, data ? static_cast<std::size_t>(size) : 0);
+    }
+
+    void APIENTRY BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void*)
+    {
+        record(GLRecorder::Command::Upload, "glBufferSubData", target, offset, size, 0, static_cast<std::size_t>(size));
+    }
+
+    GLenum APIENTRY CheckFramebufferStatus(GLenum target)
+    {
+        record(GLRecorder::Command::Query, "glCheckFramebufferStatus", target);
+        return GL_FRAMEBUFFER_COMPLETE;
+    }
+
+    void APIENTRY Clear(GLbitfield mask)
+    {
+        record(GLRecorder::Command::Clear, "glClear", mask);
+    }
+
+    GLenum APIENTRY ClientWaitSync(GLsync sync, GLbitfield, GLuint64)
+    {
+        record(GLRecorder::Command::Query, "glClientWaitSync", reinterpret_cast<std::intptr_t>(sync));
+        return GL_ALREADY_SIGNALED;
+    }
+
+    void APIENTRY ClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a)
+    {
+        state.clearColour = { {r, g, b, a} };
+        record(GLRecorder::Command::State, "glClearColor");
+    }
+
+    void APIENTRY ColorMask(GLboolean r, GLboolean g, GLboolean b, GLboolean a)
+    {
+        record(GLRecorder::Command::State, "glColorMask", r, g, b, a);
+    }
+
+    void APIENTRY CompileShader(GLuint shader)
+    {
+        record(GLRecorder::Command::Resource, "glCompileShader", shader);
+    }
+
+    GLuint APIENTRY CreateProgram()
+    {
+        auto id = state.nextID++;
+        state.programs[id] = {};
+        record(GLRecorder::Command::Resource, "glCreateProgram", id);
+        return id;
+    }
+
+    GLuint APIENTRY CreateShader(GLenum type)
+    {
+        auto id = state.nextID++;
+        state.shaderSources[id].clear();
+        record(GLRecorder::Command::Resource, "glCreateShader", type, id);
+        return id;
+    }
+
+    void APIENTRY CullFace(GLenum mode)
+    {
+        record(GLRecorder::Command::State, "glCullFace", mode);
+    }
+
+    void APIENTRY DeleteBuffers(GLsizei n, const GLuint* buffers)
+    {
+        release(n, buffers, state.arrayBuffer);
+        release(n, buffers, state.elementBuffer);
+        record(GLRecorder::Command::Resource, "glDeleteBuffers", n, firstID(n, buffers));
+    }
+
+    void APIENTRY DeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+    {
+        release(n, framebuffers, state.framebuffer);
+        record(GLRecorder::Command::Resource, "glDeleteFramebuffers", n, firstID(n, framebuffers));
+    }
+
+    void APIENTRY DeleteProgram(GLuint program)
+    {
+        state.programs.erase(program);
+        release(1, &program, state.program);
+        record(GLRecorder::Command::Resource, "glDeleteProgram", program);
+    }
+
+    void APIENTRY DeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers)
+    {
+        release(n, renderbuffers, state.renderbuffer);
+        record(GLRecorder::Command::Resource, "glDeleteRenderbuffers", n, firstID(n, renderbuffers));
+    }
+
+    void APIENTRY DeleteShader(GLuint shader)
+    {
+        state.shaderSources.erase(shader);
+        record(GLRecorder::Command::Resource, "glDeleteShader", shader);
+    }
+
+    void APIENTRY DeleteSync(GLsync sync)
+    {
+        record(GLRecorder::Command::Resource, "glDeleteSync", reinterpret_cast<std::intptr_t>(sync));
+    }
+
+    void APIENTRY DeleteTextures(GLsizei n, const GLuint* textures)
+    {
+        for (auto& t : state.textures)
+        {
+            release(n, textures, t);
+        }
+        record(GLRecorder::Command::Resource, "glDeleteTextures", n, firstID(n, textures));
+    }
+
+    void APIENTRY DeleteVertexArrays(GLsizei n, const GLuint* arrays)
+    {
+        release(n, arrays, state.vertexArray);
+        record(GLRecorder::Command::Resource, "glDeleteVertexArrays", n, firstID(n, arrays));
+    }
+
+    void APIENTRY DepthFunc(GLenum func)
+    {
+        record(GLRecorder::Command::State, "glDepthFunc", func);
+    }
+
+    void APIENTRY DepthMask(GLboolean flag)
+    {
+        record(GLRecorder::Command::State, "glDepthMask", flag);
+    }
+
+    void APIENTRY DetachShader(GLuint program, GLuint shader)
+    {
+        auto& shaders = state.programs[program].shaders;
+        shaders.erase(std::remove(shaders.begin(), shaders.end(), shader), shaders.end());
+        record(GLRecorder::Command::Resource, "glDetachShader", program, shader);
+    }
+
+    void APIENTRY Disable(GLenum cap)
+    {
+        auto& caps = state.enabledCaps;
+        caps.erase(std::remove(caps.begin(), caps.end(), cap), caps.end());
+        record(GLRecorder::Command::State, "glDisable", cap);
+    }
+
+    void APIENTRY DisableVertexAttribArray(GLuint index)
+    {
+        record(GLRecorder::Command::VertexAttrib, "glDisableVertexAttribArray", index);
+    }
+
+    void APIENTRY DrawArrays(GLenum mode, GLint first, GLsizei count)
+    {
+        state.stats.drawCalls++;
+        state.stats.elementsDrawn += count;
+        record(GLRecorder::Command::Draw, "glDrawArrays", mode, first, count);
+    }
+
+    void APIENTRY DrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+    {
+        state.stats.drawCalls++;
+        state.stats.elementsDrawn += count;
+        record(GLRecorder::Command::Draw, "glDrawElements", mode, count, type, reinterpret_cast<std::intptr_t>(indices));
+    }
+
+    void APIENTRY Enable(GLenum cap)
+    {
+        auto& caps = state.enabledCaps;
+        if (std::find(caps.begin(), caps.end(), cap) == caps.end())
+        {
+            caps.push_back(cap);
+        }
+        record(GLRecorder::Command::State, "glEnable", cap);
+    }
+
+    void APIENTRY EnableVertexAttribArray(GLuint index)
+    {
+        record(GLRecorder::Command::VertexAttrib, "glEnableVertexAttribArray", index);
+    }
+
+    GLsync APIENTRY FenceSync(GLenum condition, GLbitfield)
+    {
+        auto sync = reinterpret_cast<GLsync>(static_cast<std::intptr_t>(state.nextSync++));
+        record(GLRecorder::Command::Resource, "glFenceSync", condition, reinterpret_cast<std::intptr_t>(sync));
+        return sync;
+    }
+
+    void APIENTRY Finish()
+    {
+        record(GLRecorder::Command::State, "glFinish");
+    }
+
+    void APIENTRY Flush()
+    {
+        record(GLRecorder::Command::State, "glFlush");
+    }
+
+    void APIENTRY FramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbufferTarget, GLuint renderbuffer)
+    {
+        record(GLRecorder::Command::Resource, "glFramebufferRenderbuffer", target, attachment, renderbufferTarget, renderbuffer);
+    }
+
+    void APIENTRY FramebufferTexture2D(GLenum target, GLenum attachment, GLenum, GLuint texture, GLint level)
+    {
+        record(GLRecorder::Command::Resource, "glFramebufferTexture2D", target, attachment, texture, level);
+    }
+
+    void APIENTRY GenBuffers(GLsizei n, GLuint* buffers)
+    {
+        generate(n, buffers);
+        record(GLRecorder::Command::Resource, "glGenBuffers", n, firstID(n, buffers));
+    }
+
+    void APIENTRY GenerateMipmap(GLenum target)
+    {
+        record(GLRecorder::Command::Resource, "glGenerateMipmap", target);
+    }
+
+    void APIENTRY GenFramebuffers(GLsizei n, GLuint* framebuffers)
+    {
+        generate(n, framebuffers);
+        record(GLRecorder::Command::Resource, "glGenFramebuffers", n, firstID(n, framebuffers));
+    }
+
+    void APIENTRY GenRenderbuffers(GLsizei n, GLuint* renderbuffers)
+    {
+        generate(n, renderbuffers);
+        record(GLRecorder::Command::Resource, "glGenRenderbuffers", n, firstID(n, renderbuffers));
+    }
+
+    void APIENTRY GenTextures(GLsizei n, GLuint* textures)
+    {
+        generate(n, textures);
+        record(GLRecorder::Command::Resource, "glGenTextures", n, firstID(n, textures));
+    }
+
+    void APIENTRY GenVertexArrays(GLsizei n, GLuint* arrays)
+    {
+        generate(n, arrays);
+        record(GLRecorder::Command::Resource, "glGenVertexArrays", n, firstID(n, arrays));
+    }
+
+    void APIENTRY GetActiveAttrib(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+    {
+        getActive(program, index, bufSize, length, size, type, name, false);
+        record(GLRecorder::Command::Query, "glGetActiveAttrib", program, index);
+    }
+
+    void APIENTRY GetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+    {
+        getActive(program, index, bufSize, length, size, type, name, true);
+        record(GLRecorder::Command::Query, "glGetActiveUniform", program, index);
+    }
+
+    GLint APIENTRY GetAttribLocation(GLuint program, const GLchar* name)
+    {
+        record(GLRecorder::Command::Query, "glGetAttribLocation", program);
+        return findLocation(program, name, false);
+    }
+
+    GLenum APIENTRY GetError()
+    {
+        return GL_NO_ERROR;
+    }
+
+    void APIENTRY GetFloatv(GLenum pname, GLfloat* data)
+    {
+        switch (pname)
+        {
+        default:
+            data[0] = 0.f;
+            break;
+        case GL_COLOR_CLEAR_VALUE:
+            std::copy(state.clearColour.begin(), state.clearColour.end(), data);
+            break;
+        }
+        record(GLRecorder::Command::Query, "glGetFloatv", pname);
+    }
+
+    void APIENTRY GetIntegerv(GLenum pname, GLint* data)
+    {
+        switch (pname)
+        {
+        default:
+            data[0] = 0;
+            break;
+        case GL_VIEWPORT:
+            std::copy(state.viewport.begin(), state.viewport.end(), data);
+            break;
+        case GL_SCISSOR_BOX:
+            std::copy(state.scissor.begin(), state.scissor.end(), data);
+            break;
+        case GL_CURRENT_PROGRAM:
+            data[0] = state.program;
+            break;
+        case GL_ARRAY_BUFFER_BINDING:
+            data[0] = state.arrayBuffer;
+            break;
+        case GL_ELEMENT_ARRAY_BUFFER_BINDING:
+            data[0] = state.elementBuffer;
+            break;
+        case GL_FRAMEBUFFER_BINDING:
+            data[0] = state.framebuffer;
+            break;
+        case GL_TEXTURE_BINDING_2D:
+            data[0] = state.textures[state.activeUnit];
+            break;
+        case GL_ACTIVE_TEXTURE:
+            data[0] = static_cast<GLint>(GL_TEXTURE0 + state.activeUnit);
+            break;
+        case GL_MAX_TEXTURE_SIZE:
+            data[0] = 4096;
+            break;
+        case GL_MAX_TEXTURE_IMAGE_UNITS:
+        case GL_MAX_VERTEX_ATTRIBS:
+            data[0] = 16;
+            break;
+        case GL_MAX_VERTEX_UNIFORM_VECTORS:
+            //renderers size their batches and bone arrays from this
+            data[0] = 1024;
+            break;
+        }
+        record(GLRecorder::Command::Query, "glGetIntegerv", pname);
+    }
+
+    void APIENTRY GetProgramInfoLog(GLuint, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+    {
+        if (length) *length = 0;
+        if (bufSize > 0) infoLog[0] = 0;
+    }
+
+    void APIENTRY GetProgramiv(GLuint program, GLenum pname, GLint* params)
+    {
+        auto result = state.programs.find(program);
+        switch (pname)
+        {
+        default:
+            params[0] = 0;
+            break;
+        case GL_LINK_STATUS:
+        case GL_VALIDATE_STATUS:
+            params[0] = GL_TRUE;
+            break;
+        case GL_ACTIVE_ATTRIBUTES:
+            params[0] = result == state.programs.end() ? 0 : static_cast<GLint>(result->second.attributes.size());
+            break;
+        case GL_ACTIVE_UNIFORMS:
+            params[0] = result == state.programs.end() ? 0 : static_cast<GLint>(result->second.uniforms.size());
+            break;
+        case GL_ACTIVE_ATTRIBUTE_MAX_LENGTH:
+        case GL_ACTIVE_UNIFORM_MAX_LENGTH:
+            params[0] = 0;
+            if (result != state.programs.end())
+            {
+                const auto& vars = (pname == GL_ACTIVE_UNIFORM_MAX_LENGTH) ? result->second.uniforms : result->second.attributes;
+                for (const auto& v : vars)
+                {
+                    params[0] = std::max(params[0], static_cast<GLint>(v.name.size() + 1));
+                }
+            }
+            break;
+        }
+        record(GLRecorder::Command::Query, "glGetProgramiv", program, pname);
+    }
+
+    void APIENTRY GetShaderInfoLog(GLuint, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+    {
+        if (length) *length = 0;
+        if (bufSize > 0) infoLog[0] = 0;
+    }
+
+    void APIENTRY GetShaderiv(GLuint shader, GLenum pname, GLint* params)
+    {
+        params[0] = (pname == GL_COMPILE_STATUS) ? GL_TRUE : 0;
+        record(GLRecorder::Command::Query, "glGetShaderiv", shader, pname);
+    }
+
+    GLint APIENTRY GetUniformLocation(GLuint program, const GLchar* name)
+    {
+        record(GLRecorder::Command::Query, "glGetUniformLocation", program);
+        return findLocation(program, name, true);
+    }
+
+    GLboolean APIENTRY IsEnabled(GLenum cap)
+    {
+        const auto& caps = state.enabledCaps;
+        record(GLRecorder::Command::Query, "glIsEnabled", cap);
+        return std::find(caps.begin(), caps.end(), cap) == caps.end() ? GL_FALSE : GL_TRUE;
+    }
+
+    void APIENTRY LinkProgram(GLuint program)
+    {
+        auto& prog = state.programs[program];
+        prog.attributes.clear();
+        prog.uniforms.clear();
+        for (auto shader : prog.shaders)
+        {
+            const auto& src = state.shaderSources[shader];
+            parseVariables(src, "attribute", prog.attributes);
+            parseVariables(src, "uniform", prog.uniforms);
+        }
+        record(GLRecorder::Command::Resource, "glLinkProgram", program);
+    }
+
+    void* APIENTRY MapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+    {
+        //mapped data is written to scratch memory and counted when unmapped
+        state.mappedBuffer.resize(static_cast<std::size_t>(length));
+        record(GLRecorder::Command::State, "glMapBufferRange", target, offset, length, access);
+        return state.mappedBuffer.data();
+    }
+
+    void APIENTRY PixelStorei(GLenum pname, GLint param)
+    {
+        record(GLRecorder::Command::State, "glPixelStorei", pname, param);
+    }
+
+    void APIENTRY RenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height)
+    {
+        record(GLRecorder::Command::Resource, "glRenderbufferStorage", target, internalformat, width, height);
+    }
+
+    void APIENTRY Scissor(GLint x, GLint y, GLsizei width, GLsizei height)
+    {
+        state.scissor = { {x, y, width, height} };
+        record(GLRecorder::Command::State, "glScissor", x, y, width, height);
+    }
+
+    void APIENTRY ShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length)
+    {
+        auto& src = state.shaderSources[shader];
+        src.clear();
+        for (auto i = 0; i < count; ++i)
+        {
+            if (length && length[i] >= 0)
+            {
+                src.append(string[i], length[i]);
+            }
+            else
+            {
+                src.append(string[i]);
+            }
+        }
+        record(GLRecorder::Command::Resource, "glShaderSource", shader, count);
+    }
+
+    void APIENTRY TexImage2D(GLenum target, GLint level, GLint, GLsizei width, GLsizei height, GLint, GLenum format, GLenum type, const void* pixels)
+    {
+        auto bytes = pixels ? static_cast<std::size_t>(width) * height * pixelSize(format, type) : 0;
+        record(GLRecorder::Command::Upload, "glTexImage2D", target, level, width, height, bytes);
+    }
+
+    void APIENTRY TexParameteri(GLenum target, GLenum pname, GLint param)
+    {
+        record(GLRecorder::Command::State, "glTexParameteri", target, pname, param);
+    }
+
+    void APIENTRY TexSubImage2D(GLenum target, GLint level, GLint, GLint, GLsizei width, GLsizei height, GLenum format, GLenum type, const void*)
+    {
+        auto bytes = static_cast<std::size_t>(width) * height * pixelSize(format, type);
+        record(GLRecorder::Command::Upload, "glTexSubImage2D", target, level, width, height, bytes);
+    }
+
+    void APIENTRY Uniform1f(GLint location, GLfloat)
+    {
+        record(GLRecorder::Command::Uniform, "glUniform1f", location, 1);
+    }
+
+    void APIENTRY Uniform1fv(GLint location, GLsizei count, const GLfloat*)
+    {
+        record(GLRecorder::Command::Uniform, "glUniform1fv", location, count);
+    }
+
+    void APIENTRY Uniform1i(GLint location, GLint)
+    {
+        record(GLRecorder::Command::Uniform, "glUniform1i", location, 1);
+    }
+
+    void APIENTRY Uniform1iv(GLint location, GLsizei count, const GLint*)
+    {
+        record(GLRecorder::Command::Uniform, "glUniform1iv", location, count);
+    }
+
+    void APIENTRY Uniform2f(GLint location, GLfloat, GLfloat)
+    {
+        record(GLRecorder::Command::Uniform, "glUniform2f", location, 1);
+    }
+
+    void APIENTRY Uniform2fv(GLint location, GLsizei count, const GLfloat*)
+    {
+        record(GLRecorder::Command::Uniform, "glUniform2fv", location, count);
+    }
+
+    void APIENTRY Uniform3f(GLint location, GLfloat, GLfloat, GLfloat)
+    {
+        record(GLRecorder::Command::Uniform, "glUniform3f", location, 1);
+    }
+
+    void APIENTRY Uniform3fv(GLint location, GLsizei count, const GLfloat*)
+    {
+        record(GLRecorder::Command::Uniform, "glUniform3fv", location, count);
+    }
+
+    void APIENTRY Uniform4f(GLint location, GLfloat, GLfloat, GLfloat, GLfloat)
+    {
+        record(GLRecorder::Command::Uniform, "glUniform4f", location, 1);
+    }
+
+    void APIENTRY Uniform4fv(GLint location, GLsizei count, const GLfloat*)
+    {
+        record(GLRecorder::Command::Uniform, "glUniform4fv", location, count);
+    }
+
+    void APIENTRY UniformMatrix3fv(GLint location, GLsizei count, GLboolean, const GLfloat*)
+    {
+        record(GLRecorder::Command::Uniform, "glUniformMatrix3fv", location, count);
+    }
+
+    void APIENTRY UniformMatrix4fv(GLint location, GLsizei count, GLboolean, const GLfloat*)
+    {
+        record(GLRecorder::Command::Uniform, "glUniformMatrix4fv", location, count);
+    }
+
+    GLboolean APIENTRY UnmapBuffer(GLenum target)
+    {
+        record(GLRecorder::Command::Upload, "glUnmapBuffer", target, 0, 0, 0, state.mappedBuffer.size());
+        state.mappedBuffer.clear();
+        return GL_TRUE;
+    }
+
+    void APIENTRY UseProgram(GLuint program)
+    {
+        bind(GLRecorder::Command::UseProgram, "glUseProgram", state.program, program);
+    }
+
+    void APIENTRY VertexAttribPointer(GLuint index, GLint size, GLenum, GLboolean, GLsizei stride, const void* pointer)
+    {
+        record(GLRecorder::Command::VertexAttrib, "glVertexAttribPointer", index, size, stride, reinterpret_cast<std::intptr_t>(pointer));
+    }
+
+    void APIENTRY Viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+    {
+        state.viewport = { {x, y, width, height} };
+        record(GLRecorder::Command::State, "glViewport", x, y, width, height);
+    }
+}
+
+void GLRecorder::install()
+{
+    if (state.installed)
+    {
+        return;
+    }
+
+#define X(fn) originals.fn = glad_gl##fn; glad_gl##fn = fn;
+    CRO_GL_RECORDER_FUNCTIONS
+#undef X
+
+    state.installed = true;
+    LOG("Installed GL recording backend", Logger::Type::Info);
+}
+
+void GLRecorder::uninstall()
+{
+    if (!state.installed)
+    {
+        return;
+    }
+
+#define X(fn) glad_gl##fn = originals.fn;
+    CRO_GL_RECORDER_FUNCTIONS
+#undef X
+
+    state = State();
+    LOG("Removed GL recording backend", Logger::Type::Info);
+}
+
+bool GLRecorder::isInstalled()
+{
+    return state.installed;
+}
+
+void GLRecorder::reset()
+{
+    state.commands.clear();
+    state.stats = {};
+}
+
+void GLRecorder::setCommandsEnabled(bool enabled)
+{
+    state.commandsEnabled = enabled;
+}
+
+const std::vector<GLRecorder::Command>& GLRecorder::getCommands()
+{
+    return state.commands;
+}
+
+const GLRecorder::Stats& GLRecorder::getStats()
+{
+    return state.stats;
+}
\ No newline at end of file
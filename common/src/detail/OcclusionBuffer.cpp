@@ -0,0 +1,297 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include <crogine/detail/OcclusionBuffer.hpp>
+
+#include "Simd.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace cro;
+using namespace cro::Detail;
+
+namespace
+{
+    const float ClearDepth = std::numeric_limits<float>::max();
+    const float MinW = 0.0001f; //anything closer than this is considered to cross the near plane
+
+    //coefficients of the function A*x + B*y + C which is positive
+    //to the left of the edge from p to q (when wound anti-clockwise)
+    struct EdgeFunction final
+    {
+        float a = 0.f;
+        float b = 0.f;
+        float c = 0.f;
+
+        EdgeFunction(glm::vec3 p, glm::vec3 q)
+            : a(p.y - q.y), b(q.x - p.x), c(p.x * q.y - p.y * q.x) {}
+    };
+}
+
+OcclusionBuffer::OcclusionBuffer(uint32 width, uint32 height)
+    : m_width   (std::max(8u, ((width + 7) / 8) * 8)),
+    m_height    (std::max(1u, height)),
+    m_depth     (m_width * m_height, ClearDepth),
+    m_empty     (true)
+{
+
+}
+
+//public
+void OcclusionBuffer::clear(const glm::mat4& viewProjection)
+{
+    std::fill(m_depth.begin(), m_depth.end(), ClearDepth);
+    m_viewProjection = viewProjection;
+    m_empty = true;
+}
+
+void OcclusionBuffer::rasterise(const glm::mat4& worldMatrix, const std::vector<glm::vec3>& vertices, const std::vector<uint16>& indices)
+{
+    const auto matrix = m_viewProjection * worldMatrix;
+    const glm::vec2 halfSize(static_cast<float>(m_width) / 2.f, static_cast<float>(m_height) / 2.f);
+
+    //transform to screen space once, storing w so that vertices
+    //behind the near plane can be found when building triangles
+    m_transformedVertices.resize(vertices.size());
+    for (auto i = 0u; i < vertices.size(); ++i)
+    {
+        auto clip = matrix * glm::vec4(vertices[i], 1.f);
+        if (clip.w > MinW)
+        {
+            m_transformedVertices[i] =
+            {
+                (clip.x / clip.w) * halfSize.x + halfSize.x,
+                (clip.y / clip.w) * halfSize.y + halfSize.y,
+                clip.z / clip.w,
+                clip.w
+            };
+        }
+        else
+        {
+            m_transformedVertices[i].w = 0.f;
+        }
+    }
+
+    for (auto i = 0u; i + 2 < indices.size(); i += 3)
+    {
+        const auto& a = m_transformedVertices[indices[i]];
+        const auto& b = m_transformedVertices[indices[i + 1]];
+        const auto& c = m_transformedVertices[indices[i + 2]];
+
+        //skipping triangles which cross the near plane rather than clipping
+        //them means occluding less, but never hides anything which is visible
+        if (a.w > 0.f && b.w > 0.f && c.w > 0.f)
+        {
+            rasteriseTriangle(glm::vec3(a), glm::vec3(b), glm::vec3(c));
+        }
+    }
+}
+
+bool OcclusionBuffer::isVisible(const Box& box) const
+{
+    if (m_empty)
+    {
+        return true;
+    }
+
+    //find the screen area and nearest depth of the box
+    glm::vec2 screenMin(std::numeric_limits<float>::max());
+    glm::vec2 screenMax(-std::numeric_limits<float>::max());
+    float nearest = std::numeric_limits<float>::max();
+
+    const glm::vec2 halfSize(static_cast<float>(m_width) / 2.f, static_cast<float>(m_height) / 2.f);
+    for (auto i = 0; i < 8; ++i)
+    {
+        const glm::vec4 corner((i & 1) ? box[1].x : box[0].x, (i & 2) ? box[1].y : box[0].y, (i & 4) ? box[1].z : box[0].z, 1.f);
+        const auto clip = m_viewProjection * corner;
+        if (clip.w <= MinW)
+        {
+            //crosses the near plane so assume we can see it
+            return true;
+        }
+
+        const glm::vec2 screen = (glm::vec2(clip) / clip.w) * halfSize + halfSize;
+        screenMin = glm::min(screenMin, screen);
+        screenMax = glm::max(screenMax, screen);
+        nearest = std::min(nearest, clip.z / clip.w);
+    }
+
+    const auto left = std::max(0, static_cast<int32>(std::floor(screenMin.x)));
+    const auto right = std::min(static_cast<int32>(m_width) - 1, static_cast<int32>(std::floor(screenMax.x)));
+    const auto bottom = std::max(0, static_cast<int32>(std::floor(screenMin.y)));
+    const auto top = std::min(static_cast<int32>(m_height) - 1, static_cast<int32>(std::floor(screenMax.y)));
+
+    if (left > right || bottom > top)
+    {
+        return true;
+    }
+
+    //visible if any pixel in the area has an occluder further away than the box
+#ifdef CRO_SIMD
+    using namespace Simd;
+    const Vec boxDepth = splat(nearest);
+    const Vec first = splat(static_cast<float>(left));
+    const Vec last = splat(static_cast<float>(right + 1));
+    const auto start = (left / Width) * Width;
+
+    for (auto y = bottom; y <= top; ++y)
+    {
+        const float* row = &m_depth[y * m_width];
+        for (auto x = start; x <= static_cast<std::size_t>(right); x += Width)
+        {
+            const Vec px = add(splat(static_cast<float>(x)), ramp());
+            const Mask inside = logicalAnd(greaterEqual(px, first), less(px, last));
+            if (any(logicalAnd(inside, greaterEqual(load(row + x), boxDepth))))
+            {
+                return true;
+            }
+        }
+    }
+#else
+    for (auto y = bottom; y <= top; ++y)
+    {
+        const float* row = &m_depth[y * m_width];
+        for (auto x = left; x <= right; ++x)
+        {
+            if (row[x] >= nearest)
+            {
+                return true;
+            }
+        }
+    }
+#endif
+    return false;
+}
+
+//private
+void OcclusionBuffer::rasteriseTriangle(glm::vec3 a, glm::vec3 b, glm::vec3 c)
+{
+    float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    if (area == 0.f)
+    {
+        return;
+    }
+
+    //occluders are double sided, so make sure the winding is consistent
+    if (area < 0.f)
+    {
+        std::swap(b, c);
+        area = -area;
+    }
+
+    const auto left = std::max(0, static_cast<int32>(std::floor(std::min(a.x, std::min(b.x, c.x)))));
+    const auto right = std::min(static_cast<int32>(m_width) - 1, static_cast<int32>(std::floor(std::max(a.x, std::max(b.x, c.x)))));
+    const auto bottom = std::max(0, static_cast<int32>(std::floor(std::min(a.y, std::min(b.y, c.y)))));
+    const auto top = std::min(static_cast<int32>(m_height) - 1, static_cast<int32>(std::floor(std::max(a.y, std::max(b.y, c.y)))));
+
+    if (left > right || bottom > top)
+    {
+        return;
+    }
+
+    m_empty = false;
+
+    //each edge function is the barycentric weight of the opposite vertex
+    const EdgeFunction e0(b, c);
+    const EdgeFunction e1(c, a);
+    const EdgeFunction e2(a, b);
+
+    //depth is linear in screen space so can be written as a plane equation too
+    const float zx = (e0.a * a.z + e1.a * b.z + e2.a * c.z) / area;
+    const float zy = (e0.b * a.z + e1.b * b.z + e2.b * c.z) / area;
+    const float zc = (e0.c * a.z + e1.c * b.z + e2.c * c.z) / area;
+
+    //to stay conservative only pixels which are completely covered by the
+    //triangle are written, and they are written with the farthest depth of
+    //the triangle within the pixel. Both are found by evaluating the functions
+    //at the pixel centre, offset by half the gradient towards the worst corner
+    const float offset0 = (std::abs(e0.a) + std::abs(e0.b)) / 2.f;
+    const float offset1 = (std::abs(e1.a) + std::abs(e1.b)) / 2.f;
+    const float offset2 = (std::abs(e2.a) + std::abs(e2.b)) / 2.f;
+    const float offsetZ = (std::abs(zx) + std::abs(zy)) / 2.f;
+
+#ifdef CRO_SIMD
+    using namespace Simd;
+    const Vec e0a = splat(e0.a);
+    const Vec e1a = splat(e1.a);
+    const Vec e2a = splat(e2.a);
+    const Vec zxv = splat(zx);
+    const Vec zero = splat(0.f);
+    const Vec centre = add(ramp(), splat(0.5f));
+
+    //width is a multiple of the SIMD width so aligning the start
+    //never reads past the end of a row. Extra pixels either side
+    //are outside the triangle's bounds so they fail the edge tests
+    const auto start = (left / Width) * Width;
+
+    for (auto y = bottom; y <= top; ++y)
+    {
+        const float py = static_cast<float>(y) + 0.5f;
+        const Vec row0 = splat(e0.b * py + e0.c - offset0);
+        const Vec row1 = splat(e1.b * py + e1.c - offset1);
+        const Vec row2 = splat(e2.b * py + e2.c - offset2);
+        const Vec rowZ = splat(zy * py + zc + offsetZ);
+
+        float* row = &m_depth[y * m_width];
+        for (auto x = start; x <= static_cast<std::size_t>(right); x += Width)
+        {
+            const Vec px = add(splat(static_cast<float>(x)), centre);
+
+            Mask mask = greaterEqual(add(mul(e0a, px), row0), zero);
+            mask = logicalAnd(mask, greaterEqual(add(mul(e1a, px), row1), zero));
+            mask = logicalAnd(mask, greaterEqual(add(mul(e2a, px), row2), zero));
+
+            if (any(mask))
+            {
+                const Vec depth = add(mul(zxv, px), rowZ);
+                const Vec current = load(row + x);
+                store(row + x, select(mask, min(current, depth), current));
+            }
+        }
+    }
+#else
+    for (auto y = bottom; y <= top; ++y)
+    {
+        const float py = static_cast<float>(y) + 0.5f;
+        float* row = &m_depth[y * m_width];
+        for (auto x = left; x <= right; ++x)
+        {
+            const float px = static_cast<float>(x) + 0.5f;
+            if (e0.a * px + e0.b * py + e0.c >= offset0
+                && e1.a * px + e1.b * py + e1.c >= offset1
+                && e2.a * px + e2.b * py + e2.c >= offset2)
+            {
+                row[x] = std::min(row[x], zx * px + zy * py + zc + offsetZ);
+            }
+        }
+    }
+#endif
+}
@@ -0,0 +1,122 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include "ParticlePool.hpp"
+
+#include <crogine/detail/Assert.hpp>
+
+#include <algorithm>
+
+using namespace cro;
+using namespace cro::Detail;
+
+//public
+ParticlePool::Block ParticlePool::allocate(std::size_t count)
+{
+    CRO_ASSERT(count > 0, "");
+
+    Block block;
+    auto sizeClass = getSizeClass(count);
+    if (sizeClass < SizeClassCount)
+    {
+        block.stride = MinStride << sizeClass;
+
+        auto& pool = get();
+        std::lock_guard<std::mutex> lock(pool.m_mutex);
+        auto& freeBlocks = pool.m_freeBlocks[sizeClass];
+        if (!freeBlocks.empty())
+        {
+            block.data = freeBlocks.back().release();
+            freeBlocks.pop_back();
+            return block;
+        }
+    }
+    else
+    {
+        //too big to be worth keeping around
+        block.stride = count;
+    }
+
+    block.data = new float[block.stride * ArrayCount];
+    return block;
+}
+
+void ParticlePool::free(Block block)
+{
+    if (!block.data)
+    {
+        return;
+    }
+
+    auto sizeClass = getSizeClass(block.stride);
+    if (sizeClass < SizeClassCount
+        && (MinStride << sizeClass) == block.stride)
+    {
+        const auto blockBytes = block.stride * ArrayCount * sizeof(float);
+        const auto maxBlocks = std::max(std::size_t(1), MaxFreeBytes / blockBytes);
+
+        auto& pool = get();
+        std::lock_guard<std::mutex> lock(pool.m_mutex);
+        auto& freeBlocks = pool.m_freeBlocks[sizeClass];
+        if (freeBlocks.size() < maxBlocks)
+        {
+            freeBlocks.emplace_back(block.data);
+            return;
+        }
+    }
+    delete[] block.data;
+}
+
+void ParticlePool::trim()
+{
+    auto& pool = get();
+    std::lock_guard<std::mutex> lock(pool.m_mutex);
+    for (auto& freeBlocks : pool.m_freeBlocks)
+    {
+        freeBlocks.clear();
+        freeBlocks.shrink_to_fit();
+    }
+}
+
+//private
+ParticlePool& ParticlePool::get()
+{
+    static ParticlePool pool;
+    return pool;
+}
+
+std::size_t ParticlePool::getSizeClass(std::size_t count)
+{
+    std::size_t sizeClass = 0;
+    while (sizeClass < SizeClassCount && (MinStride << sizeClass) < count)
+    {
+        sizeClass++;
+    }
+    return sizeClass;
+}
\ No newline at end of file
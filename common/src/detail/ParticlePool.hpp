@@ -0,0 +1,101 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#ifndef CRO_PARTICLE_POOL_HPP_
+#define CRO_PARTICLE_POOL_HPP_
+
+#include <crogine/Config.hpp>
+#include <crogine/detail/Types.hpp>
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace cro
+{
+    namespace Detail
+    {
+        /*!
+        \brief Shared storage for particle data.
+        Emitters request blocks large enough for their capacity, which are
+        rounded up to a power of two number of particles. Freed blocks are
+        kept and reused by the next emitter requesting the same size class,
+        so that emitters which are frequently created and destroyed, or
+        held unused in component pools, don't repeatedly allocate memory.
+        The memory kept by each size class is capped, and all free blocks
+        are released with trim() when states are popped or cleared.
+        Blocks may be allocated and freed from any thread.
+        */
+        class ParticlePool final
+        {
+        public:
+            //number of floats stored per particle, one array for each
+            static constexpr std::size_t ArrayCount = 14;
+
+            struct Block final
+            {
+                float* data = nullptr; //< ArrayCount arrays of stride floats
+                std::size_t stride = 0;
+            };
+
+            /*!
+            \brief Returns a block with room for at least the given
+            number of particles. count must be greater than zero.
+            */
+            static Block allocate(std::size_t count);
+
+            /*!
+            \brief Returns a block to the pool for reuse
+            */
+            static void free(Block);
+
+            /*!
+            \brief Releases all the free blocks held by the pool.
+            Blocks currently in use are unaffected.
+            */
+            static void trim();
+
+        private:
+            //blocks of MinStride particles up to MinStride << (SizeClassCount - 1)
+            static constexpr std::size_t MinStride = 64;
+            static constexpr std::size_t SizeClassCount = 16;
+            //free memory kept per size class - at least one block is always kept
+            static constexpr std::size_t MaxFreeBytes = 4 * 1024 * 1024;
+
+            std::mutex m_mutex;
+            std::array<std::vector<std::unique_ptr<float[]>>, SizeClassCount> m_freeBlocks;
+
+            static ParticlePool& get();
+            static std::size_t getSizeClass(std::size_t);
+        };
+    }
+}
+
+#endif //CRO_PARTICLE_POOL_HPP_
\ No newline at end of file
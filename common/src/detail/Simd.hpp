@@ -0,0 +1,177 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+//thin wrappers around SSE, AVX and NEON intrinsics so that
+//SIMD kernels only need to be written once. Only include
+//this in source files, never in public headers.
+
+#ifndef CRO_SIMD_HPP_
+#define CRO_SIMD_HPP_
+
+#include <crogine/detail/Types.hpp>
+
+#if defined(__AVX__)
+#define CRO_SIMD_AVX 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CRO_SIMD_SSE 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define CRO_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(CRO_SIMD_AVX) || defined(CRO_SIMD_SSE) || defined(CRO_SIMD_NEON)
+#define CRO_SIMD 1
+#endif
+
+#ifdef CRO_SIMD
+namespace cro
+{
+    namespace Detail
+    {
+        namespace Simd
+        {
+#if defined(CRO_SIMD_AVX)
+            using Vec = __m256;
+            using Mask = __m256;
+            const std::size_t Width = 8;
+
+            inline Vec load(const float* f) { return _mm256_loadu_ps(f); }
+            inline void store(float* dst, Vec v) { _mm256_storeu_ps(dst, v); }
+            inline Vec splat(float f) { return _mm256_set1_ps(f); }
+            inline Vec ramp() { return _mm256_set_ps(7.f, 6.f, 5.f, 4.f, 3.f, 2.f, 1.f, 0.f); }
+            inline Vec add(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+            inline Vec sub(Vec a, Vec b) { return _mm256_sub_ps(a, b); }
+            inline Vec mul(Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+            inline Vec min(Vec a, Vec b) { return _mm256_min_ps(a, b); }
+            inline Vec max(Vec a, Vec b) { return _mm256_max_ps(a, b); }
+            inline Vec negate(Vec a) { return _mm256_sub_ps(_mm256_setzero_ps(), a); }
+            inline Vec sqrt(Vec a) { return _mm256_sqrt_ps(a); }
+            inline Mask greaterEqual(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+            inline Mask less(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+            inline Mask logicalAnd(Mask a, Mask b) { return _mm256_and_ps(a, b); }
+            inline Mask logicalOr(Mask a, Mask b) { return _mm256_or_ps(a, b); }
+            inline Mask allTrue() { return _mm256_castsi256_ps(_mm256_set1_epi32(-1)); }
+            inline Vec select(Mask m, Vec a, Vec b) { return _mm256_blendv_ps(b, a, m); }
+            inline bool any(Mask m) { return _mm256_movemask_ps(m) != 0; }
+            inline void storeMask(Mask mask, uint8* dst)
+            {
+                const int bits = _mm256_movemask_ps(mask);
+                for (auto i = 0u; i < Width; ++i)
+                {
+                    dst[i] = static_cast<uint8>((bits >> i) & 1);
+                }
+            }
+#elif defined(CRO_SIMD_SSE)
+            using Vec = __m128;
+            using Mask = __m128;
+            const std::size_t Width = 4;
+
+            inline Vec load(const float* f) { return _mm_loadu_ps(f); }
+            inline void store(float* dst, Vec v) { _mm_storeu_ps(dst, v); }
+            inline Vec splat(float f) { return _mm_set1_ps(f); }
+            inline Vec ramp() { return _mm_set_ps(3.f, 2.f, 1.f, 0.f); }
+            inline Vec add(Vec a, Vec b) { return _mm_add_ps(a, b); }
+            inline Vec sub(Vec a, Vec b) { return _mm_sub_ps(a, b); }
+            inline Vec mul(Vec a, Vec b) { return _mm_mul_ps(a, b); }
+            inline Vec min(Vec a, Vec b) { return _mm_min_ps(a, b); }
+            inline Vec max(Vec a, Vec b) { return _mm_max_ps(a, b); }
+            inline Vec negate(Vec a) { return _mm_sub_ps(_mm_setzero_ps(), a); }
+            inline Vec sqrt(Vec a) { return _mm_sqrt_ps(a); }
+            inline Mask greaterEqual(Vec a, Vec b) { return _mm_cmpge_ps(a, b); }
+            inline Mask less(Vec a, Vec b) { return _mm_cmplt_ps(a, b); }
+            inline Mask logicalAnd(Mask a, Mask b) { return _mm_and_ps(a, b); }
+            inline Mask logicalOr(Mask a, Mask b) { return _mm_or_ps(a, b); }
+            inline Mask allTrue() { return _mm_castsi128_ps(_mm_set1_epi32(-1)); }
+            inline Vec select(Mask m, Vec a, Vec b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+            inline bool any(Mask m) { return _mm_movemask_ps(m) != 0; }
+            inline void storeMask(Mask mask, uint8* dst)
+            {
+                const int bits = _mm_movemask_ps(mask);
+                dst[0] = static_cast<uint8>(bits & 1);
+                dst[1] = static_cast<uint8>((bits >> 1) & 1);
+                dst[2] = static_cast<uint8>((bits >> 2) & 1);
+                dst[3] = static_cast<uint8>((bits >> 3) & 1);
+            }
+#elif defined(CRO_SIMD_NEON)
+            using Vec = float32x4_t;
+            using Mask = uint32x4_t;
+            const std::size_t Width = 4;
+
+            inline Vec load(const float* f) { return vld1q_f32(f); }
+            inline void store(float* dst, Vec v) { vst1q_f32(dst, v); }
+            inline Vec splat(float f) { return vdupq_n_f32(f); }
+            inline Vec ramp() { const float r[] = { 0.f, 1.f, 2.f, 3.f }; return vld1q_f32(r); }
+            inline Vec add(Vec a, Vec b) { return vaddq_f32(a, b); }
+            inline Vec sub(Vec a, Vec b) { return vsubq_f32(a, b); }
+            inline Vec mul(Vec a, Vec b) { return vmulq_f32(a, b); }
+            inline Vec min(Vec a, Vec b) { return vminq_f32(a, b); }
+            inline Vec max(Vec a, Vec b) { return vmaxq_f32(a, b); }
+            inline Vec negate(Vec a) { return vnegq_f32(a); }
+            inline Vec sqrt(Vec a)
+            {
+#if defined(__aarch64__)
+                return vsqrtq_f32(a);
+#else
+                //reciprocal square root estimate refined with two Newton-Raphson steps
+                Vec e = vrsqrteq_f32(a);
+                e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(a, e), e));
+                e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(a, e), e));
+                //sqrt(0) would otherwise be 0 * inf
+                return vbslq_f32(vceqq_f32(a, vdupq_n_f32(0.f)), a, vmulq_f32(a, e));
+#endif
+            }
+            inline Mask greaterEqual(Vec a, Vec b) { return vcgeq_f32(a, b); }
+            inline Mask less(Vec a, Vec b) { return vcltq_f32(a, b); }
+            inline Mask logicalAnd(Mask a, Mask b) { return vandq_u32(a, b); }
+            inline Mask logicalOr(Mask a, Mask b) { return vorrq_u32(a, b); }
+            inline Mask allTrue() { return vdupq_n_u32(0xffffffff); }
+            inline Vec select(Mask m, Vec a, Vec b) { return vbslq_f32(m, a, b); }
+            inline bool any(Mask m)
+            {
+                const uint32x2_t half = vorr_u32(vget_low_u32(m), vget_high_u32(m));
+                return (vget_lane_u32(half, 0) | vget_lane_u32(half, 1)) != 0;
+            }
+            inline void storeMask(Mask mask, uint8* dst)
+            {
+                uint32 result[4];
+                vst1q_u32(result, mask);
+                dst[0] = static_cast<uint8>(result[0] & 1);
+                dst[1] = static_cast<uint8>(result[1] & 1);
+                dst[2] = static_cast<uint8>(result[2] & 1);
+                dst[3] = static_cast<uint8>(result[3] & 1);
+            }
+#endif
+        }
+    }
+}
+#endif //CRO_SIMD
+
+#endif //CRO_SIMD_HPP_
@@ -260,59 +260,5 @@ void Scene::updateFrustum()
     auto viewProj = camComponent.projection
         * glm::inverse(activeCamera.getComponent<Transform>().getWorldTransform());
 
-    camComponent.m_frustum =
-    {
-        { Plane //left
-        (
-            viewProj[0][3] + viewProj[0][0],
-            viewProj[1][3] + viewProj[1][0],
-            viewProj[2][3] + viewProj[2][0],
-            viewProj[3][3] + viewProj[3][0]
-        ),
-        Plane //right
-        (
-            viewProj[0][3] - viewProj[0][0],
-            viewProj[1][3] - viewProj[1][0],
-            viewProj[2][3] - viewProj[2][0],
-            viewProj[3][3] - viewProj[3][0]
-        ),
-        Plane //bottom
-        (
-            viewProj[0][3] + viewProj[0][1],
-            viewProj[1][3] + viewProj[1][1],
-            viewProj[2][3] + viewProj[2][1],
-            viewProj[3][3] + viewProj[3][1]
-        ),
-        Plane //top
-        (
-            viewProj[0][3] - viewProj[0][1],
-            viewProj[1][3] - viewProj[1][1],
-            viewProj[2][3] - viewProj[2][1],
-            viewProj[3][3] - viewProj[3][1]
-        ),
-        Plane //near
-        (
-            viewProj[0][3] + viewProj[0][2],
-            viewProj[1][3] + viewProj[1][2],
-            viewProj[2][3] + viewProj[2][2],
-            viewProj[3][3] + viewProj[3][2]
-        ),
-        Plane //far
-        (
-            viewProj[0][3] - viewProj[0][2],
-            viewProj[1][3] - viewProj[1][2],
-            viewProj[2][3] - viewProj[2][2],
-            viewProj[3][3] - viewProj[3][2]
-        ) }
-    };
-
-    //normalise the planes
-    for (auto& p : camComponent.m_frustum)
-    {
-        const float factor = 1.f / std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
-        p.x *= factor;
-        p.y *= factor;
-        p.z *= factor;
-        p.w *= factor;
-    }
+    camComponent.m_frustum = Spatial::getFrustum(viewProj);
 }
\ No newline at end of file
@@ -36,9 +36,10 @@ source distribution.
 using namespace cro;
 
 Sunlight::Sunlight()
-    : m_colour  (1.f, 1.f, 1.f),
-    m_direction (0.f, -1.f, 0.f),
-    m_textureID (0)
+    : m_colour      (1.f, 1.f, 1.f),
+    m_direction     (0.f, -1.f, 0.f),
+    m_textureID     (0),
+    m_cascadeCount  (1)
 {
     //m_projection = glm::perspective(0.52f, 1.f, 0.1f, 100.f);
     m_projection = glm::ortho(-0.6f, 0.6f, -0.6f, 0.6f, 0.1f, 10.f);
@@ -85,6 +86,7 @@ const glm::mat4& Sunlight::getProjectionMatrix() const
 void Sunlight::setViewProjectionMatrix(const glm::mat4& mat)
 {
     m_viewProjection = mat;
+    m_cascadeMatrices[0] = mat;
 }
 
 const glm::mat4& Sunlight::getViewProjectionMatrix() const
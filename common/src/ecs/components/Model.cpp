@@ -68,7 +68,68 @@ void Model::setShadowMaterial(std::size_t idx, Material::Data material)
     m_shadowMaterials[idx] = material;
 }
 
+void Model::addLevelOfDetail(const Mesh::Data& mesh, float distance, float screenSize)
+{
+    CRO_ASSERT(mesh.attributes == m_meshData.attributes, "LOD meshes must have the same vertex attributes as the model");
+    CRO_ASSERT(mesh.submeshCount == m_meshData.submeshCount, "LOD meshes must have the same number of sub-meshes as the model");
+    CRO_ASSERT(distance >= 0 && screenSize >= 0, "Must be positive values");
+
+    if (m_levelsOfDetail.empty())
+    {
+        LevelOfDetail original;
+        original.meshData = m_meshData;
+        m_levelsOfDetail.push_back(original);
+    }
+
+    LevelOfDetail level;
+    level.meshData = mesh;
+    level.distance = distance;
+    level.screenSize = screenSize;
+    m_levelsOfDetail.push_back(level);
+}
+
+void Model::setLevelOfDetailHysteresis(float amount)
+{
+    CRO_ASSERT(amount >= 0 && amount < 1, "Must be in the range 0 - 1");
+    m_lodHysteresis = amount;
+}
+
 //private
+void Model::updateLevelOfDetail(float distance, float radiusScale)
+{
+    //radiusScale is the bounding sphere radius multiplied by the projection's
+    //y scale, so dividing it by a screen size gives the equivalent distance
+    auto switchDistance = [&](std::size_t level)
+    {
+        const auto& lod = m_levelsOfDetail[level];
+        return (lod.screenSize > 0) ? radiusScale / lod.screenSize : lod.distance;
+    };
+
+    //the camera has to pass the switch distance by a margin before
+    //changing level so models don't flicker between the two
+    auto level = m_currentLevelOfDetail;
+    while (level + 1 < m_levelsOfDetail.size()
+        && distance > switchDistance(level + 1) * (1.f + m_lodHysteresis))
+    {
+        level++;
+    }
+
+    while (level > 0
+        && distance < switchDistance(level) * (1.f - m_lodHysteresis))
+    {
+        level--;
+    }
+
+    if (level != m_currentLevelOfDetail)
+    {
+        //store any changes made to the current level via getMeshData()
+        m_levelsOfDetail[m_currentLevelOfDetail].meshData = m_meshData;
+
+        m_currentLevelOfDetail = level;
+        m_meshData = m_levelsOfDetail[level].meshData;
+    }
+}
+
 void Model::bindMaterial(Material::Data& material)
 {
     //map attributes to material
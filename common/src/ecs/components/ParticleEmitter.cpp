@@ -31,13 +31,21 @@ source distribution.
 
 #include <crogine/graphics/TextureResource.hpp>
 #include <crogine/core/ConfigFile.hpp>
+#include <crogine/util/Random.hpp>
+
+#include "../../detail/ParticlePool.hpp"
+
+#include <cstring>
 
 using namespace cro;
 
 ParticleEmitter::ParticleEmitter()
-    : m_vbo             (0),
-    m_nextFreeParticle  (0),
-    m_running           (false)
+    : m_nextFreeParticle    (0),
+    m_running               (false),
+    m_emissionTime          (0.f),
+    m_pendingBurst          (0),
+    m_hasPreviousPosition   (false),
+    m_randomEngine          (Util::Random::rndEngine())
 {
 
 }
@@ -52,6 +60,10 @@ ParticleEmitter::ParticleEmitter()
 
 void ParticleEmitter::start()
 {
+    if (!m_running)
+    {
+        m_emissionTime = 0.f;
+    }
     m_running = true;
 }
 
@@ -60,6 +72,16 @@ void ParticleEmitter::stop()
     m_running = false;
 }
 
+void ParticleEmitter::burst(uint32 count)
+{
+    m_pendingBurst += count;
+}
+
+void ParticleEmitter::setRandomSeed(uint32 seed)
+{
+    m_randomEngine.seed(seed);
+}
+
 bool EmitterSettings::loadFromFile(const std::string& path, cro::TextureResource& textures)
 {
     ConfigFile cfg;
@@ -132,6 +154,10 @@ bool EmitterSettings::loadFromFile(const std::string& path, cro::TextureResource
             {
                 spawnRadius = p.getValue<float>();
             }
+            else if (name == "max_particles")
+            {
+                maxParticles = static_cast<uint32>(std::max(0, p.getValue<int32>()));
+            }
         }
 
         const auto& objects = cfg.getObjects();
@@ -163,4 +189,109 @@ bool EmitterSettings::loadFromFile(const std::string& path, cro::TextureResource
     }
 
     return false;
+}
+
+//private
+ParticleEmitter::Particles::~Particles()
+{
+    Detail::ParticlePool::free({ m_data, m_stride });
+}
+
+ParticleEmitter::Particles::Particles(const Particles& other)
+{
+    *this = other;
+}
+
+ParticleEmitter::Particles::Particles(Particles&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+ParticleEmitter::Particles& ParticleEmitter::Particles::operator=(const Particles& other)
+{
+    if (&other != this)
+    {
+        //particles may not all be alive but copying them all is cheaper than tracking them
+        resize(other.capacity, 0);
+        for (auto i = 0u; i < Detail::ParticlePool::ArrayCount && capacity > 0; ++i)
+        {
+            std::memcpy(m_data + (i * m_stride), other.m_data + (i * other.m_stride), capacity * sizeof(float));
+        }
+    }
+    return *this;
+}
+
+ParticleEmitter::Particles& ParticleEmitter::Particles::operator=(Particles&& other) noexcept
+{
+    if (&other != this)
+    {
+        Detail::ParticlePool::free({ m_data, m_stride });
+        capacity = other.capacity;
+        assign(other.m_data, other.m_stride);
+
+        other.capacity = 0;
+        other.assign(nullptr, 0);
+    }
+    return *this;
+}
+
+void ParticleEmitter::Particles::resize(std::size_t newCapacity, std::size_t count)
+{
+    if (newCapacity == capacity)
+    {
+        return;
+    }
+
+    Detail::ParticlePool::Block block;
+    if (newCapacity > 0)
+    {
+        block = Detail::ParticlePool::allocate(newCapacity);
+
+        count = std::min(count, newCapacity);
+        for (auto i = 0u; i < Detail::ParticlePool::ArrayCount && count > 0; ++i)
+        {
+            std::memcpy(block.data + (i * block.stride), m_data + (i * m_stride), count * sizeof(float));
+        }
+    }
+
+    Detail::ParticlePool::free({ m_data, m_stride });
+    capacity = newCapacity;
+    assign(block.data, block.stride);
+}
+
+void ParticleEmitter::Particles::assign(float* data, std::size_t stride)
+{
+    m_data = data;
+    m_stride = stride;
+
+    std::array<float**, Detail::ParticlePool::ArrayCount> arrays =
+    {
+        &positionX, &positionY, &positionZ,
+        &velocityX, &velocityY, &velocityZ,
+        &lifetime, &inverseMaxLifetime,
+        &red, &green, &blue, &alpha,
+        &rotation, &scale
+    };
+    for (auto i = 0u; i < arrays.size(); ++i)
+    {
+        *arrays[i] = data ? data + (i * stride) : nullptr;
+    }
+}
+
+void ParticleEmitter::Particles::copy(std::size_t src, std::size_t dst)
+{
+    positionX[dst] = positionX[src];
+    positionY[dst] = positionY[src];
+    positionZ[dst] = positionZ[src];
+    velocityX[dst] = velocityX[src];
+    velocityY[dst] = velocityY[src];
+    velocityZ[dst] = velocityZ[src];
+    lifetime[dst] = lifetime[src];
+    inverseMaxLifetime[dst] = inverseMaxLifetime[src];
+    red[dst] = red[src];
+    green[dst] = green[src];
+    blue[dst] = blue[src];
+    alpha[dst] = alpha[src];
+    rotation[dst] = rotation[src];
+    scale[dst] = scale[src];
 }
\ No newline at end of file
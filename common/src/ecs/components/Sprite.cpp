@@ -35,7 +35,9 @@ using namespace cro;
 Sprite::Sprite()
     : m_textureID   (0),
     m_dirty         (true),
+    m_vbo           (0),
     m_vboOffset     (0),
+    m_batchTextureIndex(0),
     m_visible       (false),
     m_blendMode     (Material::BlendMode::Alpha),
     m_needsSorting  (false),
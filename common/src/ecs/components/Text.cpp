@@ -29,6 +29,7 @@ source distribution.
 
 #include <crogine/ecs/components/Text.hpp>
 #include <crogine/graphics/Font.hpp>
+#include <crogine/util/String.hpp>
 
 using namespace cro;
 
@@ -38,7 +39,11 @@ Text::Text()
     m_blendMode     (Material::BlendMode::Alpha),
     m_dirtyFlags    (Flags::Verts),
     m_scissor       (false),
+    m_vbo           (0),
     m_vboOffset     (0),
+    m_vertexCapacity(0),
+    m_transformIndex(0),
+    m_atlasGeneration(0),
     m_alignment     (Left)
 {
 
@@ -50,7 +55,11 @@ Text::Text(const Font& font)
     m_blendMode     (Material::BlendMode::Alpha),
     m_dirtyFlags    (Flags::Verts),
     m_scissor       (false),
+    m_vbo           (0),
     m_vboOffset     (0),
+    m_vertexCapacity(0),
+    m_transformIndex(0),
+    m_atlasGeneration(0),
     m_alignment     (Left)
 {
 
@@ -87,8 +96,6 @@ void Text::setBlendMode(Material::BlendMode mode)
 
 float Text::getLineHeight() const
 {
-    //TODO return height depending on whether or
-    //not the font is a bitmap or SDF
     CRO_ASSERT(m_font, "Font not loaded!");
     return m_font->getLineHeight(m_charSize);
 }
@@ -118,20 +125,23 @@ float Text::getLineWidth(std::size_t idx) const
 {
     CRO_ASSERT(m_font, "No font assigned!");
     
-    auto start = (idx) ? Util::String::findNthOf(m_string, '\n', idx) : 0;
-    if (start == std::string::npos)
-    {
-        return 0.f;
-    }
-
+    std::size_t line = 0;
     float width = 0.f;
-    for (auto i = start + 1; i < m_string.length(); ++i)
+    float scale = m_font->getScale(m_charSize);
+    for (auto c : Util::String::getCodepoints(m_string))
     {
-        if (m_string[i] == '\n')
+        if (c == '\n')
+        {
+            if (line == idx)
+            {
+                break;
+            }
+            line++;
+        }
+        else if (line == idx)
         {
-            break;
+            width += m_font->getGlyph(c, m_charSize).width * scale;
         }
-        width += m_font->getGlyph(m_string[i], m_charSize).width;
     }
 
     return width;
@@ -145,8 +155,9 @@ void Text::updateLocalBounds() const
 
     float currWidth = 0.f;
     float currHeight = 0.f;
+    float scale = m_font->getScale(m_charSize);
 
-    for (auto c : m_string)
+    for (auto c : Util::String::getCodepoints(m_string))
     {
         if (c == '\n'/* || c == '\r'*/) //only newline is a new line!!
         {
@@ -162,10 +173,10 @@ void Text::updateLocalBounds() const
         else
         {
             auto glyph = m_font->getGlyph(c, m_charSize);
-            currWidth += glyph.width;
-            if (currHeight < glyph.height)
+            currWidth += glyph.width * scale;
+            if (currHeight < glyph.height * scale)
             {
-                currHeight = glyph.height;
+                currHeight = glyph.height * scale;
             }
         }
     }
@@ -41,6 +41,7 @@ Transform::Transform()
     m_parent    (-1),
     m_lastParent(-1),
     m_id        (-1),
+    m_revision  (0),
     m_dirtyFlags(0)
 {
     for(auto& c : m_children) c = -1;
@@ -51,42 +52,49 @@ void Transform::setOrigin(glm::vec3 o)
 {
     m_origin = o;
     m_dirtyFlags |= Tx;
+    m_revision++;
 }
 
 void Transform::setPosition(glm::vec3 position)
 {
     m_position = position;
     m_dirtyFlags |= Tx;
+    m_revision++;
 }
 
 void Transform::setRotation(glm::vec3 rotation)
 {
     m_rotation = glm::toQuat(glm::orientate3(rotation));
     m_dirtyFlags |= Tx;
+    m_revision++;
 }
 
 void Transform::setScale(glm::vec3 scale)
 {
     m_scale = scale;
     m_dirtyFlags |= Tx;
+    m_revision++;
 }
 
 void Transform::move(glm::vec3 distance)
 {
     m_position += distance;
     m_dirtyFlags |= Tx;
+    m_revision++;
 }
 
 void Transform::rotate(glm::vec3 axis, float rotation)
 {
     m_rotation = glm::rotate(m_rotation, rotation, glm::normalize(axis));
     m_dirtyFlags |= Tx;
+    m_revision++;
 }
 
 void Transform::scale(glm::vec3 scale)
 {
     m_scale *= scale;
     m_dirtyFlags |= Tx;
+    m_revision++;
 }
 
 glm::vec3 Transform::getOrigin() const
@@ -155,6 +163,7 @@ void Transform::setParent(Entity parent)
     m_parent = newID;
 
     m_dirtyFlags |= Parent;
+    m_revision++;
 }
 
 void Transform::removeParent()
@@ -162,6 +171,7 @@ void Transform::removeParent()
     m_lastParent = m_parent;
     m_parent = -1;
     m_dirtyFlags |= Parent;
+    m_revision++;
 }
 
 bool Transform::addChild(uint32 id)
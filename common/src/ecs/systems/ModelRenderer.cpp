@@ -32,8 +32,10 @@ source distribution.
 #include <crogine/ecs/components/Camera.hpp>
 #include <crogine/ecs/components/Transform.hpp>
 #include <crogine/ecs/components/Model.hpp>
+#include <crogine/ecs/components/Occluder.hpp>
 #include <crogine/ecs/Scene.hpp>
 #include <crogine/core/Clock.hpp>
+#include <crogine/core/App.hpp>
 
 #include "../../detail/GLCheck.hpp"
 
@@ -43,9 +45,19 @@ source distribution.
 
 using namespace cro;
 
+namespace
+{
+    //smallest number of entities worth sending to a worker thread
+    const std::size_t MinChunkSize = 128;
+}
+
 ModelRenderer::ModelRenderer(MessageBus& mb)
     : System            (mb, typeid(ModelRenderer)),
-    m_currentTextureUnit(0)
+    m_cullingVolume     (BoundingVolume::Sphere),
+    m_workerPool        (App::hasWorkerPool() ? &App::getWorkerPool() : nullptr),
+    m_occlusionCulling  (false),
+    m_currentTextureUnit(0),
+    m_drawCount         (0)
 {
     requireComponent<Transform>();
     requireComponent<Model>();
@@ -55,63 +67,66 @@ ModelRenderer::ModelRenderer(MessageBus& mb)
 void ModelRenderer::process(Time)
 {
     auto& entities = getEntities();
-    auto frustum = getScene()->getActiveCamera().getComponent<Camera>().getFrustum();
-
-    //cull entities by viewable into draw lists by pass
-    m_visibleEntities.clear();
-    m_visibleEntities.reserve(entities.size() * 2);
-    for (auto& entity : entities)
+    auto camera = getScene()->getActiveCamera();
+    auto frustum = camera.getComponent<Camera>().getFrustum();
+    const bool testOcclusion = updateOcclusionBuffer(camera);
+    const auto cameraPosition = camera.getComponent<Transform>().getWorldPosition();
+    const auto projectionScale = camera.getComponent<Camera>().projection[1][1];
+
+    //split the entities into contiguous chunks, one per thread
+    const auto threadCount = m_workerPool ? m_workerPool->getThreadCount() : 1;
+    const auto chunkCount = std::max(std::size_t(1),
+        std::min(threadCount, (entities.size() + MinChunkSize - 1) / MinChunkSize));
+    const auto chunkSize = (entities.size() + chunkCount - 1) / chunkCount;
+
+    if (m_cullChunks.size() < chunkCount)
     {
-        auto& model = entity.getComponent<Model>();
-
-        auto sphere = model.m_meshData.boundingSphere;
-        const auto& tx = entity.getComponent<Transform>();
-        sphere.centre = glm::vec3(tx.getWorldTransform() * glm::vec4(sphere.centre.x, sphere.centre.y, sphere.centre.z, 1.f));
-        auto scale = tx.getScale();
-        sphere.radius *= ((scale.x + scale.y + scale.z) / 3.f);
+        m_cullChunks.resize(chunkCount);
+    }
 
-        model.m_visible = true;
-        std::size_t i = 0;
-        while (model.m_visible && i < frustum.size())
-        {
-            model.m_visible = (Spatial::intersects(frustum[i++], sphere) != Planar::Back);
-        }
+    auto cullChunk = [&, chunkSize, cameraPosition, projectionScale](std::size_t i)
+    {
+        const auto first = std::min(entities.size(), i * chunkSize);
+        const auto last = std::min(entities.size(), first + chunkSize);
+        cullRange(frustum, first, last, m_cullChunks[i]);
 
-        if (model.m_visible)
+        //the occlusion buffer is read only at this point so can be shared between threads
+        if (testOcclusion)
         {
-            auto opaque = std::make_pair(entity, SortData());
-            auto transparent = std::make_pair(entity, SortData());
-
-            auto worldPos = tx.getWorldPosition();
-
-            //foreach material
-            //add ent/index pair to alpha or opaque list
-            for (i = 0u; i < model.m_meshData.submeshCount; ++i)
+            auto& results = m_cullChunks[i].results;
+            for (auto j = first; j < last; ++j)
             {
-                if (model.m_materials[i].blendMode != Material::BlendMode::None)
+                if (results[j - first])
                 {
-                    transparent.second.matIDs.push_back(i);
-                    transparent.second.flags = static_cast<int64>(worldPos.z * 1000000.f); //suitably large number to shift decimal point
-                    transparent.second.flags += 0x0FFF000000000000; //gaurentees embiggenment so that sorting places transparent last
+                    const auto& model = entities[j].getComponent<Model>();
+                    const auto box = Spatial::transform(entities[j].getComponent<Transform>().getWorldTransform(), model.m_meshData.boundingBox);
+                    results[j - first] = m_occlusionBuffer.isVisible(box) ? 1 : 0;
                 }
-                else
-                {
-                    opaque.second.matIDs.push_back(i);
-                    opaque.second.flags = static_cast<int64>(-worldPos.z * 1000000.f);
-                }
-            }
-
-            if (!opaque.second.matIDs.empty())
-            {
-                m_visibleEntities.push_back(opaque);
             }
+        }
+        buildDrawList(first, last, m_cullChunks[i], cameraPosition, projectionScale);
+    };
 
-            if (!transparent.second.matIDs.empty())
-            {
-                m_visibleEntities.push_back(transparent);
-            }
+    if (m_workerPool)
+    {
+        m_workerPool->parallelFor(chunkCount, cullChunk);
+    }
+    else
+    {
+        for (auto i = 0u; i < chunkCount; ++i)
+        {
+            cullChunk(i);
         }
     }
+
+    //merge the draw lists in chunk order so the output is the same regardless of thread timing
+    m_visibleEntities.clear();
+    m_visibleEntities.reserve(entities.size() * 2);
+    for (auto i = 0u; i < chunkCount; ++i)
+    {
+        const auto& drawList = m_cullChunks[i].drawList;
+        m_visibleEntities.insert(m_visibleEntities.end(), drawList.begin(), drawList.end());
+    }
     //DPRINT("Visible ents", std::to_string(m_visibleEntities.size()));
     //DPRINT("Total ents", std::to_string(entities.size()));
 
@@ -138,6 +153,7 @@ void ModelRenderer::render(Entity camera)
     glCheck(glCullFace(GL_BACK));
 
     //DPRINT("Render count", std::to_string(m_visibleEntities.size()));
+    m_drawCount = 0;
     for (const auto& e : m_visibleEntities)
     {
         //calc entity transform
@@ -182,6 +198,7 @@ void ModelRenderer::render(Entity camera)
 
             //draw elements
             glCheck(glDrawElements(static_cast<GLenum>(indexData.primitiveType), indexData.indexCount, static_cast<GLenum>(indexData.format), 0));
+            m_drawCount++;
 
             glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
 
@@ -206,6 +223,126 @@ void ModelRenderer::render(Entity camera)
 }
 
 //private
+void ModelRenderer::cullRange(const Frustum& frustum, std::size_t first, std::size_t last, CullChunk& chunk)
+{
+    auto& entities = getEntities();
+
+    //gather the world space bounds so they can be culled in batches
+    if (m_cullingVolume == BoundingVolume::Box)
+    {
+        chunk.boxes.clear();
+        chunk.boxes.reserve(last - first);
+        for (auto i = first; i < last; ++i)
+        {
+            const auto& box = entities[i].getComponent<Model>().m_meshData.boundingBox;
+            chunk.boxes.push_back(Spatial::transform(entities[i].getComponent<Transform>().getWorldTransform(), box));
+        }
+        Detail::Culling::frustumCull(frustum, chunk.boxes, chunk.results);
+    }
+    else
+    {
+        chunk.spheres.clear();
+        chunk.spheres.reserve(last - first);
+        for (auto i = first; i < last; ++i)
+        {
+            const auto& sphere = entities[i].getComponent<Model>().m_meshData.boundingSphere;
+            chunk.spheres.push_back(Spatial::transform(entities[i].getComponent<Transform>().getWorldTransform(), sphere));
+        }
+        Detail::Culling::frustumCull(frustum, chunk.spheres, chunk.results);
+    }
+}
+
+void ModelRenderer::buildDrawList(std::size_t first, std::size_t last, CullChunk& chunk, glm::vec3 cameraPosition, float projectionScale)
+{
+    auto& entities = getEntities();
+
+    //sort visible entities into draw lists by pass
+    chunk.drawList.clear();
+    for (auto j = first; j < last; ++j)
+    {
+        auto& entity = entities[j];
+        auto& model = entity.getComponent<Model>();
+        model.m_visible = (chunk.results[j - first] != 0);
+
+        if (model.m_visible)
+        {
+            if (!model.m_levelsOfDetail.empty())
+            {
+                const auto sphere = Spatial::transform(entity.getComponent<Transform>().getWorldTransform(), model.m_meshData.boundingSphere);
+                model.updateLevelOfDetail(glm::length(sphere.centre - cameraPosition), sphere.radius * projectionScale);
+            }
+
+            auto opaque = std::make_pair(entity, SortData());
+            auto transparent = std::make_pair(entity, SortData());
+
+            auto worldPos = entity.getComponent<Transform>().getWorldPosition();
+
+            //foreach material
+            //add ent/index pair to alpha or opaque list
+            for (auto i = 0u; i < model.m_meshData.submeshCount; ++i)
+            {
+                if (model.m_materials[i].blendMode != Material::BlendMode::None)
+                {
+                    transparent.second.matIDs.push_back(i);
+                    transparent.second.flags = static_cast<int64>(worldPos.z * 1000000.f); //suitably large number to shift decimal point
+                    transparent.second.flags += 0x0FFF000000000000; //gaurentees embiggenment so that sorting places transparent last
+                }
+                else
+                {
+                    opaque.second.matIDs.push_back(i);
+                    opaque.second.flags = static_cast<int64>(-worldPos.z * 1000000.f);
+                }
+            }
+
+            if (!opaque.second.matIDs.empty())
+            {
+                chunk.drawList.push_back(opaque);
+            }
+
+            if (!transparent.second.matIDs.empty())
+            {
+                chunk.drawList.push_back(transparent);
+            }
+        }
+    }
+}
+
+bool ModelRenderer::updateOcclusionBuffer(Entity camera)
+{
+    if (!m_occlusionCulling || m_occluders.empty())
+    {
+        return false;
+    }
+
+    const auto& camTx = camera.getComponent<Transform>();
+    m_occlusionBuffer.clear(camera.getComponent<Camera>().projection * glm::inverse(camTx.getWorldTransform()));
+
+    for (auto occluder : m_occluders)
+    {
+        const auto& data = occluder.getComponent<Occluder>();
+        m_occlusionBuffer.rasterise(occluder.getComponent<Transform>().getWorldTransform(), data.vertices, data.indices);
+    }
+
+    return !m_occlusionBuffer.empty();
+}
+
+void ModelRenderer::onEntityAdded(Entity entity)
+{
+    if (entity.hasComponent<Occluder>())
+    {
+        m_occluders.push_back(entity);
+    }
+}
+
+void ModelRenderer::onEntityRemoved(Entity entity)
+{
+    m_occluders.erase(std::remove_if(m_occluders.begin(), m_occluders.end(),
+        [entity](const Entity& e)
+    {
+        return e.getIndex() == entity.getIndex();
+    }), m_occluders.end());
+}
+
 void ModelRenderer::applyProperties(const Material::Data& material, const Model& model)
 {
     m_currentTextureUnit = 0;
@@ -262,6 +399,15 @@ void ModelRenderer::applyProperties(const Material::Data& material, const Model&
         case Material::ShadowMapProjection:
             glCheck(glUniformMatrix4fv(material.uniforms[Material::ShadowMapProjection], 1, GL_FALSE, glm::value_ptr(getScene()->getSunlight().getViewProjectionMatrix())));
             break;
+        case Material::ShadowMapCascades:
+        {
+            const auto& sunlight = getScene()->getSunlight();
+            glCheck(glUniformMatrix4fv(material.uniforms[Material::ShadowMapCascades], static_cast<GLsizei>(sunlight.getCascadeCount()), GL_FALSE, glm::value_ptr(sunlight.getCascadeMatrices()[0])));
+        }
+            break;
+        case Material::ShadowMapCascadeCount:
+            glCheck(glUniform1i(material.uniforms[Material::ShadowMapCascadeCount], static_cast<GLint>(getScene()->getSunlight().getCascadeCount())));
+            break;
         case Material::ShadowMapSampler:
             glCheck(glActiveTexture(GL_TEXTURE0 + m_currentTextureUnit));
             glCheck(glBindTexture(GL_TEXTURE_2D, getScene()->getSunlight().getMapID()));
@@ -35,10 +35,11 @@ source distribution.
 #include <crogine/graphics/MeshData.hpp>
 #include <crogine/core/Clock.hpp>
 #include <crogine/core/App.hpp>
-#include <crogine/util/Random.hpp>
+#include <crogine/core/WorkerPool.hpp>
 #include <crogine/util/Constants.hpp>
 
 #include "../../detail/GLCheck.hpp"
+#include "../../detail/Simd.hpp"
 
 #include <glm/gtc/type_ptr.hpp>
 
@@ -62,12 +63,11 @@ namespace
     const std::string vertex = R"(
         attribute vec4 a_position;
         attribute LOW vec4 a_colour;
-        attribute MED vec3 a_normal; //this actually stores rotation and scale
+        attribute MED vec3 a_normal; //this actually stores rotation, scale and size
 
         uniform mat4 u_projection;
         uniform mat4 u_viewProjection;
         uniform LOW float u_viewportHeight;
-        uniform LOW float u_particleSize;
 
         varying LOW vec4 v_colour;
         varying MED mat2 v_rotation;
@@ -81,7 +81,7 @@ namespace
             v_rotation[1]= rot;
 
             gl_Position = u_viewProjection * a_position;
-            gl_PointSize = u_viewportHeight * u_projection[1][1] / gl_Position.w * u_particleSize * a_normal.y;
+            gl_PointSize = u_viewportHeight * u_projection[1][1] / gl_Position.w * a_normal.z * a_normal.y;
         }
     )";
 
@@ -98,27 +98,52 @@ namespace
         }
     )";
 
-    constexpr std::size_t MaxVertData = ParticleEmitter::MaxParticles * (3 + 4 + 3); //pos, colour, rotation/scale vert attribs
-    const std::size_t MaxParticleSystems = 64; //max number of VBOs - must be divisible by min count
-    const std::size_t MinParticleSystems = 4; //min amount before resizing - this many added on resize (so don't make too large!!)
-    const std::size_t VertexSize = 10 * sizeof(float); //pos, colour, rotation/scale vert attribs
+    const std::size_t VertexComponents = 3 + 4 + 3; //pos, colour, rotation/scale/size vert attribs
+    const std::size_t VertexSize = VertexComponents * sizeof(float);
+    constexpr std::size_t MaxVertData = 1000 * VertexComponents; //initial size of the vertex data
+    const std::size_t MaxParticleSystems = 64; //initial size of the visible list
+    const std::size_t ChunksPerThread = 4; //emitters vary in size so split the work finer than one chunk per thread
+
+    //each emitter has its own generator so that emitters can be spawned on any thread
+    float randomValue(std::mt19937& engine, float begin, float end)
+    {
+        CRO_ASSERT(begin < end, "first value is not less than last value");
+        std::uniform_real_distribution<float> dist(begin, end);
+        return dist(engine);
+    }
+
+#ifdef CRO_SIMD
+    float minLane(Detail::Simd::Vec v)
+    {
+        std::array<float, Detail::Simd::Width> lanes;
+        Detail::Simd::store(lanes.data(), v);
+        return *std::min_element(lanes.begin(), lanes.end());
+    }
+
+    float maxLane(Detail::Simd::Vec v)
+    {
+        std::array<float, Detail::Simd::Width> lanes;
+        Detail::Simd::store(lanes.data(), v);
+        return *std::max_element(lanes.begin(), lanes.end());
+    }
+#endif //CRO_SIMD
 }
 
 ParticleSystem::ParticleSystem(MessageBus& mb)
     : System            (mb, typeid(ParticleSystem)),
     m_dataBuffer        (MaxVertData),
-    m_vboIDs            (MaxParticleSystems),
-    m_nextBuffer        (0),
-    m_bufferCount       (0),
     m_visibleCount      (0),
+    m_workerPool        (App::hasWorkerPool() ? &App::getWorkerPool() : nullptr),
+    m_depthSorting      (false),
+    m_streamBuffer      (nullptr),
+    m_vertexCount       (0),
+    m_vbo               (0),
+    m_vboOffset         (0),
     m_projectionUniform (-1),
     m_textureUniform    (-1),
     m_viewProjUniform   (-1),
-    m_viewportUniform   (-1),
-    m_sizeUniform       (-1)
+    m_viewportUniform   (-1)
 {
-    for (auto& vbo : m_vboIDs) vbo = 0;
-
     requireComponent<Transform>();
     requireComponent<ParticleEmitter>();
 
@@ -134,7 +159,6 @@ ParticleSystem::ParticleSystem(MessageBus& mb)
         m_textureUniform = uniforms.find("u_texture")->second;
         m_viewProjUniform = uniforms.find("u_viewProjection")->second;
         m_viewportUniform = uniforms.find("u_viewportHeight")->second;
-        m_sizeUniform = uniforms.find("u_particleSize")->second;
 
         //map attributes
         const auto& attribMap = m_shader.getAttribMap();
@@ -146,7 +170,7 @@ ParticleSystem::ParticleSystem(MessageBus& mb)
         m_attribData[1].attribSize = 4;
         m_attribData[1].offset = 3 * sizeof(float);
 
-        m_attribData[2].index = attribMap[Mesh::Normal]; //actually rotation/scale just using the existing naming convention
+        m_attribData[2].index = attribMap[Mesh::Normal]; //actually rotation/scale/size just using the existing naming convention
         m_attribData[2].attribSize = 3;
         m_attribData[2].offset = (3 + 4) * sizeof(float);
     }
@@ -159,156 +183,296 @@ ParticleSystem::ParticleSystem(MessageBus& mb)
     }
 }
 
-ParticleSystem::~ParticleSystem()
-{
-    //delete VBOs
-    for (auto vbo : m_vboIDs)
-    {
-        if (vbo)
-        {
-            glCheck(glDeleteBuffers(1, &vbo));
-        }
-    }
-}
-
 //public
 void ParticleSystem::process(Time dt)
 {
     m_visibleCount = 0;
 
     auto& entities = getEntities();
-    auto frustum = getScene()->getActiveCamera().getComponent<Camera>().getFrustum();
-    for (auto& e : entities)
+    auto camera = getScene()->getActiveCamera();
+    auto frustum = camera.getComponent<Camera>().getFrustum();
+    const float delta = dt.asSeconds();
+
+    if (m_visibleFlags.size() < entities.size())
+    {
+        m_visibleFlags.resize(entities.size());
+    }
+
+    //emitters don't depend on each other so are simulated in parallel
+    //in contiguous chunks. Each emitter only writes its own data.
+    const auto threadCount = m_workerPool ? m_workerPool->getThreadCount() : 1;
+    const auto chunkCount = std::max(std::size_t(1), std::min(entities.size(), threadCount * ChunksPerThread));
+    const auto chunkSize = (entities.size() + chunkCount - 1) / chunkCount;
+
+    auto simulate = [&, chunkSize, delta](std::size_t chunk)
     {
-        //check each emitter to see if it should spawn a new particle
-        auto& emitter = e.getComponent<ParticleEmitter>();
-        if (emitter.m_running &&
-            emitter.m_emissionClock.elapsed().asSeconds() > (1.f / emitter.emitterSettings.emitRate))
+        const auto first = std::min(entities.size(), chunk * chunkSize);
+        const auto last = std::min(entities.size(), first + chunkSize);
+        for (auto i = first; i < last; ++i)
         {
-            emitter.m_emissionClock.restart();
-            static const float epsilon = 0.0001f;
-            if (emitter.m_nextFreeParticle < emitter.m_particles.size() - 1)
+            auto& emitter = entities[i].getComponent<ParticleEmitter>();
+            spawnParticles(emitter, entities[i].getComponent<Transform>(), delta);
+            updateParticles(emitter, delta);
+
+            //check if not empty and within frustum
+            bool visible = (emitter.m_nextFreeParticle > 0);
+            std::size_t j = 0;
+            while (visible && j < frustum.size())
             {
-                auto& tx = e.getComponent<Transform>();
-                glm::quat rotation = glm::quat_cast(tx.getLocalTransform());
-
-                const auto& settings = emitter.emitterSettings;
-                CRO_ASSERT(settings.emitRate > 0, "Emit rate must be grater than 0");
-                CRO_ASSERT(settings.lifetime > 0, "Lifetime must be greater than 0");
-                auto& p = emitter.m_particles[emitter.m_nextFreeParticle];
-                p.colour = settings.colour;
-                p.gravity = settings.gravity;
-                p.lifetime = settings.lifetime + cro::Util::Random::value(-settings.lifetimeVariance, settings.lifetimeVariance + epsilon);
-                p.maxLifeTime = p.lifetime;
-                p.velocity = rotation * settings.initialVelocity;
-                p.rotation = Util::Random::value(-Util::Const::TAU, Util::Const::TAU);
-                p.scale = 1.f;
-
-                //spawn particle in world position
-                p.position = tx.getWorldPosition();
-                
-                //add random radius placement - TODO how to do with a position table? CAN'T HAVE +- 0!!
-                p.position.x += Util::Random::value(-settings.spawnRadius, settings.spawnRadius + epsilon);
-                p.position.y += Util::Random::value(-settings.spawnRadius, settings.spawnRadius + epsilon);
-                p.position.z += Util::Random::value(-settings.spawnRadius, settings.spawnRadius + epsilon);
-
-                emitter.m_nextFreeParticle++;
+                visible = (Spatial::intersects(frustum[j++], emitter.m_bounds) != Planar::Back);
             }
-        }      
+            m_visibleFlags[i] = visible ? 1 : 0;
+        }
+    };
 
-        //update each particle
-        const float dtSec = dt.asSeconds();
-        glm::vec3 minBounds(std::numeric_limits<float>::max());
-        glm::vec3 maxBounds;
-        for (auto i = 0u; i < emitter.m_nextFreeParticle; ++i)
+    if (m_workerPool)
+    {
+        m_workerPool->parallelFor(chunkCount, simulate);
+    }
+    else
+    {
+        for (auto i = 0u; i < chunkCount; ++i)
         {
-            auto& p = emitter.m_particles[i];
-
-            p.velocity += p.gravity * dtSec;
-            for (auto f : emitter.emitterSettings.forces) p.velocity += f * dtSec;
-            p.position += p.velocity * dtSec;            
-           
-            p.lifetime -= dtSec;
-            p.colour.setAlpha(std::max(p.lifetime / p.maxLifeTime, 0.f));
-
-            p.rotation += emitter.emitterSettings.rotationSpeed * dtSec;
-            p.scale += ((p.scale * emitter.emitterSettings.scaleModifier) * dtSec);
-            //LOG(std::to_string(emitter.emitterSettings.scaleModifier), Logger::Type::Info);
-
-            //update bounds for culling
-            if (p.position.x < minBounds.x) minBounds.x = p.position.x;
-            if (p.position.y < minBounds.y) minBounds.y = p.position.y;
-            if (p.position.z < minBounds.z) minBounds.z = p.position.z;
-
-            if (p.position.x > maxBounds.x) maxBounds.x = p.position.x;
-            if (p.position.y > maxBounds.y) maxBounds.y = p.position.y;
-            if (p.position.z > maxBounds.z) maxBounds.z = p.position.z;
+            simulate(i);
         }
-        auto dist = (maxBounds - minBounds) / 2.f;
-        emitter.m_bounds.centre = dist + minBounds;
-        emitter.m_bounds.radius = glm::length(dist);
+    }
 
-        //go over again and remove dead particles with pop/swap
-        for (auto i = 0u; i < emitter.m_nextFreeParticle; ++i)
+    //visible emitters are added to the draw list in entity order
+    //so the output is the same regardless of thread timing
+    for (auto i = 0u; i < entities.size(); ++i)
+    {
+        if (m_visibleFlags[i])
         {
-            if (emitter.m_particles[i].lifetime < 0)
+            if (m_visibleCount == m_visibleSystems.size())
+            {
+                m_visibleSystems.push_back(entities[i]);
+            }
+            else
             {
-                emitter.m_nextFreeParticle--;
-                std::swap(emitter.m_particles[i], emitter.m_particles[emitter.m_nextFreeParticle]);                
+                m_visibleSystems[m_visibleCount] = entities[i];
             }
+            m_visibleCount++;
         }
-        //DPRINT("Next free Particle", std::to_string(emitter.m_nextFreeParticle));
+    }
+
+    auto cameraTransform = camera.getComponent<Transform>().getWorldTransform();
+    m_vertexCount = buildBatches(glm::vec3(cameraTransform[3]), -glm::vec3(cameraTransform[2]));
+}
+
+//private
+void ParticleSystem::spawnParticles(ParticleEmitter& emitter, const Transform& tx, float dt)
+{
+    const auto& settings = emitter.emitterSettings;
+    CRO_ASSERT(settings.lifetime > 0, "Lifetime must be greater than 0");
+
+    //resizing keeps the oldest particles should the capacity shrink
+    if (emitter.m_particles.capacity != settings.maxParticles)
+    {
+        emitter.m_particles.resize(settings.maxParticles, emitter.m_nextFreeParticle);
+        emitter.m_nextFreeParticle = std::min(emitter.m_nextFreeParticle, emitter.m_particles.capacity);
+    }
+    const auto capacity = emitter.m_particles.capacity;
+
+    auto position = tx.getWorldPosition();
+    if (!emitter.m_hasPreviousPosition)
+    {
+        emitter.m_previousPosition = position;
+        emitter.m_hasPreviousPosition = true;
+    }
+    glm::quat rotation = glm::quat_cast(tx.getLocalTransform());
+
+    //particles are emitted at the exact rate, so more than one may be
+    //spawned per frame. Each is placed where the emitter was when it was
+    //spawned and aged by the time it has existed since. New particles are
+    //updated along with the others this frame, so their age is offset by dt
+    if (emitter.m_running && settings.emitRate > 0)
+    {
+        const float interval = 1.f / settings.emitRate;
+        emitter.m_emissionTime += dt;
 
-        //TODO sort by depth? should be drawing back to front for transparency really.
+        auto count = static_cast<std::size_t>(emitter.m_emissionTime / interval);
+        emitter.m_emissionTime -= count * interval;
 
-        //update VBO
-        std::size_t idx = 0;
-        for (auto i = 0u; i < emitter.m_nextFreeParticle; ++i)
+        //if there's not enough space keep the newest
+        auto space = capacity - emitter.m_nextFreeParticle;
+        auto skipped = (count > space) ? count - space : 0;
+
+        for (auto i = skipped; i < count; ++i)
         {
-            const auto& p = emitter.m_particles[i];
-
-            //position
-            m_dataBuffer[idx++] = p.position.x;
-            m_dataBuffer[idx++] = p.position.y;
-            m_dataBuffer[idx++] = p.position.z;
-
-            //colour
-            m_dataBuffer[idx++] = p.colour.getRed();
-            m_dataBuffer[idx++] = p.colour.getGreen();
-            m_dataBuffer[idx++] = p.colour.getBlue();
-            m_dataBuffer[idx++] = p.colour.getAlpha();
-
-            //rotation/size
-            m_dataBuffer[idx++] = p.rotation;
-            m_dataBuffer[idx++] = p.scale;
-            m_dataBuffer[idx++] = 0.f;
+            float age = emitter.m_emissionTime + ((count - 1 - i) * interval);
+            float pathPosition = (dt > 0) ? 1.f - std::min(age / dt, 1.f) : 1.f;
+            spawnParticle(emitter, glm::mix(emitter.m_previousPosition, position, pathPosition), rotation, age - dt);
         }
-        glCheck(glBindBuffer(GL_ARRAY_BUFFER, emitter.m_vbo));
-        glCheck(glBufferSubData(GL_ARRAY_BUFFER, 0, idx * sizeof(float), m_dataBuffer.data()));
+    }
 
+    for (auto i = 0u; i < emitter.m_pendingBurst && emitter.m_nextFreeParticle < capacity; ++i)
+    {
+        spawnParticle(emitter, position, rotation, -dt);
+    }
+    emitter.m_pendingBurst = 0;
 
-        //check if not empty and within frustum and add to draw list
-        auto inView = [&frustum, &emitter]()->bool
-        {
-            bool visible = true;
-            std::size_t i = 0;
-            while (visible && i < frustum.size())
-            {
-                visible = (Spatial::intersects(frustum[i++], emitter.m_bounds) != Planar::Back);
-            }
-            return visible;
-        };
-        if (emitter.m_nextFreeParticle > 0 && inView())
+    emitter.m_previousPosition = position;
+}
+
+void ParticleSystem::spawnParticle(ParticleEmitter& emitter, glm::vec3 position, const glm::quat& rotation, float age)
+{
+    CRO_ASSERT(emitter.m_nextFreeParticle < emitter.m_particles.capacity, "");
+
+    static const float epsilon = 0.0001f;
+    const auto& settings = emitter.emitterSettings;
+    auto& p = emitter.m_particles;
+    auto i = emitter.m_nextFreeParticle++;
+
+    p.red[i] = settings.colour.getRed();
+    p.green[i] = settings.colour.getGreen();
+    p.blue[i] = settings.colour.getBlue();
+    p.alpha[i] = settings.colour.getAlpha();
+
+    auto& rng = emitter.m_randomEngine;
+    auto lifetime = settings.lifetime + randomValue(rng, -settings.lifetimeVariance, settings.lifetimeVariance + epsilon);
+    p.inverseMaxLifetime[i] = 1.f / lifetime;
+    p.lifetime[i] = lifetime - age;
+
+    auto velocity = rotation * settings.initialVelocity;
+    p.velocityX[i] = velocity.x;
+    p.velocityY[i] = velocity.y;
+    p.velocityZ[i] = velocity.z;
+    p.rotation[i] = randomValue(rng, -Util::Const::TAU, Util::Const::TAU);
+    p.scale[i] = 1.f;
+
+    //add random radius placement - TODO how to do with a position table? CAN'T HAVE +- 0!!
+    position.x += randomValue(rng, -settings.spawnRadius, settings.spawnRadius + epsilon);
+    position.y += randomValue(rng, -settings.spawnRadius, settings.spawnRadius + epsilon);
+    position.z += randomValue(rng, -settings.spawnRadius, settings.spawnRadius + epsilon);
+    position += velocity * age;
+
+    p.positionX[i] = position.x;
+    p.positionY[i] = position.y;
+    p.positionZ[i] = position.z;
+}
+
+void ParticleSystem::updateParticles(ParticleEmitter& emitter, float dt)
+{
+    const auto& settings = emitter.emitterSettings;
+    auto& p = emitter.m_particles;
+    const auto count = emitter.m_nextFreeParticle;
+
+    //gravity and forces are the same for every particle
+    glm::vec3 acceleration = settings.gravity;
+    for (auto f : settings.forces) acceleration += f;
+    acceleration *= dt;
+
+    const float rotation = settings.rotationSpeed * dt;
+    const float scale = 1.f + (settings.scaleModifier * dt);
+
+    glm::vec3 minBounds(std::numeric_limits<float>::max());
+    glm::vec3 maxBounds(std::numeric_limits<float>::lowest());
+
+    std::size_t i = 0;
+#ifdef CRO_SIMD
+    {
+        using namespace Detail::Simd;
+        const Vec dtV = splat(dt);
+        const Vec zero = splat(0.f);
+        const Vec accelX = splat(acceleration.x);
+        const Vec accelY = splat(acceleration.y);
+        const Vec accelZ = splat(acceleration.z);
+        const Vec rotationV = splat(rotation);
+        const Vec scaleV = splat(scale);
+
+        Vec minX = splat(minBounds.x), minY = minX, minZ = minX;
+        Vec maxX = splat(maxBounds.x), maxY = maxX, maxZ = maxX;
+
+        for (; i + Width <= count; i += Width)
         {
-            m_visibleSystems[m_visibleCount++] = e;
+            Vec vel = add(load(&p.velocityX[i]), accelX);
+            Vec pos = add(load(&p.positionX[i]), mul(vel, dtV));
+            store(&p.velocityX[i], vel);
+            store(&p.positionX[i], pos);
+            minX = min(minX, pos);
+            maxX = max(maxX, pos);
+
+            vel = add(load(&p.velocityY[i]), accelY);
+            pos = add(load(&p.positionY[i]), mul(vel, dtV));
+            store(&p.velocityY[i], vel);
+            store(&p.positionY[i], pos);
+            minY = min(minY, pos);
+            maxY = max(maxY, pos);
+
+            vel = add(load(&p.velocityZ[i]), accelZ);
+            pos = add(load(&p.positionZ[i]), mul(vel, dtV));
+            store(&p.velocityZ[i], vel);
+            store(&p.positionZ[i], pos);
+            minZ = min(minZ, pos);
+            maxZ = max(maxZ, pos);
+
+            Vec lifetime = sub(load(&p.lifetime[i]), dtV);
+            store(&p.lifetime[i], lifetime);
+            store(&p.alpha[i], max(mul(lifetime, load(&p.inverseMaxLifetime[i])), zero));
+
+            store(&p.rotation[i], add(load(&p.rotation[i]), rotationV));
+            store(&p.scale[i], mul(load(&p.scale[i]), scaleV));
         }
+
+        minBounds = { minLane(minX), minLane(minY), minLane(minZ) };
+        maxBounds = { maxLane(maxX), maxLane(maxY), maxLane(maxZ) };
     }
+#endif //CRO_SIMD
 
-    glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+    //remaining particles which don't fill a SIMD register
+    for (; i < count; ++i)
+    {
+        p.velocityX[i] += acceleration.x;
+        p.velocityY[i] += acceleration.y;
+        p.velocityZ[i] += acceleration.z;
+
+        p.positionX[i] += p.velocityX[i] * dt;
+        p.positionY[i] += p.velocityY[i] * dt;
+        p.positionZ[i] += p.velocityZ[i] * dt;
+
+        minBounds.x = std::min(minBounds.x, p.positionX[i]);
+        minBounds.y = std::min(minBounds.y, p.positionY[i]);
+        minBounds.z = std::min(minBounds.z, p.positionZ[i]);
+        maxBounds.x = std::max(maxBounds.x, p.positionX[i]);
+        maxBounds.y = std::max(maxBounds.y, p.positionY[i]);
+        maxBounds.z = std::max(maxBounds.z, p.positionZ[i]);
+
+        p.lifetime[i] -= dt;
+        p.alpha[i] = std::max(p.lifetime[i] * p.inverseMaxLifetime[i], 0.f);
+
+        p.rotation[i] += rotation;
+        p.scale[i] *= scale;
+    }
+
+    if (count > 0)
+    {
+        auto dist = (maxBounds - minBounds) / 2.f;
+        emitter.m_bounds.centre = dist + minBounds;
+        emitter.m_bounds.radius = glm::length(dist);
+    }
+
+    //remove dead particles by moving the last particle in to their place
+    for (i = 0; i < emitter.m_nextFreeParticle;)
+    {
+        if (p.lifetime[i] < 0)
+        {
+            emitter.m_nextFreeParticle--;
+            p.copy(emitter.m_nextFreeParticle, i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
 }
 
 void ParticleSystem::render(Entity camera)
 {
+    if (m_batches.empty())
+    {
+        return;
+    }
+
     glCheck(glEnable(GL_CULL_FACE));
     glCheck(glEnable(GL_BLEND));
     glCheck(glEnable(GL_DEPTH_TEST));
@@ -332,28 +496,33 @@ void ParticleSystem::render(Entity camera)
     glCheck(glUniform1i(m_textureUniform, 0));
     glCheck(glActiveTexture(GL_TEXTURE0));
     
+    //all visible emitters are streamed to the GPU at once, the
+    //first time they're drawn after being updated
+    if (m_vertexCount > 0)
+    {
+        auto allocation = getStreamBuffer().upload(m_dataBuffer.data(), m_vertexCount * VertexSize);
+        m_vbo = allocation.vbo;
+        m_vboOffset = allocation.offset;
+        m_vertexCount = 0;
+    }
 
-    for(auto i = 0u; i < m_visibleCount; ++i)
+    //all batches share this frame's allocation in the stream buffer
+    glCheck(glBindBuffer(GL_ARRAY_BUFFER, m_vbo));
+    for (auto j = 0u; j < m_attribData.size(); ++j)
     {
-        const auto& emitter = m_visibleSystems[i].getComponent<ParticleEmitter>();
-        //bind emitter texture
-        glCheck(glBindTexture(GL_TEXTURE_2D, emitter.emitterSettings.textureID));
-        glCheck(glUniform1f(m_sizeUniform, emitter.emitterSettings.size));
-        
-        //bind emitter vbo
-        glCheck(glBindBuffer(GL_ARRAY_BUFFER, emitter.m_vbo));
+        glCheck(glEnableVertexAttribArray(m_attribData[j].index));
+        glCheck(glVertexAttribPointer(m_attribData[j].index, m_attribData[j].attribSize,
+            GL_FLOAT, GL_FALSE, VertexSize,
+            reinterpret_cast<void*>(static_cast<intptr_t>(m_vboOffset + m_attribData[j].offset))));
+    }
 
-        //bind vertex attribs
-        for (auto j = 0u; j < m_attribData.size(); ++j)
-        {
-            glCheck(glEnableVertexAttribArray(m_attribData[j].index));
-            glCheck(glVertexAttribPointer(m_attribData[j].index, m_attribData[j].attribSize,
-                GL_FLOAT, GL_FALSE, VertexSize,
-                reinterpret_cast<void*>(static_cast<intptr_t>(m_attribData[j].offset))));
-        }
+    for (const auto& batch : m_batches)
+    {
+        //bind batch texture
+        glCheck(glBindTexture(GL_TEXTURE_2D, batch.textureID));
 
         //apply blend mode
-        switch (emitter.emitterSettings.blendmode)
+        switch (batch.blendMode)
         {
         default: break;
         case EmitterSettings::Alpha:
@@ -368,13 +537,13 @@ void ParticleSystem::render(Entity camera)
         }
 
         //draw
-        glCheck(glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(emitter.m_nextFreeParticle)));
+        glCheck(glDrawArrays(GL_POINTS, static_cast<GLint>(batch.firstVertex), static_cast<GLsizei>(batch.vertexCount)));
+    }
 
-        //unbind attribs
-        for (auto j = 0u; j < m_attribData.size(); ++j)
-        {
-            glCheck(glDisableVertexAttribArray(m_attribData[j].index));
-        }
+    //unbind attribs
+    for (auto j = 0u; j < m_attribData.size(); ++j)
+    {
+        glCheck(glDisableVertexAttribArray(m_attribData[j].index));
     }
 
     glCheck(glUseProgram(0));
@@ -389,41 +558,168 @@ void ParticleSystem::render(Entity camera)
     DISABLE_POINT_SPRITES;
 }
 
-//private
-void ParticleSystem::onEntityAdded(Entity entity)
-{    
-    //check VBO count and increase if needed
-    if (m_nextBuffer == m_bufferCount)
+std::size_t ParticleSystem::buildBatches(glm::vec3 cameraPosition, glm::vec3 cameraForward)
+{
+    m_batches.clear();
+    if (m_visibleCount == 0)
     {
-        for (auto i = 0u; i < MinParticleSystems; ++i)
+        return 0;
+    }
+
+    //group emitters by blend mode and texture so each group can be drawn at once
+    std::sort(m_visibleSystems.begin(), m_visibleSystems.begin() + m_visibleCount,
+        [](Entity a, Entity b)
+    {
+        const auto& settingsA = a.getComponent<ParticleEmitter>().emitterSettings;
+        const auto& settingsB = b.getComponent<ParticleEmitter>().emitterSettings;
+        if (settingsA.blendmode == settingsB.blendmode)
         {
-            allocateBuffer();
+            return settingsA.textureID < settingsB.textureID;
         }
+        return settingsA.blendmode < settingsB.blendmode;
+    });
+
+    const float cameraDepth = glm::dot(cameraPosition, cameraForward);
+    std::size_t vertexCount = 0;
+    for (auto i = 0u; i < m_visibleCount; ++i)
+    {
+        const auto& emitter = m_visibleSystems[i].getComponent<ParticleEmitter>();
+        const auto& settings = emitter.emitterSettings;
+        if (m_batches.empty()
+            || m_batches.back().blendMode != settings.blendmode
+            || m_batches.back().textureID != settings.textureID)
+        {
+            m_batches.emplace_back();
+            auto& batch = m_batches.back();
+            batch.textureID = settings.textureID;
+            batch.blendMode = settings.blendmode;
+            batch.firstEmitter = i;
+            batch.firstVertex = vertexCount;
+            batch.depth = std::numeric_limits<float>::lowest();
+        }
+
+        auto& batch = m_batches.back();
+        batch.emitterCount++;
+        batch.vertexCount += emitter.m_nextFreeParticle;
+        batch.depth = std::max(batch.depth, glm::dot(emitter.m_bounds.centre, cameraForward) - cameraDepth);
+        vertexCount += emitter.m_nextFreeParticle;
     }
 
-    entity.getComponent<ParticleEmitter>().m_vbo = m_vboIDs[m_nextBuffer];
-    m_nextBuffer++;
+    if (m_dataBuffer.size() < vertexCount * VertexComponents)
+    {
+        m_dataBuffer.resize(vertexCount * VertexComponents);
+    }
+
+    std::size_t idx = 0;
+    for (const auto& batch : m_batches)
+    {
+        if (m_depthSorting && batch.blendMode == EmitterSettings::Alpha)
+        {
+            m_sortBuffer.clear();
+            for (auto i = batch.firstEmitter; i < batch.firstEmitter + batch.emitterCount; ++i)
+            {
+                const auto& emitter = m_visibleSystems[i].getComponent<ParticleEmitter>();
+                const auto& p = emitter.m_particles;
+                for (auto j = 0u; j < emitter.m_nextFreeParticle; ++j)
+                {
+                    SortItem item;
+                    item.depth = (p.positionX[j] * cameraForward.x)
+                        + (p.positionY[j] * cameraForward.y)
+                        + (p.positionZ[j] * cameraForward.z);
+                    item.emitter = static_cast<uint32>(i);
+                    item.particle = j;
+                    m_sortBuffer.push_back(item);
+                }
+            }
+
+            std::sort(m_sortBuffer.begin(), m_sortBuffer.end(),
+                [](const SortItem& a, const SortItem& b)
+            {
+                return a.depth > b.depth;
+            });
+
+            for (const auto& item : m_sortBuffer)
+            {
+                idx = writeVertex(idx, m_visibleSystems[item.emitter].getComponent<ParticleEmitter>(), item.particle);
+            }
+        }
+        else
+        {
+            for (auto i = batch.firstEmitter; i < batch.firstEmitter + batch.emitterCount; ++i)
+            {
+                const auto& emitter = m_visibleSystems[i].getComponent<ParticleEmitter>();
+                for (auto j = 0u; j < emitter.m_nextFreeParticle; ++j)
+                {
+                    idx = writeVertex(idx, emitter, j);
+                }
+            }
+        }
+    }
+
+    if (m_depthSorting)
+    {
+        //additive and multiplied batches don't depend on draw order, so are drawn
+        //first, followed by the alpha blended batches from furthest to nearest
+        std::stable_sort(m_batches.begin(), m_batches.end(),
+            [](const Batch& a, const Batch& b)
+        {
+            bool alphaA = (a.blendMode == EmitterSettings::Alpha);
+            bool alphaB = (b.blendMode == EmitterSettings::Alpha);
+            if (alphaA && alphaB)
+            {
+                return a.depth > b.depth;
+            }
+            return !alphaA && alphaB;
+        });
+    }
+
+    return vertexCount;
 }
 
-void ParticleSystem::onEntityRemoved(Entity entity)
+StreamBuffer& ParticleSystem::getStreamBuffer()
 {
-    auto vboID = entity.getComponent<ParticleEmitter>().m_vbo;
-    
-    //update available VBOs
-    std::size_t idx = 0;
-    while (m_vboIDs[idx] != vboID) { idx++; }
+    if (m_streamBuffer)
+    {
+        return *m_streamBuffer;
+    }
 
-    std::swap(m_vboIDs[idx], m_vboIDs[m_nextBuffer]);
+    if (App::hasStreamBuffer())
+    {
+        return App::getStreamBuffer();
+    }
 
-    m_nextBuffer--;
+    //we're being rendered without an App so manage our own buffer,
+    //the previous frame's data is finished with by the time we upload again
+    if (!m_ownStreamBuffer)
+    {
+        m_ownStreamBuffer = std::make_unique<StreamBuffer>();
+    }
+    else
+    {
+        m_ownStreamBuffer->beginFrame();
+    }
+    return *m_ownStreamBuffer;
 }
 
-void ParticleSystem::allocateBuffer()
+std::size_t ParticleSystem::writeVertex(std::size_t idx, const ParticleEmitter& emitter, std::size_t i)
 {
-    CRO_ASSERT(m_bufferCount < m_vboIDs.size(), "Max Buffers Reached!");
-    glCheck(glGenBuffers(1, &m_vboIDs[m_bufferCount]));
-    glCheck(glBindBuffer(GL_ARRAY_BUFFER, m_vboIDs[m_bufferCount]));
-    glCheck(glBufferData(GL_ARRAY_BUFFER, MaxVertData * sizeof(float), nullptr, GL_DYNAMIC_DRAW));
-    glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
-    m_bufferCount++;
+    const auto& p = emitter.m_particles;
+
+    //position
+    m_dataBuffer[idx++] = p.positionX[i];
+    m_dataBuffer[idx++] = p.positionY[i];
+    m_dataBuffer[idx++] = p.positionZ[i];
+
+    //colour
+    m_dataBuffer[idx++] = p.red[i];
+    m_dataBuffer[idx++] = p.green[i];
+    m_dataBuffer[idx++] = p.blue[i];
+    m_dataBuffer[idx++] = p.alpha[i];
+
+    //rotation/scale/size
+    m_dataBuffer[idx++] = p.rotation[i];
+    m_dataBuffer[idx++] = p.scale[i];
+    m_dataBuffer[idx++] = emitter.emitterSettings.size;
+
+    return idx;
 }
\ No newline at end of file
@@ -112,7 +112,9 @@ void SceneGraph::process(Time dt)
             std::function<void (Transform&)> getLastNode = 
                 [&](Transform& xform)
             {
+                //this node's world transform changes with its parent
                 xform.m_dirtyFlags |= Transform::Tx;
+                xform.m_revision++;
                 if (xform.m_children[0] == -1)
                 {
                     updateList.push_back(xform.m_id);
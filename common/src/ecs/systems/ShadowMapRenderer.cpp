@@ -29,94 +29,386 @@ source distribution.
 
 #include <crogine/ecs/systems/ShadowMapRenderer.hpp>
 #include <crogine/ecs/components/Transform.hpp>
+#include <crogine/ecs/components/Camera.hpp>
 #include <crogine/ecs/components/ShadowCaster.hpp>
 #include <crogine/ecs/components/Model.hpp>
 #include <crogine/ecs/components/Skeleton.hpp>
 #include <crogine/ecs/Scene.hpp>
+#include <crogine/graphics/Spatial.hpp>
 
 #include <crogine/core/Clock.hpp>
 
 #include "../../detail/GLCheck.hpp"
+#include "../../graphics/shaders/ShadowMap.hpp"
 
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/matrix_inverse.hpp>
 #include <glm/gtx/quaternion.hpp>
 
+#include <cmath>
+
 using namespace cro;
 
+namespace
+{
+#ifdef PLATFORM_DESKTOP
+    const uint32 MapSize = 1024;
+#else
+    const uint32 MapSize = 512;
+#endif
+
+    //blends between logarithmic (1) and linear (0) split distances
+    const float SplitLambda = 0.75f;
+
+    //size of the cascade light volumes towards the light, as a
+    //multiple of their radius, so that casters outside still cast into them
+    const float CasterExtension = 3.f;
+}
+
 ShadowMapRenderer::ShadowMapRenderer(cro::MessageBus& mb)
-    : System(mb, typeid(ShadowMapRenderer))
+    : System            (mb, typeid(ShadowMapRenderer)),
+    m_projectionOffset  (0.f, 0.5f, -0.5f),
+    m_cascadeCount      (1),
+    m_maxDistance       (50.f),
+    m_staticCacheDirty  (true),
+    m_cacheVbo          (0)
 {
     requireComponent<cro::Model>();
     requireComponent<cro::Transform>();
     requireComponent<cro::ShadowCaster>();
 
-    m_projectionOffset = { 0.f, 0.5f, -0.5f };
+    m_target.create(MapSize, MapSize);
+    //m_target.setRepeated(true);
 
 #ifdef PLATFORM_DESKTOP
-    m_target.create(1024, 1024);
-#else
-    m_target.create(512, 512);
+    //restoring the cached depth requires writing gl_FragDepth, which GLES2 doesn't have
+    if (m_cacheShader.loadFromString(Shaders::ShadowMap::CacheVertex, Shaders::ShadowMap::CacheFragment))
+    {
+        const std::array<float, 8u> verts = { 0.f, 1.f, 0.f, 0.f, 1.f, 1.f, 1.f, 0.f };
+        glCheck(glGenBuffers(1, &m_cacheVbo));
+        glCheck(glBindBuffer(GL_ARRAY_BUFFER, m_cacheVbo));
+        glCheck(glBufferData(GL_ARRAY_BUFFER, sizeof(verts), verts.data(), GL_STATIC_DRAW));
+        glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+
+        m_staticTarget.create(MapSize, MapSize);
+    }
+    else
+    {
+        Logger::log("Failed creating shadow cache shader, static casters will be redrawn every frame", Logger::Type::Warning);
+    }
 #endif
-    //m_target.setRepeated(true);
+}
+
+ShadowMapRenderer::~ShadowMapRenderer()
+{
+    if (m_cacheVbo)
+    {
+        glCheck(glDeleteBuffers(1, &m_cacheVbo));
+    }
 }
 
 
 //public
 void ShadowMapRenderer::process(cro::Time dt)
 {
-    m_visibleEntities.clear();
-    
+    auto& sunlight = getScene()->getSunlight();
+    auto camera = getScene()->getActiveCamera();
+
+    if (m_cascadeCount == 1)
+    {
+        const auto& camTx = camera.getComponent<Transform>();
+        auto dir = glm::translate(sunlight.getRotation(), (camTx.getWorldPosition() - m_projectionOffset));
+        m_viewMatrices[0] = glm::inverse(dir);
+        m_projectionMatrices[0] = sunlight.getProjectionMatrix();
+    }
+    else
+    {
+        updateCascades(camera);
+    }
+
+    sunlight.m_cascadeCount = m_cascadeCount;
+    for (auto i = 0u; i < m_cascadeCount; ++i)
+    {
+        sunlight.m_cascadeMatrices[i] = m_projectionMatrices[i] * m_viewMatrices[i];
+
+        if (sunlight.m_cascadeMatrices[i] != m_cachedMatrices[i])
+        {
+            m_cachedMatrices[i] = sunlight.m_cascadeMatrices[i];
+            m_staticCacheDirty = true;
+        }
+    }
+    sunlight.setViewProjectionMatrix(sunlight.m_cascadeMatrices[0]);
+
+    //cull against the light's frustum, not the camera's, as
+    //casters outside the view may still shadow visible models
     auto& entities = getEntities();
-    for (auto& entity : entities)
+    m_bounds.clear();
+    m_bounds.reserve(entities.size());
+    m_staticFlags.resize(entities.size());
+    m_staticState.clear();
+    for (auto i = 0u; i < entities.size(); ++i)
+    {
+        const auto& model = entities[i].getComponent<Model>();
+        const auto& worldTransform = entities[i].getComponent<Transform>().getWorldTransform();
+        m_bounds.push_back(Spatial::transform(worldTransform, model.m_meshData.boundingSphere));
+
+        const auto& caster = entities[i].getComponent<ShadowCaster>();
+        m_staticFlags[i] = (m_cacheVbo && caster.isStatic && !caster.skinned) ? 1 : 0;
+        if (m_staticFlags[i])
+        {
+            StaticState state;
+            state.entity = entities[i].getIndex();
+            state.vbo = model.m_meshData.vbo;
+            state.worldTransform = worldTransform;
+            m_staticState.push_back(state);
+        }
+    }
+
+    if (m_staticState.size() != m_previousStaticState.size()
+        || !std::equal(m_staticState.begin(), m_staticState.end(), m_previousStaticState.begin(),
+            [](const StaticState& a, const StaticState& b) {return !(a != b); }))
     {
-        //basic culling - this relies on the visibility test of ModelRenderer
-        if (entity.getComponent<cro::Model>().isVisible())
+        m_staticCacheDirty = true;
+    }
+    m_staticState.swap(m_previousStaticState);
+
+    for (auto c = 0u; c < m_cascadeCount; ++c)
+    {
+        Detail::Culling::frustumCull(Spatial::getFrustum(sunlight.m_cascadeMatrices[c]), m_bounds, m_cullResults);
+
+        //static casters only need sorting when the cache is going to be redrawn
+        auto& drawList = m_drawLists[c];
+        auto& staticList = m_staticDrawLists[c];
+        drawList.clear();
+        if (m_staticCacheDirty)
+        {
+            staticList.clear();
+        }
+
+        for (auto i = 0u; i < entities.size(); ++i)
+        {
+            if (m_cullResults[i]
+                && (!m_staticFlags[i] || m_staticCacheDirty))
+            {
+                auto& list = m_staticFlags[i] ? staticList : drawList;
+                const auto& model = entities[i].getComponent<Model>();
+                for (auto j = 0u; j < model.m_meshData.submeshCount; ++j)
+                {
+                    list.push_back({ entities[i], model.m_shadowMaterials[j].shader, model.m_meshData.vbo, j });
+                }
+            }
+        }
+
+        //sort by shader, then by vertex buffer, to minimise state changes
+        auto sortFunc = [](const Drawable& a, const Drawable& b)
         {
-            m_visibleEntities.push_back(entity);
+            return (a.shader == b.shader) ? a.vbo < b.vbo : a.shader < b.shader;
+        };
+        std::sort(drawList.begin(), drawList.end(), sortFunc);
+
+        if (m_staticCacheDirty)
+        {
+            std::sort(staticList.begin(), staticList.end(), sortFunc);
         }
     }
 
-    getScene()->getSunlight().m_textureID = m_target.getTexture().getGLHandle();
+    sunlight.m_textureID = m_target.getTexture().getGLHandle();
 }
 
-void ShadowMapRenderer::render(Entity camera)
+void ShadowMapRenderer::render(Entity)
 {
     //enable face culling and render rear faces
     glCheck(glEnable(GL_CULL_FACE));
     glCheck(glCullFace(GL_FRONT));
     glCheck(glEnable(GL_DEPTH_TEST));
-    
-    const auto& camTx = camera.getComponent<Transform>();
-
-    auto dir = glm::translate(getScene()->getSunlight().getRotation(), (camTx.getWorldPosition() - m_projectionOffset));
-    auto viewMat = glm::inverse(dir);
-    //auto viewMat = glm::inverse(camTx.getWorldTransform());
 
-    auto projMat = getScene()->getSunlight().getProjectionMatrix();
-    getScene()->getSunlight().setViewProjectionMatrix(projMat * viewMat);
+    //states were swapped at the end of process() so this is the current frame
+    const bool useCache = !m_previousStaticState.empty();
+    if (useCache && m_staticCacheDirty)
+    {
+        m_staticTarget.clear(cro::Colour::White());
+        drawCascades(m_staticDrawLists);
+        m_staticTarget.display();
+    }
+    m_staticCacheDirty = false;
 
     m_target.clear(cro::Colour::White());
 
-    
-    for (const auto& e : m_visibleEntities)
+    if (useCache)
     {
-        //calc entity transform
-        const auto& tx = e.getComponent<Transform>();
-        glm::mat4 worldMat = tx.getWorldTransform();
-        glm::mat4 worldView = viewMat * worldMat;
+        drawStaticCache();
+    }
+    drawCascades(m_drawLists);
+
+    glCheck(glDisable(GL_DEPTH_TEST));
+    glCheck(glDisable(GL_CULL_FACE));
+    glCheck(glCullFace(GL_BACK));
+    m_target.display();
+}
 
-        //foreach submesh / material:
-        const auto& model = e.getComponent<Model>();
-        glCheck(glBindBuffer(GL_ARRAY_BUFFER, model.m_meshData.vbo));
+void ShadowMapRenderer::setProjectionOffset(glm::vec3 offset)
+{
+    m_projectionOffset = offset;
+}
 
-        for (auto i = 0; i < model.m_meshData.submeshCount; ++i)
+const Texture& ShadowMapRenderer::getDepthMapTexture() const
+{
+    return m_target.getTexture();
+}
+
+void ShadowMapRenderer::setCascadeCount(std::size_t count)
+{
+    CRO_ASSERT(count > 0 && count <= Sunlight::MaxCascades, "Must be 1 - 4 cascades");
+#ifdef PLATFORM_DESKTOP
+    count = std::max(std::size_t(1), std::min(count, Sunlight::MaxCascades));
+#else
+    if (count > 1)
+    {
+        Logger::log("Shadow map cascades are not supported on this platform", Logger::Type::Warning);
+    }
+    count = 1;
+#endif
+
+    if (count != m_cascadeCount)
+    {
+        //use a 2x2 atlas for more than one cascade
+        const auto size = (count > 1) ? MapSize * 2 : MapSize;
+        m_target.create(size, size);
+        if (m_cacheVbo)
+        {
+            m_staticTarget.create(size, size);
+        }
+        m_cascadeCount = count;
+        m_staticCacheDirty = true;
+    }
+}
+
+void ShadowMapRenderer::setMaxDistance(float distance)
+{
+    CRO_ASSERT(distance > 0, "Must be greater than zero");
+    m_maxDistance = distance;
+}
+
+//private
+void ShadowMapRenderer::updateCascades(Entity camera)
+{
+    const auto& camComponent = camera.getComponent<Camera>();
+    const auto camWorld = camera.getComponent<Transform>().getWorldTransform();
+    const auto inverseViewProj = glm::inverse(camComponent.projection * glm::inverse(camWorld));
+
+    //find the corners of the view frustum in world space,
+    //pairs of near and far corners share an edge
+    std::array<glm::vec3, 4u> nearCorners;
+    std::array<glm::vec3, 4u> farCorners;
+    for (auto i = 0u; i < 4u; ++i)
+    {
+        const float x = (i & 1) ? 1.f : -1.f;
+        const float y = (i & 2) ? 1.f : -1.f;
+
+        auto corner = inverseViewProj * glm::vec4(x, y, -1.f, 1.f);
+        nearCorners[i] = glm::vec3(corner) / corner.w;
+
+        corner = inverseViewProj * glm::vec4(x, y, 1.f, 1.f);
+        farCorners[i] = glm::vec3(corner) / corner.w;
+    }
+
+    //measuring the depth of the planes this way works for ortho projections as well as perspective
+    const glm::vec3 cameraPosition(camWorld[3]);
+    const glm::vec3 forward = -glm::normalize(glm::vec3(camWorld[2]));
+    const float nearDistance = std::max(0.0001f, glm::dot(nearCorners[0] - cameraPosition, forward));
+    const float farDistance = glm::dot(farCorners[0] - cameraPosition, forward);
+    const float shadowDistance = std::min(farDistance, m_maxDistance);
+
+    //split distances are a blend of logarithmic and linear
+    auto splitPosition = [&](std::size_t i)
+    {
+        const float ratio = static_cast<float>(i) / m_cascadeCount;
+        const float logSplit = nearDistance * std::pow(shadowDistance / nearDistance, ratio);
+        const float linearSplit = nearDistance + (shadowDistance - nearDistance) * ratio;
+        const float split = SplitLambda * logSplit + (1.f - SplitLambda) * linearSplit;
+
+        //as a proportion along the frustum edges
+        return (split - nearDistance) / (farDistance - nearDistance);
+    };
+
+    //cascades all share the light's rotation, only their position changes
+    const glm::mat4 lightRotation(glm::mat3(glm::inverse(getScene()->getSunlight().getRotation())));
+
+    for (auto i = 0u; i < m_cascadeCount; ++i)
+    {
+        const float start = splitPosition(i);
+        const float end = splitPosition(i + 1);
+
+        std::array<glm::vec3, 8u> corners;
+        glm::vec3 centre(0.f);
+        for (auto j = 0u; j < 4u; ++j)
         {
-            const auto& mat = model.m_shadowMaterials[i];
+            const auto edge = farCorners[j] - nearCorners[j];
+            corners[j] = nearCorners[j] + edge * start;
+            corners[j + 4] = nearCorners[j] + edge * end;
+            centre += corners[j] + corners[j + 4];
+        }
+        centre /= 8.f;
+
+        //fitting a sphere keeps the cascade size constant as the camera
+        //rotates. Rounding the radius stops it changing by tiny amounts
+        float radius = 0.f;
+        for (const auto& corner : corners)
+        {
+            radius = std::max(radius, glm::length(corner - centre));
+        }
+        radius = std::ceil(radius * 16.f) / 16.f;
 
-            //bind shader
-            glCheck(glUseProgram(mat.shader));
+        //snap the centre to whole texels in light space so that the
+        //shadow edges don't shimmer when the camera moves
+        const float texelSize = (radius * 2.f) / static_cast<float>(MapSize);
+        glm::vec3 lightCentre(lightRotation * glm::vec4(centre, 1.f));
+        lightCentre.x = std::floor(lightCentre.x / texelSize) * texelSize;
+        lightCentre.y = std::floor(lightCentre.y / texelSize) * texelSize;
+
+        m_viewMatrices[i] = glm::translate(glm::mat4(1.f), -lightCentre) * lightRotation;
+        m_projectionMatrices[i] = glm::ortho(-radius, radius, -radius, radius, -radius * CasterExtension, radius);
+    }
+}
+
+void ShadowMapRenderer::drawCascades(const std::array<std::vector<Drawable>, Sunlight::MaxCascades>& drawLists)
+{
+    for (auto c = 0u; c < m_cascadeCount; ++c)
+    {
+        //cascades are laid out in a 2x2 grid
+        if (m_cascadeCount > 1)
+        {
+            glCheck(glViewport((c % 2) * MapSize, (c / 2) * MapSize, MapSize, MapSize));
+        }
+
+        const auto& viewMat = m_viewMatrices[c];
+        const auto& projMat = m_projectionMatrices[c];
+
+        uint32 currentShader = 0;
+        uint32 currentVbo = 0;
+        for (const auto& drawable : drawLists[c])
+        {
+            const auto& model = drawable.entity.getComponent<Model>();
+            const auto& mat = model.m_shadowMaterials[drawable.submesh];
+
+            //list is sorted so these only change when necessary
+            if (mat.shader != currentShader)
+            {
+                currentShader = mat.shader;
+                glCheck(glUseProgram(mat.shader));
+                glCheck(glUniformMatrix4fv(mat.uniforms[Material::Projection], 1, GL_FALSE, glm::value_ptr(projMat)));
+            }
+
+            if (drawable.vbo != currentVbo)
+            {
+                currentVbo = drawable.vbo;
+                glCheck(glBindBuffer(GL_ARRAY_BUFFER, drawable.vbo));
+            }
+
+            //calc entity transform
+            const auto& tx = drawable.entity.getComponent<Transform>();
+            glm::mat4 worldView = viewMat * tx.getWorldTransform();
 
             //apply shader uniforms from material
             for (auto j = 0u; j< mat.optionalUniformCount; ++j)
@@ -130,7 +422,6 @@ void ShadowMapRenderer::render(Entity camera)
                 }
             }
             glCheck(glUniformMatrix4fv(mat.uniforms[Material::WorldView], 1, GL_FALSE, glm::value_ptr(worldView)));
-            glCheck(glUniformMatrix4fv(mat.uniforms[Material::Projection], 1, GL_FALSE, glm::value_ptr(projMat)));
 
             //bind attribs
             const auto& attribs = mat.attribs;
@@ -143,7 +434,7 @@ void ShadowMapRenderer::render(Entity camera)
             }
 
             //bind element/index buffer
-            const auto& indexData = model.m_meshData.indexData[i];
+            const auto& indexData = model.m_meshData.indexData[drawable.submesh];
             glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexData.ibo));
 
             //draw elements
@@ -157,22 +448,34 @@ void ShadowMapRenderer::render(Entity camera)
                 glCheck(glDisableVertexAttribArray(attribs[j][Material::Data::Index]));
             }
         }
-        glCheck(glUseProgram(0));
     }
 
+    glCheck(glUseProgram(0));
     glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
-    glCheck(glDisable(GL_DEPTH_TEST));
-    glCheck(glDisable(GL_CULL_FACE));
-    glCheck(glCullFace(GL_BACK));
-    m_target.display();
 }
 
-void ShadowMapRenderer::setProjectionOffset(glm::vec3 offset)
+void ShadowMapRenderer::drawStaticCache()
 {
-    m_projectionOffset = offset;
-}
+    //the quad covers the whole atlas so reset the viewport in case cascades changed it
+    const auto size = m_target.getSize();
+    glCheck(glViewport(0, 0, size.x, size.y));
+    glCheck(glDisable(GL_CULL_FACE));
 
-const Texture& ShadowMapRenderer::getDepthMapTexture() const
-{
-    return m_target.getTexture();
+    glCheck(glUseProgram(m_cacheShader.getGLHandle()));
+    glCheck(glActiveTexture(GL_TEXTURE0));
+    glCheck(glBindTexture(GL_TEXTURE_2D, m_staticTarget.getTexture().getGLHandle()));
+    glCheck(glUniform1i(m_cacheShader.getUniformMap().find("u_texture")->second, 0));
+
+    glCheck(glBindBuffer(GL_ARRAY_BUFFER, m_cacheVbo));
+
+    const auto& attribs = m_cacheShader.getAttribMap();
+    glCheck(glEnableVertexAttribArray(attribs[Mesh::Attribute::Position]));
+    glCheck(glVertexAttribPointer(attribs[Mesh::Attribute::Position], 2, GL_FLOAT, GL_FALSE, static_cast<GLsizei>(2 * sizeof(float)), reinterpret_cast<void*>(static_cast<intptr_t>(0))));
+
+    glCheck(glDrawArrays(GL_TRIANGLE_STRIP, 0, 4));
+
+    glCheck(glDisableVertexAttribArray(attribs[Mesh::Attribute::Position]));
+    glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+    glCheck(glUseProgram(0));
+    glCheck(glEnable(GL_CULL_FACE));
 }
\ No newline at end of file
@@ -31,9 +31,11 @@ source distribution.
 #include <crogine/ecs/components/Sprite.hpp>
 #include <crogine/ecs/components/Transform.hpp>
 #include <crogine/ecs/components/Camera.hpp>
+#include <crogine/ecs/Scene.hpp>
 #include <crogine/graphics/MeshData.hpp>
 #include <crogine/core/Clock.hpp>
 #include <crogine/core/App.hpp>
+#include <crogine/detail/Sort.hpp>
 
 #include "../../detail/GLCheck.hpp"
 #include "../../graphics/shaders/Sprite.hpp"
@@ -41,14 +43,19 @@ source distribution.
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
 #include <cfloat>
+#include <cstring>
 
 using namespace cro;
 
 namespace
 {
     uint32 MaxSprites = 127u;
+    uint32 MaxTextures = 8u; //must be no more than the shader supports
     constexpr uint32 vertexSize = (4 + 4 + 2 + 2) * sizeof(float); //pos, colour, UV0, UV1
+    constexpr uint32 floatsPerSprite = (vertexSize / sizeof(float)) * 4;
+    constexpr uint32 indicesPerSprite = 6;
 }
 
 SpriteRenderer::SpriteRenderer(MessageBus& mb)
@@ -56,9 +63,10 @@ SpriteRenderer::SpriteRenderer(MessageBus& mb)
     m_matrixIndex       (0),
     m_textureIndex      (0),
     m_projectionIndex   (0),
+    m_indexBuffer       (0),
+    m_drawCount         (0),
     m_depthAxis         (DepthAxis::Z),
-    m_pendingRebuild    (false),
-    m_pendingSorting    (true)
+    m_pendingRebuild    (false)
 {
     //this has been known to fail on some platforms - but android can be as low as 64
     //which almost negates the usefulness of GPU bound transforms... :S
@@ -67,9 +75,15 @@ SpriteRenderer::SpriteRenderer(MessageBus& mb)
     MaxSprites = maxVec / 4; //4 x 4-components make up a mat4.
     MaxSprites = std::min(MaxSprites - 1, 255u); //one component is used by the projection matrix
     LOG(std::to_string(MaxSprites) + " sprites are available per batch", Logger::Type::Info);
+
+    //batches can draw from multiple textures, up to the number of available units
+    GLint maxUnits;
+    glCheck(glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxUnits));
+    MaxTextures = std::max(1u, std::min(static_cast<uint32>(maxUnits), 8u));
     
     //load shader
-    if (!m_shader.loadFromString(Shaders::Sprite::Vertex, Shaders::Sprite::Fragment, "#define MAX_MATRICES " + std::to_string(MaxSprites) + "\n"))
+    if (!m_shader.loadFromString(Shaders::Sprite::Vertex, Shaders::Sprite::Fragment, 
+        "#define MAX_MATRICES " + std::to_string(MaxSprites) + "\n#define MAX_TEXTURES " + std::to_string(MaxTextures) + "\n"))
     {
         Logger::log("Failed loading sprite rendering shader. Rendering will be in invalid state.", Logger::Type::Error, Logger::Output::All);
     }
@@ -93,9 +107,9 @@ SpriteRenderer::SpriteRenderer(MessageBus& mb)
         listUniforms();
     }
 
-    if (uniforms.count("u_texture") != 0)
+    if (uniforms.count("u_texture[0]") != 0)
     {
-        m_textureIndex = uniforms.find("u_texture")->second;
+        m_textureIndex = uniforms.find("u_texture[0]")->second;
     }
     else
     {
@@ -127,6 +141,27 @@ SpriteRenderer::SpriteRenderer(MessageBus& mb)
     m_attribMap[AttribLocation::UV1].location = attribMap[Mesh::UV1];
     m_attribMap[AttribLocation::UV1].offset = m_attribMap[AttribLocation::UV0].offset + (m_attribMap[AttribLocation::UV0].size * sizeof(float));
 
+    //each sprite is an indexed quad so that it has a fixed range in its VBO
+    //which can be updated without affecting its neighbours. The index buffer
+    //is shared as the quad layout is the same in every VBO
+    std::vector<uint16> indices;
+    indices.reserve(MaxSprites * indicesPerSprite);
+    for (auto i = 0u; i < MaxSprites; ++i)
+    {
+        //same winding as the original triangle strip
+        auto base = static_cast<uint16>(i * 4);
+        indices.push_back(base);
+        indices.push_back(base + 1);
+        indices.push_back(base + 2);
+        indices.push_back(base + 2);
+        indices.push_back(base + 1);
+        indices.push_back(base + 3);
+    }
+    glCheck(glGenBuffers(1, &m_indexBuffer));
+    glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer));
+    glCheck(glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint16), indices.data(), GL_STATIC_DRAW));
+    glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+
     //only want these entities
     requireComponent<Sprite>();
     requireComponent<Transform>();
@@ -139,6 +174,11 @@ SpriteRenderer::~SpriteRenderer()
         glCheck(glDeleteBuffers(1, &p.first));
     }
 
+    if (m_indexBuffer)
+    {
+        glCheck(glDeleteBuffers(1, &m_indexBuffer));
+    }
+
 #ifdef DEBUG_DRAW
     glCheck(glDeleteBuffers(1, &m_debugVBO));
 #endif //DEBUG_DRAW
@@ -152,125 +192,105 @@ void SpriteRenderer::handleMessage(const Message& msg)
 
 void SpriteRenderer::process(Time)
 { 
-    //have to do this first, at least once
-    if (m_pendingRebuild)
-    {
-        rebuildBatch();
-    }
-    
+    const auto viewRect = getViewRect();
+    FloatRect overlap;
+
     //get list of entities
     auto& entities = getEntities();
+    m_sortItems.clear();
     for (auto i = 0u; i < entities.size(); ++i)
     {
-        auto& sprite = entities[i].getComponent<Sprite>();        
-        if (sprite.m_dirty)
+        auto& sprite = entities[i].getComponent<Sprite>();
+        auto& tx = entities[i].getComponent<Transform>();
+        //if depth sorted set Z to -Y
+        if (m_depthAxis == DepthAxis::Y)
         {
-            //check for culling
-            /*bool state = sprite.m_visible;
-            sprite.m_visible = m_viewPort.intersects(static_cast<IntRect>(sprite.getGlobalBounds()));*/
-            //if (sprite.m_visible != state)
-            //{
-            //    m_pendingRebuild = true;
-            //}
-            //if (m_pendingRebuild) continue;
-            
-            //update buffer subdata
-            //TODO depending on how often this happens it might be worth
-            //double buffering the VBOs
-
-
-            //-----TODO THIS DOESN'T UPDATE THE DEGEN TRIANGLES CORRECTLY----//
-
-            //create data
-            //std::vector<float> vertexData;
-            //auto copyVertex = [&](uint32 idx)
-            //{
-            //    vertexData.push_back(sprite.m_quad[idx].position.x);
-            //    vertexData.push_back(sprite.m_quad[idx].position.y);
-            //    vertexData.push_back(sprite.m_quad[idx].position.z);
-            //    vertexData.push_back(1.f);
-
-            //    vertexData.push_back(sprite.m_quad[idx].colour.r);
-            //    vertexData.push_back(sprite.m_quad[idx].colour.g);
-            //    vertexData.push_back(sprite.m_quad[idx].colour.b);
-            //    vertexData.push_back(sprite.m_quad[idx].colour.a);
-            //    
-            //    vertexData.push_back(sprite.m_quad[idx].UV.x);
-            //    vertexData.push_back(sprite.m_quad[idx].UV.y);
-
-            //    vertexData.push_back(static_cast<float>(i)); //for transform lookup
-            //    vertexData.push_back(0.f);
-            //};
-
-            ////update vert data - TODO update degen!!
-            //for (auto j = 0; j < 4; ++j)
-            //{
-            //    copyVertex(j);
-            //}
-
-            ////find offset (and VBO id)
-            //auto vboIdx = (i > MaxSprites) ? i % MaxSprites : 0;
-
-            ////update sub data
-            //glCheck(glBindBuffer(GL_ARRAY_BUFFER, m_buffers[vboIdx].first));
-            //glCheck(glBufferSubData(GL_ARRAY_BUFFER, sprite.m_vboOffset,
-            //    vertexData.size() * sizeof(float), vertexData.data()));
-            //glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
-
-            //updateGlobalBounds(sprite, entities[i].getComponent<Transform>().getWorldTransform());
-
-            //---------------------EOF---------------------//
+            auto pos = tx.getPosition();
+            pos.z = -(pos.y / 100.f); //reduce this else we surpass clip plane
+            tx.setPosition(pos);
+        }
 
-            sprite.m_dirty = false;
-            m_pendingRebuild = true;
+        //bounds only need recalculating when the sprite or its transform change
+        const auto worldTransform = tx.getWorldTransform();
+        if (sprite.m_dirty || worldTransform != sprite.m_lastWorldTransform)
+        {
+            updateGlobalBounds(sprite, worldTransform);
+            sprite.m_lastWorldTransform = worldTransform;
         }
 
-        if (sprite.m_needsSorting)
+        //check for culling
+        bool visible = viewRect.intersects(sprite.m_globalBounds, overlap);
+        if (visible != sprite.m_visible)
         {
-            sprite.m_needsSorting = false;
+            sprite.m_visible = visible;
             m_pendingRebuild = true;
-            m_pendingSorting = true;
         }
 
-        //if (sprite.m_visible)
+        //culled sprites stay dirty until they are next batched
+        if (sprite.m_dirty && visible)
         {
-            auto tx = entities[i].getComponent<Transform>();
-            //if depth sorted set Z to -Y
-            if (m_depthAxis == DepthAxis::Y)
+            if (sprite.m_vbo == 0)
             {
-                auto pos = tx.getPosition();
-                pos.z = -(pos.y / 100.f); //reduce this else we surpass clip plane
-                tx.setPosition(pos);
+                //not yet added to a batch
+                m_pendingRebuild = true;
+            }
+            else
+            {
+                //only the sprite's own vertices need updating
+                std::array<float, floatsPerSprite> vertexData;
+                copyVertices(sprite, sprite.m_vboOffset / (vertexSize * 4), vertexData.data());
+
+                glCheck(glBindBuffer(GL_ARRAY_BUFFER, sprite.m_vbo));
+                glCheck(glBufferSubData(GL_ARRAY_BUFFER, sprite.m_vboOffset, vertexData.size() * sizeof(float), vertexData.data()));
+                glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+                sprite.m_dirty = false;
             }
-            //get current transforms
-            std::size_t buffIdx = (i > MaxSprites) ? i % MaxSprites : 0;
-            m_bufferTransforms[buffIdx][i - (buffIdx * MaxSprites)] = tx.getWorldTransform();
         }
-    }
 
-    if (m_pendingSorting)
-    {
-        //sort by texture then blend mode
-        std::sort(std::begin(entities), std::end(entities),
-            [](const Entity& a, const Entity& b)
+        if (sprite.m_needsSorting)
         {
-            //const auto& sprA = a.getComponent<Sprite>();
-            //const auto& sprB = b.getComponent<Sprite>();
-
-            //sub-sort by depth
-            if (a.getComponent<cro::Transform>().getWorldPosition().z < b.getComponent<cro::Transform>().getWorldPosition().z) return true;  
+            //texture or blend mode changed so batches need rebuilding
+            sprite.m_needsSorting = false;
+            m_pendingRebuild = true;
+        }
 
-            //HMMMM grouping by texture breaks depth sorting :(
+        m_sortItems.push_back({ sortKey(worldTransform[3].z, sprite), entities[i] });
+    }
 
-            /*if (sprA.m_textureID < sprB.m_textureID) return true;
-            if (sprB.m_textureID < sprA.m_textureID) return false;
+    //the order only changes when sprites move in depth or change
+    //texture, so most frames are already (or nearly) sorted
+    if (sortEntities())
+    {
+        for (auto i = 0u; i < entities.size(); ++i)
+        {
+            entities[i] = m_sortItems[i].entity;
+        }
+        m_pendingRebuild = true;
+    }
 
-            if (sprA.m_blendMode < sprB.m_blendMode) return true;
-            if (sprB.m_blendMode < sprA.m_blendMode) return false;*/
+    if (m_pendingRebuild)
+    {
+        m_visibleEntities.clear();
+        for (auto& entity : entities)
+        {
+            auto& sprite = entity.getComponent<Sprite>();
+            if (sprite.m_visible)
+            {
+                m_visibleEntities.push_back(entity);
+            }
+            else
+            {
+                //make sure culled sprites don't write to another sprite's VBO slot
+                sprite.m_vbo = 0;
+            }
+        }
+        rebuildBatch();
+    }
 
-            return false;
-        });
-        m_pendingSorting = false;
+    //get current transforms
+    for (auto i = 0u; i < m_visibleEntities.size(); ++i)
+    {
+        m_bufferTransforms[i / MaxSprites][i % MaxSprites] = m_visibleEntities[i].getComponent<Sprite>().m_lastWorldTransform;
     }
 }
 
@@ -285,17 +305,28 @@ void SpriteRenderer::render(Entity camera)
     //bind shader and attrib arrays
     glCheck(glUseProgram(m_shader.getGLHandle()));
     glCheck(glUniformMatrix4fv(m_projectionIndex, 1, GL_FALSE, glm::value_ptr(camComponent.projection * viewMat)));
-    glCheck(glActiveTexture(GL_TEXTURE0));
-    glCheck(glUniform1i(m_textureIndex, 0));
+    std::vector<int32> textureUnits(MaxTextures);
+    for (auto i = 0u; i < MaxTextures; ++i)
+    {
+        textureUnits[i] = i;
+    }
+    glCheck(glUniform1iv(m_textureIndex, MaxTextures, textureUnits.data()));
+    std::vector<int32> boundTextures(MaxTextures, -1);
 
     //foreach vbo bind and draw
+    m_drawCount = 0;
     std::size_t idx = 0;
     for (const auto& batch : m_buffers)
     {
         const auto& transforms = m_bufferTransforms[idx++]; //TODO this should be same index as current buffer
+        if (batch.second.empty())
+        {
+            continue;
+        }
         glCheck(glUniformMatrix4fv(m_matrixIndex, static_cast<GLsizei>(transforms.size()), GL_FALSE, glm::value_ptr(transforms[0])));
 
         glCheck(glBindBuffer(GL_ARRAY_BUFFER, batch.first));
+        glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer));
         
         //bind attrib pointers
         for (auto i = 0u; i < m_attribMap.size(); ++i)
@@ -309,8 +340,17 @@ void SpriteRenderer::render(Entity camera)
         {
             //CRO_ASSERT(batchData.texture > -1, "Missing sprite texture!");
             applyBlendMode(batchData.blendMode);
-            glCheck(glBindTexture(GL_TEXTURE_2D, batchData.texture));
-            glCheck(glDrawArrays(GL_TRIANGLE_STRIP, batchData.start, batchData.count));
+            for (auto i = 0u; i < batchData.textureCount; ++i)
+            {
+                if (boundTextures[i] != batchData.textures[i])
+                {
+                    glCheck(glActiveTexture(GL_TEXTURE0 + i));
+                    glCheck(glBindTexture(GL_TEXTURE_2D, batchData.textures[i]));
+                    boundTextures[i] = batchData.textures[i];
+                }
+            }
+            glCheck(glDrawElements(GL_TRIANGLES, batchData.count, GL_UNSIGNED_SHORT, reinterpret_cast<void*>(static_cast<intptr_t>(batchData.start * sizeof(uint16)))));
+            m_drawCount++;
         }
   
         //unbind attrib pointers
@@ -320,7 +360,9 @@ void SpriteRenderer::render(Entity camera)
         } 
 
     }
+    glCheck(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
     glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+    glCheck(glActiveTexture(GL_TEXTURE0));
 
 
     glCheck(glDisable(GL_DEPTH_TEST));
@@ -331,15 +373,40 @@ void SpriteRenderer::render(Entity camera)
     restorePreviousViewport();
 }
 
+std::size_t SpriteRenderer::getSpritesPerBuffer() const
+{
+    return MaxSprites;
+}
+
+std::vector<SpriteRenderer::BatchInfo> SpriteRenderer::getBatches() const
+{
+    std::vector<BatchInfo> batches;
+    std::size_t bufferStart = 0;
+    for (const auto& buffer : m_buffers)
+    {
+        for (const auto& batchData : buffer.second)
+        {
+            BatchInfo info;
+            info.vbo = buffer.first;
+            info.firstSprite = bufferStart + (batchData.start / indicesPerSprite);
+            info.spriteCount = batchData.count / indicesPerSprite;
+            info.textures.assign(batchData.textures.begin(), batchData.textures.begin() + batchData.textureCount);
+            info.blendMode = batchData.blendMode;
+            batches.push_back(info);
+        }
+        bufferStart += MaxSprites;
+    }
+    return batches;
+}
+
 //private
 void SpriteRenderer::rebuildBatch()
 {
-    auto& entities = getEntities();
-    auto vboCount = (entities.size() > MaxSprites) ? (entities.size() % MaxSprites) + 1 : 1;
+    auto& entities = m_visibleEntities;
+    auto vboCount = std::max(std::size_t(1), (entities.size() + (MaxSprites - 1)) / MaxSprites);
 
     //allocate VBOs if needed
-    auto neededVBOs = vboCount - m_buffers.size();
-    for (auto i = 0u; i < neededVBOs; ++i)
+    for (auto i = m_buffers.size(); i < vboCount; ++i)
     {
         uint32 vbo;
         glCheck(glGenBuffers(1, &vbo));
@@ -347,99 +414,69 @@ void SpriteRenderer::rebuildBatch()
     }
 
     //create each batch
-    uint32 start = 0;
     uint32 batchIdx = 0;
+    std::vector<float> vertexData;
     for (auto& batch : m_buffers)
     {
+        batch.second.clear();
+        if (batchIdx >= entities.size())
+        {
+            continue;
+        }
+
         const auto& firstSprite = entities[batchIdx].getComponent<Sprite>();
         
         Batch batchData;
-        batchData.start = start;
-        batchData.texture = firstSprite.m_textureID;
+        batchData.start = 0;
         batchData.blendMode = firstSprite.m_blendMode;
-        int32 spritesThisBatch = 0;
-        batch.second.clear();
 
-        std::vector<float> vertexData;
-        auto maxCount = std::min(static_cast<uint32>(entities.size()), batchIdx + MaxSprites);
-        for (auto i = 0u; i < maxCount; ++i)
+        vertexData.clear();
+        auto spriteCount = std::min(static_cast<uint32>(entities.size()) - batchIdx, MaxSprites);
+        vertexData.resize(spriteCount * floatsPerSprite);
+        for (auto i = 0u; i < spriteCount; ++i)
         {
             auto& sprite = entities[i + batchIdx].getComponent<Sprite>();
 
-            if (sprite.m_textureID != batchData.texture
-                || sprite.m_blendMode != batchData.blendMode)
+            //batches only need to be broken when the blend mode changes
+            //or there are no more texture units available for a new texture
+            auto textureEnd = batchData.textures.begin() + batchData.textureCount;
+            auto texture = std::find(batchData.textures.begin(), textureEnd, sprite.m_textureID);
+            if (sprite.m_blendMode != batchData.blendMode
+                || (texture == textureEnd && batchData.textureCount == MaxTextures))
             {
                 //end the batch and start a new one for this buffer
-                batchData.count = start - batchData.start;
+                batchData.count = (i * indicesPerSprite) - batchData.start;
                 batch.second.push_back(batchData);
 
-                batchData.start = start;
-                batchData.texture = sprite.m_textureID;
+                batchData.start = i * indicesPerSprite;
+                batchData.textureCount = 0;
                 batchData.blendMode = sprite.m_blendMode;
 
-                spritesThisBatch = 0;
+                texture = batchData.textures.begin();
+                textureEnd = texture;
             }
 
-            //TODO this is repeated from process function...
-            auto copyVertex = [&](uint32 idx)
+            if (texture == textureEnd)
             {
-                vertexData.push_back(sprite.m_quad[idx].position.x);
-                vertexData.push_back(sprite.m_quad[idx].position.y);
-                vertexData.push_back(sprite.m_quad[idx].position.z);
-                vertexData.push_back(1.f);
-
-                vertexData.push_back(sprite.m_quad[idx].colour.r);
-                vertexData.push_back(sprite.m_quad[idx].colour.g);
-                vertexData.push_back(sprite.m_quad[idx].colour.b);
-                vertexData.push_back(sprite.m_quad[idx].colour.a);
-
-                vertexData.push_back(sprite.m_quad[idx].UV.x);
-                vertexData.push_back(sprite.m_quad[idx].UV.y);
-
-                vertexData.push_back(static_cast<float>(i)); //for transform lookup
-                vertexData.push_back(77.f); //not used right now, just makes it easier to see in debugger
-                //vertexData.push_back(1.f);
-            };
-
-            if (spritesThisBatch > 0)
-            {
-                //add degenerate tri
-                start += 2;
-
-                //copy last vert
-                auto elementCount = vertexSize / sizeof(float);
-                for (auto j = 0u; j < elementCount; ++j)
-                {
-                    vertexData.push_back(vertexData[vertexData.size() - elementCount]);
-                }
-
-                //copy impending vert
-                copyVertex(0);
+                batchData.textures[batchData.textureCount++] = sprite.m_textureID;
             }
+            sprite.m_batchTextureIndex = static_cast<uint32>(std::distance(batchData.textures.begin(), texture));
 
-            //increase the start point
-            start += 4;
-
-            //and append data
-            sprite.m_vboOffset = static_cast<int32>(vertexData.size() * sizeof(float));
-            for (auto j = 0; j < 4; ++j)
-            {
-                copyVertex(j);
-            }
-            spritesThisBatch++;
-
-            updateGlobalBounds(sprite, entities[i + batchIdx].getComponent<Transform>().getWorldTransform());
-
+            //each sprite has a fixed slot in the VBO
+            copyVertices(sprite, i, &vertexData[i * floatsPerSprite]);
+            sprite.m_vbo = batch.first;
+            sprite.m_vboOffset = i * floatsPerSprite * sizeof(float);
             sprite.m_dirty = false;
         }
         batchIdx += MaxSprites;
-        batchData.count = start - batchData.start;
+        batchData.count = (spriteCount * indicesPerSprite) - batchData.start;
         batch.second.push_back(batchData);
 
         //upload to VBO
         glCheck(glBindBuffer(GL_ARRAY_BUFFER, batch.first));
         glCheck(glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), vertexData.data(), GL_DYNAMIC_DRAW));
     }
+    glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
 
     //allocate the space for transforms
     m_bufferTransforms.clear();
@@ -447,13 +484,89 @@ void SpriteRenderer::rebuildBatch()
     std::size_t i = 0;
     for (const auto& buffer : m_buffers)
     {
-        m_bufferTransforms[i].resize((buffer.second.back().start + buffer.second.back().count) / 4);
+        if (!buffer.second.empty())
+        {
+            m_bufferTransforms[i].resize((buffer.second.back().start + buffer.second.back().count) / indicesPerSprite);
+        }
         i++;
     }
 
     m_pendingRebuild = false;
 }
 
+FloatRect SpriteRenderer::getViewRect()
+{
+    //projects the corners of the clip space cube back in to the world
+    //to find the area of the XY plane covered by the active camera
+    auto camera = getScene()->getActiveCamera();
+    const auto& camComponent = camera.getComponent<Camera>();
+    auto viewProj = camComponent.projection * glm::inverse(camera.getComponent<Transform>().getWorldTransform());
+    auto invViewProj = glm::inverse(viewProj);
+
+    glm::vec2 min(FLT_MAX);
+    glm::vec2 max(-FLT_MAX);
+    for (auto z = -1.f; z < 2.f; z += 2.f)
+    {
+        for (auto y = -1.f; y < 2.f; y += 2.f)
+        {
+            for (auto x = -1.f; x < 2.f; x += 2.f)
+            {
+                auto corner = invViewProj * glm::vec4(x, y, z, 1.f);
+                corner /= corner.w;
+                min.x = std::min(min.x, corner.x);
+                min.y = std::min(min.y, corner.y);
+                max.x = std::max(max.x, corner.x);
+                max.y = std::max(max.y, corner.y);
+            }
+        }
+    }
+    return { min.x, min.y, max.x - min.x, max.y - min.y };
+}
+
+uint64 SpriteRenderer::sortKey(float depth, const Sprite& sprite)
+{
+    //flip the float bits so that they sort as unsigned integers
+    uint32 depthBits = 0;
+    std::memcpy(&depthBits, &depth, sizeof(depth));
+    depthBits = (depthBits & 0x80000000) ? ~depthBits : (depthBits | 0x80000000);
+
+    //sorted by depth first, then sprites at equal depth are grouped by texture and blend mode
+    uint64 key = static_cast<uint64>(depthBits) << 32;
+    key |= static_cast<uint64>(static_cast<uint32>(sprite.m_textureID) & 0xffffff) << 8;
+    key |= static_cast<uint64>(sprite.m_blendMode) & 0xff;
+    return key;
+}
+
+bool SpriteRenderer::sortEntities()
+{
+    //the order only changes a little between frames so an
+    //insertion sort is usually faster than std::stable_sort
+    return Detail::insertionSort(m_sortItems.begin(), m_sortItems.end(),
+        [](const SortItem& a, const SortItem& b) { return a.key < b.key; });
+}
+
+void SpriteRenderer::copyVertices(const Sprite& sprite, uint32 matrixIndex, float* dst)
+{
+    for (const auto& vertex : sprite.m_quad)
+    {
+        *dst++ = vertex.position.x;
+        *dst++ = vertex.position.y;
+        *dst++ = vertex.position.z;
+        *dst++ = 1.f;
+
+        *dst++ = vertex.colour.r;
+        *dst++ = vertex.colour.g;
+        *dst++ = vertex.colour.b;
+        *dst++ = vertex.colour.a;
+
+        *dst++ = vertex.UV.x;
+        *dst++ = vertex.UV.y;
+
+        *dst++ = static_cast<float>(matrixIndex); //for transform lookup
+        *dst++ = static_cast<float>(sprite.m_batchTextureIndex); //which of the batch textures to sample
+    }
+}
+
 void SpriteRenderer::updateGlobalBounds(Sprite& sprite, const glm::mat4& transform)
 {
     std::vector<glm::vec4> points = 
@@ -534,7 +647,6 @@ void SpriteRenderer::applyBlendMode(Material::BlendMode mode)
 void SpriteRenderer::onEntityAdded(Entity entity)
 {
     m_pendingRebuild = true;
-    m_pendingSorting = true;
 }
 
 void SpriteRenderer::onEntityRemoved(Entity entity)
@@ -33,6 +33,7 @@ source distribution.
 #include <crogine/ecs/components/Camera.hpp>
 #include <crogine/graphics/Font.hpp>
 #include <crogine/graphics/Texture.hpp>
+#include <crogine/util/String.hpp>
 #include <crogine/core/Clock.hpp>
 #include <crogine/core/App.hpp>
 
@@ -42,18 +43,33 @@ source distribution.
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
+#include <functional>
+
 using namespace cro;
 
 namespace
 {
     uint32 MaxTexts = 127u; //this can be as low as 63 on mobile or high as 511
     constexpr uint32 vertexSize = (4 + 4 + 2 + 2) * sizeof(float); //pos, colour, UV0, UV1
+    constexpr uint32 floatsPerVertex = vertexSize / sizeof(float);
+    constexpr std::size_t MaxCachedLayouts = 256;
+
+    //the number of vertices a text needs in the VBO, including the
+    //degenerate vertices either end. This is kept even so that every
+    //text starts on an even index and the triangle winding is preserved
+    uint32 requiredVertexCount(std::size_t vertexCount)
+    {
+        return (vertexCount == 0) ? 0 : static_cast<uint32>((vertexCount + 4) & ~std::size_t(1));
+    }
 }
 
 TextRenderer::TextRenderer(MessageBus& mb)
     : System                (mb, typeid(TextRenderer)),
     m_pendingRebuild        (false),
-    m_pendingSorting        (false)
+    m_pendingSorting        (false),
+    m_updateCount           (0),
+    m_frameCount            (0)
 {
     GLint maxVec;
     glCheck(glGetIntegerv(GL_MAX_VERTEX_UNIFORM_VECTORS, &maxVec));
@@ -61,12 +77,12 @@ TextRenderer::TextRenderer(MessageBus& mb)
     MaxTexts = std::min(MaxTexts - 1, 255u); //caps size on platforms such as VMs which incorrectly report max_vectors
     LOG(std::to_string(MaxTexts) + " texts are available per batch", Logger::Type::Info);
 
-    if (!m_shaders[Font::Type::Bitmap].shader.loadFromString(Shaders::Sprite::Vertex, Shaders::Text::BitmapFragment, "#define MAX_MATRICES " + std::to_string(MaxTexts) + "\n"))
+    if (!m_shaders[Font::Type::Bitmap].shader.loadFromString(Shaders::Text::Vertex, Shaders::Text::BitmapFragment, "#define MAX_MATRICES " + std::to_string(MaxTexts) + "\n"))
     {
         Logger::log("Failed loading bitmap font shader, text renderer is in invalid state", Logger::Type::Error, Logger::Output::All);
     }
 
-    if (!m_shaders[Font::Type::SDF].shader.loadFromString(Shaders::Sprite::Vertex, Shaders::Text::SDFFragment, "#define MAX_MATRICES " + std::to_string(MaxTexts) + "\n"))
+    if (!m_shaders[Font::Type::SDF].shader.loadFromString(Shaders::Text::Vertex, Shaders::Text::SDFFragment, "#define MAX_MATRICES " + std::to_string(MaxTexts) + "\n"))
     {
         Logger::log("Failed loading SDF font shader, text renderer is in invalid state", Logger::Type::Error, Logger::Output::All);
     }
@@ -93,70 +109,62 @@ void TextRenderer::handleMessage(const Message& msg)
 
 void TextRenderer::process(Time dt)
 {
-    if (m_pendingRebuild)
-    {
-        rebuildBatch();
-    }
+    m_frameCount++;
+    m_updateCount = 0;
 
     auto& entities = getEntities();
     for (auto i = 0u; i < entities.size(); ++i)
     {
         auto& text = entities[i].getComponent<Text>();
-        if (text.m_dirtyFlags & (Text::Verts | Text::CharSize | Text::BlendMode))
+        const auto generation = text.m_font->getAtlasGeneration(text.m_charSize);
+        if (text.m_atlasGeneration != generation
+            && (text.m_dirtyFlags & Text::Verts) == 0)
         {
-            m_pendingRebuild = true;
-            m_pendingSorting = true;
-            break;
+            if (text.m_font->hasEvictedGlyphs(Util::String::getCodepoints(text.m_string), text.m_charSize, text.m_atlasGeneration))
+            {
+                //glyphs used by this text were replaced in the font atlas so they need to be fetched again
+                text.m_dirtyFlags |= Text::Verts;
+            }
+            else
+            {
+                text.m_atlasGeneration = generation;
+            }
         }
 
-        if (text.m_dirtyFlags & Text::Colours)
+        if (text.m_dirtyFlags & (Text::CharSize | Text::BlendMode))
         {
-            //vert attribs changed so update sub buffer data
-            //create data
-            std::vector<float> vertexData;
-            auto copyVertex = [&](uint32 idx)
-            {
-                vertexData.push_back(text.m_vertices[idx].position.x);
-                vertexData.push_back(text.m_vertices[idx].position.y);
-                vertexData.push_back(text.m_vertices[idx].position.z);
-                vertexData.push_back(1.f);
-
-                vertexData.push_back(text.m_vertices[idx].colour.r);
-                vertexData.push_back(text.m_vertices[idx].colour.g);
-                vertexData.push_back(text.m_vertices[idx].colour.b);
-                vertexData.push_back(text.m_vertices[idx].colour.a);
-
-                vertexData.push_back(text.m_vertices[idx].UV.x);
-                vertexData.push_back(text.m_vertices[idx].UV.y);
-
-                vertexData.push_back(static_cast<float>(i)); //for transform lookup
-                vertexData.push_back(0.f);
-            };
-            for (auto j = 0u; j < text.m_vertices.size(); ++j)
+            //the font texture or blend mode changed so
+            //the text needs sorting in to a different batch
+            m_pendingSorting = true;
+        }
+        else if (text.m_dirtyFlags & (Text::Verts | Text::Colours))
+        {
+            if (text.m_dirtyFlags & Text::Verts)
             {
-                copyVertex(j);
+                updateVerts(text);
             }
 
-            //find offset (and VBO id)
-            auto vboIdx = (i > MaxTexts) ? i % MaxTexts : 0;
-
-            //update sub data
-            glCheck(glBindBuffer(GL_ARRAY_BUFFER, m_buffers[vboIdx].first));
-            glCheck(glBufferSubData(GL_ARRAY_BUFFER, text.m_vboOffset,
-                vertexData.size() * sizeof(float), vertexData.data()));
-            glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
-
-            text.m_dirtyFlags &= ~Text::Colours;
+            auto vertexCount = requiredVertexCount(text.m_vertices.size());
+            if (text.m_vbo == 0 || m_pendingRebuild)
+            {
+                //not yet in a batch, or it's about to be rebuilt anyway
+                m_pendingRebuild = true;
+            }
+            else if (vertexCount > text.m_vertexCapacity)
+            {
+                //grow the reserved space so that texts which change
+                //length often don't cause a rebuild every time
+                text.m_vertexCapacity = std::max(vertexCount, text.m_vertexCapacity * 2);
+                m_pendingRebuild = true;
+            }
+            else
+            {
+                //only this text's range of the VBO needs updating
+                uploadVerts(text);
+                m_updateCount++;
+            }
+            text.m_dirtyFlags = 0;
         }
-
-        auto tx = entities[i].getComponent<Transform>();
-
-        //get current transforms
-        std::size_t buffIdx = (i > MaxTexts) ? i % MaxTexts : 0;
-        std::size_t batchIdx = i - (buffIdx * MaxTexts);
-        auto worldTx = tx.getWorldTransform();
-        m_bufferTransforms[buffIdx][batchIdx] = worldTx;
-        m_buffers[text.m_batchIndex[0]].second[text.m_batchIndex[1]].worldScissor = text.m_croppingArea.transform(worldTx);
     }
 
     if (m_pendingSorting)
@@ -183,6 +191,24 @@ void TextRenderer::process(Time dt)
 
         m_pendingRebuild = true;
     }
+
+    if (m_pendingRebuild)
+    {
+        rebuildBatch();
+    }
+
+    //get current transforms
+    for (auto i = 0u; i < entities.size(); ++i)
+    {
+        auto worldTx = entities[i].getComponent<Transform>().getWorldTransform();
+        m_bufferTransforms[i / MaxTexts][i % MaxTexts] = worldTx;
+
+        auto& text = entities[i].getComponent<Text>();
+        if (text.m_scissor)
+        {
+            m_buffers[text.m_batchIndex[0]].second[text.m_batchIndex[1]].worldScissor = text.m_croppingArea.transform(worldTx);
+        }
+    }
 }
 
 void TextRenderer::render(Entity camera)
@@ -194,31 +220,49 @@ void TextRenderer::render(Entity camera)
     auto viewMat = glm::inverse(camTx.getWorldTransform());
     auto viewProjMat = camComponent.projection * viewMat;
 
-    //bind shader and attrib arrays - TODO do this for both shader types
-    glCheck(glUseProgram(m_shaders[Font::Bitmap].shader.getGLHandle()));
-    glCheck(glUniformMatrix4fv(m_shaders[Font::Bitmap].projectionUniformIndex, 1, GL_FALSE, &viewProjMat[0][0]));
-    glCheck(glActiveTexture(GL_TEXTURE0));
-    glCheck(glUniform1i(m_shaders[Font::Bitmap].textureUniformIndex, 0));
-
     //foreach vbo bind and draw
     std::size_t idx = 0;
     for (const auto& batch : m_buffers)
     {
-        const auto& transforms = m_bufferTransforms[idx++]; //TODO this should be same index as current buffer
-        glCheck(glUniformMatrix4fv(m_shaders[Font::Bitmap].xformUniformIndex, static_cast<GLsizei>(transforms.size()), GL_FALSE, glm::value_ptr(transforms[0])));
-
-        glCheck(glBindBuffer(GL_ARRAY_BUFFER, batch.first));
-
-        //bind attrib pointers
-        for (auto i = 0u; i < m_shaders[Font::Bitmap].attribMap.size(); ++i)
+        const auto& transforms = m_bufferTransforms[idx++];
+        if (batch.second.empty())
         {
-            glCheck(glEnableVertexAttribArray(m_shaders[Font::Bitmap].attribMap[i].location));
-            glCheck(glVertexAttribPointer(m_shaders[Font::Bitmap].attribMap[i].location, m_shaders[Font::Bitmap].attribMap[i].size, GL_FLOAT, GL_FALSE, vertexSize,
-                reinterpret_cast<void*>(static_cast<intptr_t>(m_shaders[Font::Bitmap].attribMap[i].offset))));
+            continue;
         }
 
+        glCheck(glBindBuffer(GL_ARRAY_BUFFER, batch.first));
+
+        //batches are sorted by texture, so the shader
+        //only changes when the font type does
+        const ShaderData* shader = nullptr;
         for (const auto& batchData : batch.second)
         {
+            if (shader != &m_shaders[batchData.shader])
+            {
+                if (shader)
+                {
+                    for (const auto& attrib : shader->attribMap)
+                    {
+                        glCheck(glDisableVertexAttribArray(attrib.location));
+                    }
+                }
+                shader = &m_shaders[batchData.shader];
+
+                //bind shader and attrib arrays
+                glCheck(glUseProgram(shader->shader.getGLHandle()));
+                glCheck(glUniformMatrix4fv(shader->projectionUniformIndex, 1, GL_FALSE, &viewProjMat[0][0]));
+                glCheck(glActiveTexture(GL_TEXTURE0));
+                glCheck(glUniform1i(shader->textureUniformIndex, 0));
+                glCheck(glUniformMatrix4fv(shader->xformUniformIndex, static_cast<GLsizei>(transforms.size()), GL_FALSE, glm::value_ptr(transforms[0])));
+
+                for (const auto& attrib : shader->attribMap)
+                {
+                    glCheck(glEnableVertexAttribArray(attrib.location));
+                    glCheck(glVertexAttribPointer(attrib.location, attrib.size, GL_FLOAT, GL_FALSE, vertexSize,
+                        reinterpret_cast<void*>(static_cast<intptr_t>(attrib.offset))));
+                }
+            }
+
             //CRO_ASSERT(batchData.texture > -1, "Missing sprite texture!");
             applyBlendMode(batchData.blendMode);
 
@@ -233,11 +277,10 @@ void TextRenderer::render(Entity camera)
         }
 
         //unbind attrib pointers
-        for (auto i = 0u; i < m_shaders[Font::Bitmap].attribMap.size(); ++i)
+        for (const auto& attrib : shader->attribMap)
         {
-            glCheck(glDisableVertexAttribArray(m_shaders[Font::Bitmap].attribMap[i].location));
+            glCheck(glDisableVertexAttribArray(attrib.location));
         }
-
     }
     glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
 
@@ -311,139 +354,221 @@ void TextRenderer::fetchShaderData(ShaderData& data)
 void TextRenderer::rebuildBatch()
 {
     auto& entities = getEntities();
-    auto vboCount = (entities.size() > MaxTexts) ? (entities.size() / MaxTexts) + 1 : 1;
+    auto vboCount = std::max(std::size_t(1), (entities.size() + (MaxTexts - 1)) / MaxTexts);
 
     //allocate new VBO if needed
-    auto neededVBOs = vboCount - m_buffers.size();
-    for (auto i = 0u; i < neededVBOs; ++i)
+    for (auto i = m_buffers.size(); i < vboCount; ++i)
     {
         uint32 vbo;
         glCheck(glGenBuffers(1, &vbo));
         m_buffers.emplace_back(std::make_pair(vbo, std::vector<Batch>()));
     }
+    m_bufferTransforms.resize(m_buffers.size());
 
-    //create a batch for each VBO, sub indexing at MaxTexts
-    uint32 start = 0;
-    uint32 batchIdx = 0;
-    for (auto& batch : m_buffers)
+    //create the batches for each VBO, sub indexing at MaxTexts
+    std::vector<float> vertexData;
+    for (auto b = 0u; b < m_buffers.size(); ++b)
     {
-        auto& currText = entities[batchIdx].getComponent<Text>();
-        
+        auto& buffer = m_buffers[b];
+        buffer.second.clear();
+
+        std::size_t first = b * MaxTexts;
+        auto textCount = (first < entities.size()) ? std::min(entities.size() - first, static_cast<std::size_t>(MaxTexts)) : 0;
+        m_bufferTransforms[b].resize(textCount);
+        if (textCount == 0)
+        {
+            continue;
+        }
+
+        vertexData.clear();
+        uint32 start = 0;
         Batch batchData;
-        batchData.start = start;
-        batchData.texture = currText.m_font->getTexture(currText.getCharSize()).getGLHandle();
-        batchData.blendMode = currText.m_blendMode;
-        batchData.scissor = currText.m_scissor;
-        //scissor area is updated during processing, so we store the batch ID in the text component
-        currText.m_batchIndex[0] = batchIdx;
-        currText.m_batchIndex[1] = batch.second.size();
-
-        int32 spritesThisBatch = 0;
-        batch.second.clear();
-
-        std::vector<float> vertexData;
-        auto maxCount = std::min(static_cast<uint32>(entities.size()), batchIdx + MaxTexts);
-        for (auto i = 0u; i < maxCount; ++i)
+        for (auto i = 0u; i < textCount; ++i)
         {
-            auto& text = entities[i + batchIdx].getComponent<Text>();
-            auto texID = text.m_font->getTexture(text.m_charSize).getGLHandle();
-            //new batches are created within the VBO for each new text, blend mode or scissor mode
-            if (texID != batchData.texture
+            auto& text = entities[first + i].getComponent<Text>();
+            if (text.m_dirtyFlags & (Text::Verts | Text::CharSize))
+            {
+                updateVerts(text);
+            }
+
+            auto texID = static_cast<int32>(text.m_font->getTexture(text.m_charSize).getGLHandle());
+            //new batches are created within the VBO for each new texture, blend mode or scissor mode
+            if (i == 0
+                || texID != batchData.texture
                 || text.m_blendMode != batchData.blendMode
                 || text.m_scissor //every scissor usually has its own batch, as the cropping area will be different
-                || text.m_scissor != batchData.scissor) 
+                || text.m_scissor != batchData.scissor)
             {
                 //end the batch and start a new one for this buffer
-                batchData.count = start - batchData.start;
-                batch.second.push_back(batchData);
+                if (i > 0)
+                {
+                    batchData.count = start - batchData.start;
+                    buffer.second.push_back(batchData);
+                }
 
                 batchData.start = start;
                 batchData.texture = texID;
+                batchData.shader = text.m_font->getType();
                 batchData.blendMode = text.m_blendMode;
                 batchData.scissor = text.m_scissor;
                 batchData.worldScissor = text.m_croppingArea;
-
-                spritesThisBatch = 0;
             }
-            updateVerts(text);
 
-            text.m_batchIndex[0] = batchIdx;
-            text.m_batchIndex[1] = batch.second.size();
+            //scissor area is updated during processing, so we store the batch ID in the text component
+            text.m_batchIndex[0] = b;
+            text.m_batchIndex[1] = buffer.second.size();
 
-            //copies vertex data at a given index
-            auto copyVertex = [&](uint32 idx)
-            {
-                vertexData.push_back(text.m_vertices[idx].position.x);
-                vertexData.push_back(text.m_vertices[idx].position.y);
-                vertexData.push_back(text.m_vertices[idx].position.z);
-                vertexData.push_back(1.f);
+            //each text keeps its reserved range until it outgrows it
+            text.m_vertexCapacity = std::max(text.m_vertexCapacity, requiredVertexCount(text.m_vertices.size()));
+            text.m_vbo = buffer.first;
+            text.m_vboOffset = static_cast<int32>(start * vertexSize);
+            text.m_transformIndex = i;
 
-                vertexData.push_back(text.m_vertices[idx].colour.r);
-                vertexData.push_back(text.m_vertices[idx].colour.g);
-                vertexData.push_back(text.m_vertices[idx].colour.b);
-                vertexData.push_back(text.m_vertices[idx].colour.a);
+            auto offset = vertexData.size();
+            vertexData.resize(offset + (text.m_vertexCapacity * floatsPerVertex));
+            copyVertices(text, &vertexData[offset]);
 
-                vertexData.push_back(text.m_vertices[idx].UV.x);
-                vertexData.push_back(text.m_vertices[idx].UV.y);
+            start += text.m_vertexCapacity;
+            text.m_dirtyFlags = 0;
+        }
+        batchData.count = start - batchData.start;
+        buffer.second.push_back(batchData);
 
-                vertexData.push_back(static_cast<float>(i)); //for transform lookup
-                vertexData.push_back(0.f); //not used right now
-            };
+        //upload to VBO
+        glCheck(glBindBuffer(GL_ARRAY_BUFFER, buffer.first));
+        glCheck(glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), vertexData.data(), GL_DYNAMIC_DRAW));
+        m_updateCount += textCount;
+    }
+    glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
 
-            if (spritesThisBatch > 0)
-            {
-                //add degenerate tri
-                start += 2;
+    m_pendingRebuild = false;
+}
 
-                //copy last vert
-                auto elementCount = vertexSize / sizeof(float);
-                for (auto j = 0u; j < elementCount; ++j)
-                {
-                    vertexData.push_back(vertexData[vertexData.size() - elementCount]);
-                }
+void TextRenderer::updateVerts(Text& text)
+{
+    CRO_ASSERT(text.m_font, "Must construct text with a font!");
 
-                //copy impending vert
-                copyVertex(0);
-            }
+    auto generation = text.m_font->getAtlasGeneration(text.m_charSize);
 
-            //increase the start point
-            start += static_cast<uint32>(text.m_vertices.size());
+    LayoutKey key;
+    key.string = text.m_string;
+    key.font = text.m_font;
+    key.charSize = text.m_charSize;
+    key.alignment = text.m_alignment;
 
-            //and append data
-            text.m_vboOffset = static_cast<int32>(vertexData.size() * sizeof(float));
-            for (auto j = 0u; j < text.m_vertices.size(); ++j)
+    auto result = m_layoutCache.find(key);
+    if (result == m_layoutCache.end())
+    {
+        if (m_layoutCache.size() >= MaxCachedLayouts)
+        {
+            //evict the least recently used
+            auto oldest = std::min_element(m_layoutCache.begin(), m_layoutCache.end(),
+                [](const std::pair<const LayoutKey, Layout>& a, const std::pair<const LayoutKey, Layout>& b)
             {
-                copyVertex(j);
-            }
-            spritesThisBatch++;
+                return a.second.lastUsed < b.second.lastUsed;
+            });
+            m_layoutCache.erase(oldest);
+        }
 
-            text.m_dirtyFlags = 0;
+        result = m_layoutCache.insert(std::make_pair(std::move(key), Layout())).first;
+        createLayout(text, result->second);
+    }
+    else if (result->second.atlasGeneration != generation)
+    {
+        //only layouts using evicted glyphs need to be recreated
+        if (text.m_font->hasEvictedGlyphs(Util::String::getCodepoints(text.m_string), text.m_charSize, result->second.atlasGeneration))
+        {
+            createLayout(text, result->second);
         }
+        else
+        {
+            result->second.atlasGeneration = generation;
+        }
+    }
 
-        batchIdx += MaxTexts;
-        batchData.count = start - batchData.start;
-        batch.second.push_back(batchData);
+    auto& layout = result->second;
+    layout.lastUsed = m_frameCount;
 
-        //upload to VBO
-        glCheck(glBindBuffer(GL_ARRAY_BUFFER, batch.first));
-        glCheck(glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(float), vertexData.data(), GL_DYNAMIC_DRAW));
+    text.m_atlasGeneration = layout.atlasGeneration;
+
+    text.m_localBounds.bottom = layout.bounds.bottom;
+    text.m_localBounds.height = layout.bounds.height;
+    text.m_localBounds.width = layout.bounds.width;
+
+    Text::Vertex v;
+    v.position.z = 0.f;
+    v.colour = { text.m_colour.getRed(), text.m_colour.getGreen(), text.m_colour.getBlue(), text.m_colour.getAlpha() };
+
+    text.m_vertices.clear();
+    for (auto i = 0u; i < layout.vertices.size(); i += 4)
+    {
+        v.position.x = layout.vertices[i];
+        v.position.y = layout.vertices[i + 1];
+        v.UV.x = layout.vertices[i + 2];
+        v.UV.y = layout.vertices[i + 3];
+        text.m_vertices.push_back(v);
     }
+    text.m_dirtyFlags = 0;
+}
 
+void TextRenderer::uploadVerts(const Text& text)
+{
+    std::vector<float> vertexData(text.m_vertexCapacity * floatsPerVertex);
+    copyVertices(text, vertexData.data());
 
-    //allocate the space for transforms
-    m_bufferTransforms.clear();
-    m_bufferTransforms.resize(m_buffers.size());
-    std::size_t i = 0;
-    for (const auto& buffer : m_buffers)
+    glCheck(glBindBuffer(GL_ARRAY_BUFFER, text.m_vbo));
+    glCheck(glBufferSubData(GL_ARRAY_BUFFER, text.m_vboOffset, vertexData.size() * sizeof(float), vertexData.data()));
+    glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+}
+
+void TextRenderer::copyVertices(const Text& text, float* dst)
+{
+    //each range starts with a copy of the first vertex and is padded with copies
+    //of the last, creating degenerate triangles which join it to its neighbours.
+    //Unused capacity is filled with degenerates so it draws nothing.
+    const float smoothing = text.m_font->getSmoothing(text.m_charSize);
+    auto copyVertex = [&](const Text::Vertex& vertex)
+    {
+        *dst++ = vertex.position.x;
+        *dst++ = vertex.position.y;
+        *dst++ = vertex.position.z;
+        *dst++ = 1.f;
+
+        *dst++ = vertex.colour.r;
+        *dst++ = vertex.colour.g;
+        *dst++ = vertex.colour.b;
+        *dst++ = vertex.colour.a;
+
+        *dst++ = vertex.UV.x;
+        *dst++ = vertex.UV.y;
+
+        *dst++ = static_cast<float>(text.m_transformIndex); //for transform lookup
+        *dst++ = smoothing; //SDF edge width
+    };
+
+    if (text.m_vertices.empty())
     {
-        m_bufferTransforms[i].resize((buffer.second.back().start + buffer.second.back().count) / 4);
-        i++;
+        Text::Vertex empty = {};
+        for (auto i = 0u; i < text.m_vertexCapacity; ++i)
+        {
+            copyVertex(empty);
+        }
+        return;
     }
 
-    m_pendingRebuild = false;
+    copyVertex(text.m_vertices.front());
+    copyVertex(text.m_vertices.front());
+    for (const auto& v : text.m_vertices)
+    {
+        copyVertex(v);
+    }
+    for (auto i = text.m_vertices.size() + 2; i < text.m_vertexCapacity; ++i)
+    {
+        copyVertex(text.m_vertices.back());
+    }
 }
 
-void TextRenderer::updateVerts(Text& text)
+void TextRenderer::createLayout(const Text& text, Layout& layout)
 {
     /*
     0-------2
@@ -451,11 +576,15 @@ void TextRenderer::updateVerts(Text& text)
     |       |
     1-------3
     */
-    CRO_ASSERT(text.m_font, "Must construct text with a font!");
+    layout.vertices.clear();
+    layout.bounds = {};
+
+    //read before fetching the glyphs, so that if fetching one evicts another
+    //used by this layout it is found to be invalid and created again
+    layout.atlasGeneration = text.m_font->getAtlasGeneration(text.m_charSize);
     if (text.m_string.empty()) return;
 
-    text.m_vertices.clear();
-    text.m_vertices.reserve(text.m_string.size() * 6); //4 verts per char + degen tri
+    layout.vertices.reserve(text.m_string.size() * 6 * 4); //4 verts per char + degen tri
 
     auto getStart = [](std::size_t idx, const Text& text)->float
     {
@@ -480,13 +609,22 @@ void TextRenderer::updateVerts(Text& text)
     float yPos = -text.getLineHeight();
     float lineHeight = text.getLineHeight();
     glm::vec2 texSize(text.m_font->getTexture(text.m_charSize).getSize());
+    float scale = text.m_font->getScale(text.m_charSize); //SDF glyphs are scaled from a single size
     CRO_ASSERT(texSize.x > 0 && texSize.y > 0, "Font texture not loaded!");
 
     float top = 0.f;
     float width = 0.f;
     std::size_t lineCount = 0;
 
-    for (auto c : text.m_string)
+    auto addVertex = [&layout](float x, float y, float u, float v)
+    {
+        layout.vertices.push_back(x);
+        layout.vertices.push_back(y);
+        layout.vertices.push_back(u);
+        layout.vertices.push_back(v);
+    };
+
+    for (auto c : Util::String::getCodepoints(text.m_string))
     {
         //check for end of lines
         if (/*c == '\r' ||*/ c == '\n') //newline is a new line!!
@@ -500,53 +638,50 @@ void TextRenderer::updateVerts(Text& text)
         }
 
         auto rect = text.m_font->getGlyph(c, text.m_charSize);
-        Text::Vertex v;
-        v.position.x = xPos;
-        v.position.y = yPos + rect.height;
-        v.position.z = 0.f;
-
-        v.UV.x = rect.left / texSize.x;
-        v.UV.y = (rect.bottom + rect.height) / texSize.y;
-        text.m_vertices.push_back(v);
-        text.m_vertices.push_back(v); //twice for degen tri
+        float glyphWidth = rect.width * scale;
+        float glyphHeight = rect.height * scale;
 
-        v.position.y = yPos;
+        addVertex(xPos, yPos + glyphHeight, rect.left / texSize.x, (rect.bottom + rect.height) / texSize.y);
+        addVertex(xPos, yPos + glyphHeight, rect.left / texSize.x, (rect.bottom + rect.height) / texSize.y); //twice for degen tri
 
-        v.UV.x = rect.left / texSize.x;
-        v.UV.y = rect.bottom / texSize.y;
-        text.m_vertices.push_back(v);
-
-        v.position.x = xPos + rect.width;
-        v.position.y = yPos + rect.height;
-
-        v.UV.x = (rect.left + rect.width) / texSize.x;
-        v.UV.y = (rect.bottom + rect.height) / texSize.y;
-        text.m_vertices.push_back(v);
+        addVertex(xPos, yPos, rect.left / texSize.x, rect.bottom / texSize.y);
 
-        v.position.y = yPos;
+        addVertex(xPos + glyphWidth, yPos + glyphHeight, (rect.left + rect.width) / texSize.x, (rect.bottom + rect.height) / texSize.y);
 
-        v.UV.x = (rect.left + rect.width) / texSize.x;
-        v.UV.y = rect.bottom / texSize.y;
-        text.m_vertices.push_back(v);
-        text.m_vertices.push_back(v); //end degen tri
+        addVertex(xPos + glyphWidth, yPos, (rect.left + rect.width) / texSize.x, rect.bottom / texSize.y);
+        addVertex(xPos + glyphWidth, yPos, (rect.left + rect.width) / texSize.x, rect.bottom / texSize.y); //end degen tri
 
-        if (v.position.x > width) width = v.position.x;
+        if (xPos + glyphWidth > width) width = xPos + glyphWidth;
 
-        xPos += rect.width;
+        xPos += glyphWidth;
     }
 
-    text.m_localBounds.bottom = yPos;
-    text.m_localBounds.height = top - yPos;
-    text.m_localBounds.width = width;
-
-    text.m_vertices.erase(text.m_vertices.begin()); //remove front/back degens as these are added by renderer
-    text.m_vertices.pop_back();
+    layout.bounds.bottom = yPos;
+    layout.bounds.height = top - yPos;
+    layout.bounds.width = width;
 
-    for (auto& v : text.m_vertices)
+    //remove front/back degens as these are added by renderer
+    if (!layout.vertices.empty())
     {
-        v.colour = { text.m_colour.getRed(), text.m_colour.getGreen(), text.m_colour.getBlue(), text.m_colour.getAlpha() };
+        layout.vertices.erase(layout.vertices.begin(), layout.vertices.begin() + 4);
+        layout.vertices.resize(layout.vertices.size() - 4);
     }
-    text.m_dirtyFlags = 0;
+}
+
+bool TextRenderer::LayoutKey::operator == (const LayoutKey& other) const
+{
+    return font == other.font
+        && charSize == other.charSize
+        && alignment == other.alignment
+        && string == other.string;
+}
+
+std::size_t TextRenderer::LayoutKeyHash::operator()(const LayoutKey& key) const
+{
+    std::size_t hash = std::hash<std::string>()(key.string);
+    hash ^= std::hash<const Font*>()(key.font) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<uint32>()((key.charSize << 2) | key.alignment) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
 }
 
 void TextRenderer::applyBlendMode(Material::BlendMode mode)
@@ -39,10 +39,72 @@ source distribution.
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/norm.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 using namespace cro;
 
+namespace
+{
+    const float CellSize = 128.f; //size of grid cells in world units
+    const int32 MaxCells = 256; //areas covering more cells than this are always tested
+
+    //gestures are measured in normalised screen coordinates
+    const float DragThreshold = 0.01f; //distance a finger moves before it's considered dragging
+    const float SwipeDistance = 0.1f; //minimum length of a swipe
+    const float SwipeTime = 0.3f; //maximum duration of a swipe in seconds
+
+    int32 toCell(float position)
+    {
+        return static_cast<int32>(std::floor(position / CellSize));
+    }
+
+    uint64 getCellKey(int32 x, int32 y)
+    {
+        return (static_cast<uint64>(static_cast<uint32>(x)) << 32) | static_cast<uint32>(y);
+    }
+
+    //areas too large to store in individual cells go in this one
+    const uint64 OversizeKey = getCellKey(std::numeric_limits<int32>::max(), std::numeric_limits<int32>::max());
+
+    template <typename T>
+    void forEachCell(const FloatRect& area, const T& func)
+    {
+        auto left = toCell(area.left);
+        auto right = toCell(area.left + area.width);
+        auto bottom = toCell(area.bottom);
+        auto top = toCell(area.bottom + area.height);
+
+        if (right - left >= MaxCells || top - bottom >= MaxCells
+            || (right - left + 1) * (top - bottom + 1) > MaxCells)
+        {
+            func(OversizeKey);
+            return;
+        }
+
+        for (auto y = bottom; y <= top; ++y)
+        {
+            for (auto x = left; x <= right; ++x)
+            {
+                func(getCellKey(x, y));
+            }
+        }
+    }
+
+    bool equal(const FloatRect& a, const FloatRect& b)
+    {
+        return a.left == b.left && a.bottom == b.bottom
+            && a.width == b.width && a.height == b.height;
+    }
+}
+
 UISystem::UISystem(MessageBus& mb)
-    : System    (mb, typeid(UISystem))
+    : System        (mb, typeid(UISystem)),
+    m_pinchDistance (0.f),
+    m_pinchAngle    (0.f),
+    m_pinching      (false),
+    m_queryPending  (true)
 {
     requireComponent<UIInput>();
     requireComponent<Transform>();
@@ -55,112 +117,185 @@ UISystem::UISystem(MessageBus& mb)
 
 void UISystem::handleEvent(const Event& evt)
 {
+    /*
+    SDL raises mouse events as well as touch events for a single touch
+    on mobile platforms. These are ignored so that callbacks aren't
+    executed twice, and touches are handled by the finger events.
+    */
     switch (evt.type)
     {
     default: break;
     case SDL_MOUSEMOTION:
+        if (evt.motion.which == SDL_TOUCH_MOUSEID) break;
+
+        //multiple motion events in one frame are combined
         m_eventPosition = toWorldCoords(evt.motion.x, evt.motion.y);
-        m_movementDelta = m_eventPosition - m_prevMousePosition;
+        m_movementDelta += m_eventPosition - m_prevMousePosition;
         m_prevMousePosition = m_eventPosition;
         break;
     case SDL_MOUSEBUTTONDOWN:
+        if (evt.button.which == SDL_TOUCH_MOUSEID) break;
+
         m_eventPosition = toWorldCoords(evt.button.x, evt.button.y);
         m_previousEventPosition = m_eventPosition;
         switch (evt.button.button)
         {
         default: break;
         case SDL_BUTTON_LEFT:
-            m_downEvents.push_back(LeftMouse);
+            m_downEvents.push_back({ LeftMouse, m_eventPosition });
             break;
         case SDL_BUTTON_RIGHT:
-            m_downEvents.push_back(RightMouse);
+            m_downEvents.push_back({ RightMouse, m_eventPosition });
             break;
         case SDL_BUTTON_MIDDLE:
-            m_downEvents.push_back(MiddleMouse);
+            m_downEvents.push_back({ MiddleMouse, m_eventPosition });
             break;
         }
         break;
     case SDL_MOUSEBUTTONUP:
+        if (evt.button.which == SDL_TOUCH_MOUSEID) break;
+
         m_eventPosition = toWorldCoords(evt.button.x, evt.button.y);
         switch (evt.button.button)
         {
         default: break;
         case SDL_BUTTON_LEFT:
-            m_upEvents.push_back(Flags::LeftMouse);
+            m_upEvents.push_back({ Flags::LeftMouse, m_eventPosition });
             break;
         case SDL_BUTTON_RIGHT:
-            m_upEvents.push_back(Flags::RightMouse);
+            m_upEvents.push_back({ Flags::RightMouse, m_eventPosition });
             break;
         case SDL_BUTTON_MIDDLE:
-            m_upEvents.push_back(Flags::MiddleMouse);
+            m_upEvents.push_back({ Flags::MiddleMouse, m_eventPosition });
             break;
         }
         break;
-        /*
-        NOTE!!!
-        SDL registers both touch AND mouse events for a single touch
-        on Android. Be warned this will execute the same callback twice!!
-        */
-
     case SDL_FINGERMOTION:
-        m_eventPosition = toWorldCoords(evt.tfinger.x, evt.tfinger.y);
-        //TODO check finger IDs for gestures etc
+    {
+        auto touch = std::find_if(m_touches.begin(), m_touches.end(),
+            [&evt](const Touch& t) { return t.id == evt.tfinger.fingerId && !t.released; });
+        if (touch != m_touches.end())
+        {
+            //only the latest position is kept, gestures are updated once per frame
+            touch->position = { evt.tfinger.x, evt.tfinger.y };
+
+            //the first finger also acts as the pointer
+            if (touch == m_touches.begin())
+            {
+                auto position = toWorldCoords(evt.tfinger.x, evt.tfinger.y);
+                m_movementDelta += position - m_eventPosition;
+                m_eventPosition = position;
+            }
+        }
+    }
         break;
     case SDL_FINGERDOWN:
-        m_eventPosition = toWorldCoords(evt.tfinger.x, evt.tfinger.y);
-        m_previousEventPosition = m_eventPosition;
-        //TODO check finger IDs for gestures etc
-        m_downEvents.push_back(Finger);
-        //Logger::log("Touch pos: " + std::to_string(m_eventPosition.x) + ", " + std::to_string(m_eventPosition.y), Logger::Type::Info);
+    {
+        Touch touch;
+        touch.id = evt.tfinger.fingerId;
+        touch.start = touch.position = touch.previousPosition = { evt.tfinger.x, evt.tfinger.y };
+
+        auto position = toWorldCoords(evt.tfinger.x, evt.tfinger.y);
+        queryGrid(position, touch.targets);
+        m_downEvents.push_back({ Finger, position });
+
+        if (m_touches.empty())
+        {
+            m_eventPosition = position;
+            m_previousEventPosition = position;
+        }
+        m_touches.push_back(touch);
+    }
         break;
     case SDL_FINGERUP:
-        m_eventPosition = toWorldCoords(evt.tfinger.x, evt.tfinger.y);
-        m_upEvents.push_back(Finger);
+    {
+        auto position = toWorldCoords(evt.tfinger.x, evt.tfinger.y);
+        m_upEvents.push_back({ Finger, position });
+
+        auto touch = std::find_if(m_touches.begin(), m_touches.end(),
+            [&evt](const Touch& t) { return t.id == evt.tfinger.fingerId && !t.released; });
+        if (touch != m_touches.end())
+        {
+            //removed once any swipe has been processed
+            touch->position = { evt.tfinger.x, evt.tfinger.y };
+            touch->released = true;
+
+            if (touch == m_touches.begin())
+            {
+                m_eventPosition = position;
+            }
+        }
+    }
         break;
     }
 }
 
 void UISystem::process(Time dt)
 {    
-    //TODO we probably want some partitioning? Checking every entity for a collision could be a bit pants
-    auto& entities = getEntities();
-    for (auto& e : entities)
+    updateGrid();
+
+    if (m_eventPosition != m_previousEventPosition
+        || glm::length2(m_movementDelta) > 0
+        || !m_downEvents.empty() || !m_upEvents.empty())
     {
-        //TODO probably want to cache these and only update if control moved
-        auto tx = e.getComponent<Transform>().getWorldTransform();
-        auto& input = e.getComponent<UIInput>();
+        m_queryPending = true;
+    }
 
-        auto area = input.area.transform(tx);
-        if (area.contains(m_eventPosition))
+    //if neither the pointer nor any controls moved
+    //then there's nothing new under the pointer
+    if (m_queryPending)
+    {
+        m_queryPending = false;
+        queryGrid(m_eventPosition, m_candidates);
+
+        for (auto e : m_hitEntities)
         {
+            if (std::find(m_candidates.begin(), m_candidates.end(), e) == m_candidates.end())
+            {
+                //mouse left
+                auto& input = e.getComponent<UIInput>();
+                input.active = false;
+                m_movementCallbacks[input.callbacks[UIInput::MouseExit]](e, m_movementDelta);
+            }
+        }
+        m_hitEntities.swap(m_candidates);
+
+        for (auto e : m_hitEntities)
+        {
+            auto& input = e.getComponent<UIInput>();
             if (!input.active)
             {
                 //mouse has entered
                 input.active = true;
                 m_movementCallbacks[input.callbacks[UIInput::MouseEnter]](e, m_movementDelta);
             }
-            for (auto f : m_downEvents)
-            {
-                m_buttonCallbacks[input.callbacks[UIInput::MouseDown]](e, f);
-            }
-            for (auto f : m_upEvents)
-            {
-                m_buttonCallbacks[input.callbacks[UIInput::MouseUp]](e, f);
-            }
             if (glm::length2(m_movementDelta) > 0)
             {
                 m_movementCallbacks[input.callbacks[UIInput::MouseMotion]](e, m_movementDelta);
             }
         }
-        else
+
+        for (const auto& evt : m_downEvents)
         {
-            if (input.active)
+            queryGrid(evt.position, m_candidates);
+            for (auto e : m_candidates)
             {
-                //mouse left
-                input.active = false;
-                m_movementCallbacks[input.callbacks[UIInput::MouseExit]](e, m_movementDelta);
+                m_buttonCallbacks[e.getComponent<UIInput>().callbacks[UIInput::MouseDown]](e, evt.flag);
             }
         }
+        for (const auto& evt : m_upEvents)
+        {
+            queryGrid(evt.position, m_candidates);
+            for (auto e : m_candidates)
+            {
+                m_buttonCallbacks[e.getComponent<UIInput>().callbacks[UIInput::MouseUp]](e, evt.flag);
+            }
+        }
+    }
+
+    if (!m_touches.empty())
+    {
+        processTouches(dt.asSeconds());
     }
 
     //DPRINT("Window Pos", std::to_string(m_eventPosition.x) + ", " + std::to_string(m_eventPosition.y));
@@ -197,6 +332,203 @@ uint32 UISystem::addCallback(const MovementCallback& cb)
 }
 
 //private
+void UISystem::updateGrid()
+{
+    auto& entities = getEntities();
+    for (auto& e : entities)
+    {
+        //the world transform is only read when its revision shows it changed
+        auto& input = e.getComponent<UIInput>();
+        const auto& transform = e.getComponent<Transform>();
+
+        if (!input.m_inGrid
+            || transform.getRevision() != input.m_transformRevision
+            || !equal(input.area, input.m_previousArea))
+        {
+            removeFromGrid(e);
+
+            auto tx = transform.getWorldTransform();
+            input.m_transformRevision = transform.getRevision();
+            input.m_previousArea = input.area;
+            input.m_worldArea = input.area.transform(tx);
+            input.m_depth = tx[3][2];
+
+            addToGrid(e);
+            m_queryPending = true;
+        }
+    }
+}
+
+void UISystem::addToGrid(Entity entity)
+{
+    auto& input = entity.getComponent<UIInput>();
+    forEachCell(input.m_worldArea, [entity, this](uint64 key)
+    {
+        m_grid[key].push_back(entity);
+    });
+    input.m_inGrid = true;
+}
+
+void UISystem::removeFromGrid(Entity entity)
+{
+    auto& input = entity.getComponent<UIInput>();
+    if (!input.m_inGrid)
+    {
+        return;
+    }
+
+    forEachCell(input.m_worldArea, [entity, this](uint64 key)
+    {
+        auto result = m_grid.find(key);
+        if (result != m_grid.end())
+        {
+            auto& cell = result->second;
+            cell.erase(std::remove(cell.begin(), cell.end(), entity), cell.end());
+            if (cell.empty())
+            {
+                m_grid.erase(result);
+            }
+        }
+    });
+    input.m_inGrid = false;
+}
+
+void UISystem::queryGrid(glm::vec2 position, std::vector<Entity>& results)
+{
+    results.clear();
+
+    auto testCell = [position, &results, this](uint64 key)
+    {
+        auto result = m_grid.find(key);
+        if (result != m_grid.end())
+        {
+            for (auto e : result->second)
+            {
+                if (e.getComponent<UIInput>().m_worldArea.contains(position))
+                {
+                    results.push_back(e);
+                }
+            }
+        }
+    };
+    testCell(getCellKey(toCell(position.x), toCell(position.y)));
+    testCell(OversizeKey);
+
+    //controls nearest the camera come first
+    std::stable_sort(results.begin(), results.end(),
+        [](Entity a, Entity b)
+    {
+        return a.getComponent<UIInput>().m_depth > b.getComponent<UIInput>().m_depth;
+    });
+}
+
+void UISystem::processTouches(float dt)
+{
+    std::size_t activeCount = 0;
+    for (const auto& touch : m_touches)
+    {
+        if (!touch.released) activeCount++;
+    }
+
+    for (auto& touch : m_touches)
+    {
+        touch.duration += dt;
+
+        //drags are only single finger, else they're a pinch
+        if (!touch.dragging
+            && glm::length2(touch.position - touch.start) > (DragThreshold * DragThreshold))
+        {
+            touch.dragging = true;
+        }
+
+        if (touch.dragging && activeCount < 2
+            && touch.position != touch.previousPosition)
+        {
+            auto delta = toWorldCoords(touch.position.x, touch.position.y) - toWorldCoords(touch.previousPosition.x, touch.previousPosition.y);
+            for (auto e : touch.targets)
+            {
+                m_movementCallbacks[e.getComponent<UIInput>().callbacks[UIInput::Drag]](e, delta);
+            }
+        }
+
+        if (touch.dragging)
+        {
+            touch.previousPosition = touch.position;
+        }
+
+        if (touch.released && touch.duration <= SwipeTime
+            && glm::length2(touch.position - touch.start) >= (SwipeDistance * SwipeDistance))
+        {
+            auto delta = toWorldCoords(touch.position.x, touch.position.y) - toWorldCoords(touch.start.x, touch.start.y);
+            for (auto e : touch.targets)
+            {
+                m_movementCallbacks[e.getComponent<UIInput>().callbacks[UIInput::Swipe]](e, delta);
+            }
+        }
+    }
+
+    if (activeCount == 2)
+    {
+        auto first = std::find_if(m_touches.begin(), m_touches.end(), [](const Touch& t) { return !t.released; });
+        auto second = std::find_if(first + 1, m_touches.end(), [](const Touch& t) { return !t.released; });
+
+        //measured in world coords so the aspect ratio is correct
+        auto a = toWorldCoords(first->position.x, first->position.y);
+        auto b = toWorldCoords(second->position.x, second->position.y);
+        auto distance = glm::length(b - a);
+        auto angle = std::atan2(b.y - a.y, b.x - a.x);
+
+        if (!m_pinching)
+        {
+            m_pinching = true;
+            queryGrid((a + b) / 2.f, m_pinchTargets);
+        }
+        else if (distance != m_pinchDistance || angle != m_pinchAngle)
+        {
+            glm::vec2 pinch(1.f, angle - m_pinchAngle);
+            if (m_pinchDistance > 0)
+            {
+                pinch.x = distance / m_pinchDistance;
+            }
+
+            const float pi = 3.14159265f;
+            if (pinch.y > pi) pinch.y -= pi * 2.f;
+            else if (pinch.y < -pi) pinch.y += pi * 2.f;
+
+            for (auto e : m_pinchTargets)
+            {
+                m_movementCallbacks[e.getComponent<UIInput>().callbacks[UIInput::Pinch]](e, pinch);
+            }
+        }
+        m_pinchDistance = distance;
+        m_pinchAngle = angle;
+    }
+    else
+    {
+        m_pinching = false;
+        m_pinchTargets.clear();
+    }
+
+    m_touches.erase(std::remove_if(m_touches.begin(), m_touches.end(),
+        [](const Touch& t) { return t.released; }), m_touches.end());
+}
+
+void UISystem::onEntityAdded(Entity entity)
+{
+    entity.getComponent<UIInput>().m_inGrid = false;
+}
+
+void UISystem::onEntityRemoved(Entity entity)
+{
+    removeFromGrid(entity);
+    m_hitEntities.erase(std::remove(m_hitEntities.begin(), m_hitEntities.end(), entity), m_hitEntities.end());
+    m_pinchTargets.erase(std::remove(m_pinchTargets.begin(), m_pinchTargets.end(), entity), m_pinchTargets.end());
+    for (auto& touch : m_touches)
+    {
+        touch.targets.erase(std::remove(touch.targets.begin(), touch.targets.end(), entity), touch.targets.end());
+    }
+}
+
 glm::vec2 UISystem::toWorldCoords(int32 x, int32 y)
 {
     auto vpX = static_cast<float>(x) / m_windowSize.x;
@@ -34,19 +34,51 @@ source distribution.
 #include <SDL_ttf.h>
 #include <SDL_pixels.h>
 #include <SDL_surface.h>
+#include <SDL_rwops.h>
 
-#include <array>
+#include <algorithm>
 #include <cstring>
+#include <cmath>
 
 using namespace cro;
 
 namespace
 {
     const uint16 defaultCharSize = 30u; //char size in pixels
-    const uint16 firstChar = 32; //space in ascii
-    const uint16 lastChar = 255; //extended ascii end
-    const uint16 charCount = lastChar - firstChar;
-    const uint16 charCountX = 16; //chars horizontally
+    const uint32 minPageSize = 256;
+    const uint32 maxPageSize = 2048;
+    const uint32 glyphsPerRow = 16; //used to estimate the page size from the line height
+    const uint32 padding = 1; //space between glyphs to prevent bleeding when sampled
+
+    //SDF glyphs are rasterised once at this size and scaled to all others
+    const uint32 sdfCharSize = 32u;
+    const float sdfSpread = 4.f; //distance in pixels either side of an edge stored in the field
+    const uint32 sdfBorder = static_cast<uint32>(std::ceil(sdfSpread)); //space around glyphs for the field
+
+    const uint32 cacheID = 0x46445343; //CSDF
+    const uint32 cacheVersion = 1;
+
+    struct CacheHeader final
+    {
+        uint32 id = cacheID;
+        uint32 version = cacheVersion;
+        uint32 charSize = sdfCharSize;
+        float spread = sdfSpread;
+        uint32 pageSize = 0;
+        float lineHeight = 0.f;
+        uint32 glyphCount = 0;
+        uint32 shelfCount = 0;
+        uint32 freeSlotCount = 0;
+    };
+
+    struct CacheGlyph final
+    {
+        uint32 codepoint = 0;
+        float rect[4] = {};
+        uint32 shelf = 0;
+        uint32 left = 0;
+        uint32 width = 0;
+    };
 
     //rounds n to nearest pow2 value for padding images
     uint32 pow2(uint32 n)
@@ -59,25 +91,37 @@ namespace
 
         return n;
     }
+
+    //slots are a multiple of 4 wide so that uploaded rows always
+    //satisfy the default unpack alignment of single channel textures
+    uint32 slotWidth(uint32 width)
+    {
+        return (width + padding + 3) & ~3u;
+    }
 }
 
+//a rasterised glyph waiting to be added to an atlas
+struct Font::GlyphData final
+{
+    Detail::DistanceField::Bitmap bitmap; //rows are stored top first
+    uint32 width = 0; //size of the glyph used when laying out text
+    uint32 height = 0;
+    uint32 border = 0; //space around the glyph in the bitmap
+};
+
 Font::Font()
-    : m_type        (Type::Bitmap),
-    m_font          (nullptr)
+    : m_type        (Type::Bitmap)
 {
 
 }
 
 Font::~Font()
 {
-    if (m_font)
-    {
-        TTF_CloseFont(m_font);
-    }
+    clearPages();
 }
 
 //public
-bool Font::loadFromFile(const std::string& path)
+bool Font::loadFromFile(const std::string& path, Type type)
 {
     if (TTF_WasInit() == 0)
     {
@@ -85,22 +129,16 @@ bool Font::loadFromFile(const std::string& path)
         return false;
     }
 
-    if (m_font)
-    {
-        TTF_CloseFont(m_font);
-        m_font = nullptr;
-    }
-
-    if (path != m_path)
+    if (path != m_path || type != m_type)
     {
-        m_pages.clear();
+        clearPages();
         m_path = path;
+        m_type = type;
         return createPage(defaultCharSize);
     }
 
     return false; //what if this font is already loaded? should be true in theory
 }
-
 bool Font::loadFromImage(const Image& image, glm::vec2 charSize, Type type)
 {
     CRO_ASSERT(image.getSize().x > 0 && image.getSize().y > 0, "Can't use empty image!");
@@ -134,30 +172,304 @@ bool Font::loadFromImage(const Image& image, glm::vec2 charSize, Type type)
     return false;
 }
 
-FloatRect Font::getGlyph(char c, uint32 charSize) const
+FloatRect Font::getGlyph(uint32 codepoint, uint32 charSize) const
 {
-    if (m_pages.count(charSize) == 0)
+    if (!createPage(charSize))
     {
-        if (!createPage(charSize))
+        return {};
+    }
+
+    Page& page = m_pages[getPageID(charSize)];
+    auto result = page.glyphs.find(codepoint);
+    if (result == page.glyphs.end())
+    {
+        if (!insertGlyph(page, codepoint))
         {
             return {};
         }
+        result = page.glyphs.find(codepoint);
     }
-    
-    Page& page = m_pages[charSize];
-    
-    if (page.subrects.count(c) == 0)
+
+    result->second.lastUsed = ++page.useCount;
+    return result->second.rect;
+}
+
+uint32 Font::getAtlasGeneration(uint32 charSize) const
+{
+    auto result = m_pages.find(getPageID(charSize));
+    return (result == m_pages.end()) ? 0 : result->second.generation;
+}
+
+bool Font::hasEvictedGlyphs(const std::vector<uint32>& codepoints, uint32 charSize, uint32 generation) const
+{
+    auto result = m_pages.find(getPageID(charSize));
+    if (result == m_pages.end())
     {
-        //TODO insert a new glyph
-        return {};
+        return false;
+    }
+
+    const auto& page = result->second;
+    if (generation < page.resetGeneration)
+    {
+        return true;
     }
-    return page.subrects.find(c)->second;
+
+    for (auto c : codepoints)
+    {
+        auto eviction = page.evictions.find(c);
+        if (eviction != page.evictions.end()
+            && eviction->second > generation)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Font::preloadGlyphs(const std::vector<uint32>& codepoints, uint32 charSize)
+{
+    if (!createPage(charSize))
+    {
+        return;
+    }
+
+    //SDL_ttf isn't thread safe, so glyphs are rasterised first
+    //and then converted to distance fields in parallel
+    Page& page = m_pages[getPageID(charSize)];
+    std::vector<std::pair<uint32, GlyphData>> glyphs;
+    for (auto c : codepoints)
+    {
+        if (page.glyphs.count(c) == 0
+            && std::find_if(glyphs.begin(), glyphs.end(), [c](const std::pair<uint32, GlyphData>& g) { return g.first == c; }) == glyphs.end())
+        {
+            GlyphData glyphData;
+            if (rasteriseGlyph(page, c, glyphData))
+            {
+                glyphs.push_back(std::make_pair(c, std::move(glyphData)));
+            }
+        }
+    }
+
+    if (m_type == Type::SDF)
+    {
+        std::vector<Detail::DistanceField::Bitmap> bitmaps(glyphs.size());
+        for (auto i = 0u; i < glyphs.size(); ++i)
+        {
+            bitmaps[i] = std::move(glyphs[i].second.bitmap);
+        }
+
+        Detail::DistanceField::toSDF(bitmaps, sdfSpread);
+
+        for (auto i = 0u; i < glyphs.size(); ++i)
+        {
+            glyphs[i].second.bitmap = std::move(bitmaps[i]);
+        }
+    }
+
+    for (const auto& g : glyphs)
+    {
+        addGlyph(page, g.first, g.second);
+    }
+}
+
+bool Font::saveCache(const std::string& path) const
+{
+    if (m_type != Type::SDF || m_pages.empty())
+    {
+        Logger::log("Only loaded SDF fonts can be written to a cache file", Logger::Type::Error);
+        return false;
+    }
+
+    const auto& page = m_pages.begin()->second;
+
+    CacheHeader header;
+    header.pageSize = page.texture.getSize().x;
+    header.lineHeight = page.lineHeight;
+    header.glyphCount = static_cast<uint32>(page.glyphs.size());
+    header.shelfCount = static_cast<uint32>(page.shelves.size());
+    header.freeSlotCount = static_cast<uint32>(page.freeSlots.size());
+
+    std::vector<CacheGlyph> glyphs;
+    for (const auto& g : page.glyphs)
+    {
+        CacheGlyph glyph;
+        glyph.codepoint = g.first;
+        glyph.rect[0] = g.second.rect.left;
+        glyph.rect[1] = g.second.rect.bottom;
+        glyph.rect[2] = g.second.rect.width;
+        glyph.rect[3] = g.second.rect.height;
+        glyph.shelf = static_cast<uint32>(g.second.slot.shelf);
+        glyph.left = g.second.slot.left;
+        glyph.width = g.second.slot.width;
+        glyphs.push_back(glyph);
+    }
+
+    std::vector<uint32> freeSlots;
+    for (const auto& slot : page.freeSlots)
+    {
+        freeSlots.push_back(static_cast<uint32>(slot.shelf));
+        freeSlots.push_back(slot.left);
+        freeSlots.push_back(slot.width);
+    }
+
+    auto* file = SDL_RWFromFile(path.c_str(), "wb");
+    if (!file)
+    {
+        Logger::log("Failed opening " + path + " for writing", Logger::Type::Error);
+        return false;
+    }
+
+    bool result = SDL_RWwrite(file, &header, sizeof(header), 1) == 1
+        && (glyphs.empty() || SDL_RWwrite(file, glyphs.data(), sizeof(CacheGlyph), glyphs.size()) == glyphs.size())
+        && (page.shelves.empty() || SDL_RWwrite(file, page.shelves.data(), sizeof(Shelf), page.shelves.size()) == page.shelves.size())
+        && (freeSlots.empty() || SDL_RWwrite(file, freeSlots.data(), sizeof(uint32), freeSlots.size()) == freeSlots.size())
+        && SDL_RWwrite(file, page.pixels.data(), page.pixels.size(), 1) == 1;
+    SDL_RWclose(file);
+
+    if (!result)
+    {
+        Logger::log("Failed writing font cache " + path, Logger::Type::Error);
+    }
+    return result;
+}
+
+bool Font::loadCache(const std::string& path)
+{
+    if (m_type != Type::SDF && !m_pages.empty())
+    {
+        Logger::log("Font cache " + path + " can only be loaded in to an SDF font", Logger::Type::Error);
+        return false;
+    }
+
+    auto* file = SDL_RWFromFile(path.c_str(), "rb");
+    if (!file)
+    {
+        Logger::log("Failed opening font cache " + path, Logger::Type::Error);
+        return false;
+    }
+
+    CacheHeader header;
+    if (SDL_RWread(file, &header, sizeof(header), 1) != 1
+        || header.id != cacheID || header.version != cacheVersion)
+    {
+        SDL_RWclose(file);
+        Logger::log(path + " is not a valid font cache", Logger::Type::Error);
+        return false;
+    }
+
+    if (header.charSize != sdfCharSize || header.spread != sdfSpread
+        || header.pageSize < minPageSize || header.pageSize > maxPageSize)
+    {
+        SDL_RWclose(file);
+        Logger::log(path + " was created with different SDF settings and needs to be generated again", Logger::Type::Error);
+        return false;
+    }
+
+    //make sure the counts match the file before allocating anything with them
+    const uint64 expectedSize = sizeof(header)
+        + (static_cast<uint64>(header.glyphCount) * sizeof(CacheGlyph))
+        + (static_cast<uint64>(header.shelfCount) * sizeof(Shelf))
+        + (static_cast<uint64>(header.freeSlotCount) * 3 * sizeof(uint32))
+        + (static_cast<uint64>(header.pageSize) * header.pageSize);
+    if (SDL_RWsize(file) != static_cast<int64>(expectedSize))
+    {
+        SDL_RWclose(file);
+        Logger::log(path + " is not a valid font cache", Logger::Type::Error);
+        return false;
+    }
+
+    std::vector<CacheGlyph> glyphs(header.glyphCount);
+    std::vector<Shelf> shelves(header.shelfCount);
+    std::vector<uint32> freeSlots(header.freeSlotCount * 3);
+    std::vector<uint8> pixels(header.pageSize * header.pageSize);
+
+    bool result = (glyphs.empty() || SDL_RWread(file, glyphs.data(), sizeof(CacheGlyph), glyphs.size()) == glyphs.size())
+        && (shelves.empty() || SDL_RWread(file, shelves.data(), sizeof(Shelf), shelves.size()) == shelves.size())
+        && (freeSlots.empty() || SDL_RWread(file, freeSlots.data(), sizeof(uint32), freeSlots.size()) == freeSlots.size())
+        && SDL_RWread(file, pixels.data(), pixels.size(), 1) == 1;
+    SDL_RWclose(file);
+
+    if (!result)
+    {
+        Logger::log("Failed reading font cache " + path, Logger::Type::Error);
+        return false;
+    }
+
+    //the atlas is indexed with these values so reject anything which lies outside it
+    const uint64 pageSize = header.pageSize;
+    auto validSlot = [&](uint64 shelf, uint64 left, uint64 width)
+    {
+        return shelf < shelves.size() && left + width <= pageSize;
+    };
+    auto validRect = [pageSize](const float* rect)
+    {
+        //written so that NaN fails
+        return rect[0] >= 0.f && rect[1] >= 0.f && rect[2] >= 0.f && rect[3] >= 0.f
+            && rect[0] + rect[2] <= pageSize && rect[1] + rect[3] <= pageSize;
+    };
+
+    bool valid = true;
+    for (const auto& shelf : shelves)
+    {
+        valid = valid && static_cast<uint64>(shelf.bottom) + shelf.height <= pageSize && shelf.width <= pageSize;
+    }
+    for (const auto& g : glyphs)
+    {
+        valid = valid && validSlot(g.shelf, g.left, g.width) && validRect(g.rect);
+    }
+    for (auto i = 0u; i < freeSlots.size(); i += 3)
+    {
+        valid = valid && validSlot(freeSlots[i], freeSlots[i + 1], freeSlots[i + 2]);
+    }
+
+    if (!valid)
+    {
+        Logger::log(path + " contains glyphs outside of the atlas and needs to be generated again", Logger::Type::Error);
+        return false;
+    }
+
+    //keep the ttf font, if there is one, so missing glyphs can still be added
+    m_type = Type::SDF;
+    Page& page = m_pages[getPageID(sdfCharSize)];
+    page.lineHeight = header.lineHeight;
+    page.shelves.swap(shelves);
+    page.pixels.swap(pixels);
+
+    page.glyphs.clear();
+    for (const auto& g : glyphs)
+    {
+        AtlasGlyph glyph;
+        glyph.rect = { g.rect[0], g.rect[1], g.rect[2], g.rect[3] };
+        glyph.slot.shelf = g.shelf;
+        glyph.slot.left = g.left;
+        glyph.slot.width = g.width;
+        page.glyphs.insert(std::make_pair(g.codepoint, glyph));
+    }
+
+    page.freeSlots.clear();
+    for (auto i = 0u; i < freeSlots.size(); i += 3)
+    {
+        Slot slot;
+        slot.shelf = freeSlots[i];
+        slot.left = freeSlots[i + 1];
+        slot.width = freeSlots[i + 2];
+        page.freeSlots.push_back(slot);
+    }
+
+    //any existing text layouts are no longer valid
+    page.generation++;
+    page.resetGeneration = page.generation;
+    page.evictions.clear();
+
+    page.texture.create(header.pageSize, header.pageSize, ImageFormat::A);
+    page.texture.setSmooth(true);
+    return page.texture.update(page.pixels.data(), false);
 }
 
 const Texture& Font::getTexture(uint32 charSize) const
 {
     createPage(charSize);
-    return m_pages[charSize].texture;
+    return m_pages[getPageID(charSize)].texture;
 }
 
 Font::Type Font::getType() const
@@ -168,126 +480,335 @@ Font::Type Font::getType() const
 float Font::getLineHeight(uint32 charSize) const
 {
     createPage(charSize);
-    return m_pages[charSize].lineHeight;
+    return m_pages[getPageID(charSize)].lineHeight * getScale(charSize);
+}
+
+float Font::getScale(uint32 charSize) const
+{
+    return (m_type == Type::SDF) ? static_cast<float>(charSize) / sdfCharSize : 1.f;
+}
+
+float Font::getSmoothing(uint32 charSize) const
+{
+    //half a screen pixel either side of the edge
+    return (m_type == Type::SDF) ? 0.25f / (sdfSpread * getScale(charSize)) : 0.f;
 }
 
 //private
+uint32 Font::getPageID(uint32 charSize) const
+{
+    //all sizes of SDF font share the same page
+    return (m_type == Type::SDF) ? sdfCharSize : charSize;
+}
+
 bool Font::createPage(uint32 charSize) const
 {
-    if (m_pages.count(charSize) > 0) return true;
-    
-    m_font = TTF_OpenFont(m_path.c_str(), charSize);
-    if (m_font)
-    {
-        m_pages.insert(std::make_pair(charSize, Page()));
-        Page& page = m_pages[charSize];
-        
-        int32 celWidth = 0;
-        int32 celHeight = 0;
-        page.lineHeight = static_cast<float>(TTF_FontHeight(m_font));
-
-        std::array<GlyphData, charCount> glyphData;
-        std::array<MetricData, charCount> metricData;
-        SDL_Color black, white;
-        black.r = 0; black.g = 0; black.b = 0; black.a = 255;
-        white.r = 255; white.g = 255; white.b = 255; white.a = 255;
-        for (auto i = firstChar; i < lastChar; ++i) //start at 32 (Space)
+    auto pageID = getPageID(charSize);
+    if (m_pages.count(pageID) > 0) return true;
+
+    auto* font = TTF_OpenFont(m_path.c_str(), pageID);
+    if (font)
+    {
+        Page& page = m_pages[pageID];
+        page.font = font;
+        page.lineHeight = static_cast<float>(TTF_FontHeight(font));
+
+        //glyphs are added on demand, so the page is sized to
+        //hold several rows of glyphs at this character size
+        auto border = (m_type == Type::SDF) ? sdfBorder * 2 : 0;
+        auto size = pow2(static_cast<uint32>(page.lineHeight + border + padding) * glyphsPerRow);
+        size = std::max(minPageSize, std::min(size, maxPageSize));
+
+        std::vector<uint8> imgData(size * size);
+        std::memset(imgData.data(), 0, imgData.size());
+        page.texture.create(size, size, ImageFormat::A);
+
+        if (m_type == Type::SDF)
         {
-            auto index = i - firstChar;
+            //distance fields are interpolated to create smooth edges at any scale
+            page.texture.setSmooth(true);
+            page.pixels = imgData;
+        }
 
-            TTF_GlyphMetrics(m_font, i, &metricData[index].minx, &metricData[index].maxx, &metricData[index].miny, &metricData[index].maxy, 0);
+        return page.texture.update(imgData.data(), false);
+    }
+    else
+    {
+        Logger::log("Failed opening font " + m_path + " at size " + std::to_string(pageID), Logger::Type::Error);
+    }
+    return false;
+}
 
-            auto* glyph = TTF_RenderGlyph_Shaded(m_font, i, white, black);
-            if (glyph)
-            {
-                glyphData[index].width = glyph->pitch;
-                glyphData[index].height = glyph->h;
-                //glyphData[index].data = Detail::DistanceField::toDF(glyph);
-                glyphData[index].data.resize(glyph->pitch * glyph->h);
-                auto stride = glyph->format->BytesPerPixel;
-                char* pixels = static_cast<char*>(glyph->pixels);
-                for (auto j = 0u, k = 0u; j < glyphData[index].data.size(); ++j, k += stride)
-                {
-                    glyphData[index].data[j] = pixels[k];
-                }
-
-                if (glyph->w > celWidth)
-                {
-                    celWidth = glyph->w;
-                }
-                if (glyph->h > celHeight)
-                {
-                    celHeight = glyph->h;
-                }
-
-                SDL_FreeSurface(glyph);
-
-                //TODO process distance field on glyph and mark font as distance field type
+bool Font::insertGlyph(Page& page, uint32 codepoint) const
+{
+    GlyphData glyphData;
+    if (!rasteriseGlyph(page, codepoint, glyphData))
+    {
+        return false;
+    }
 
-            }
-            else
-            {
-                glyphData[index].width = 0;
-                glyphData[index].height = 0;
-            }
+    if (m_type == Type::SDF)
+    {
+        Detail::DistanceField::toSDF(glyphData.bitmap, sdfSpread);
+    }
+
+    return addGlyph(page, codepoint, glyphData);
+}
+
+bool Font::rasteriseGlyph(const Page& page, uint32 codepoint, GlyphData& glyphData) const
+{
+    if (!page.font
+        || codepoint > 0xFFFF) //SDL_ttf only supports the basic multilingual plane
+    {
+        return false;
+    }
+
+    int32 minx = 0, maxx = 0, miny = 0, maxy = 0, advance = 0;
+    auto ch = static_cast<uint16>(codepoint);
+    if (TTF_GlyphMetrics(page.font, ch, &minx, &maxx, &miny, &maxy, &advance) != 0)
+    {
+        return false;
+    }
+
+    SDL_Color black, white;
+    black.r = 0; black.g = 0; black.b = 0; black.a = 255;
+    white.r = 255; white.g = 255; white.b = 255; white.a = 255;
+    auto* glyph = TTF_RenderGlyph_Shaded(page.font, ch, white, black);
+    if (!glyph)
+    {
+        return false;
+    }
+
+    //the width used when laying out text. Glyphs such as space have no pixels
+    //so they use the advance instead
+    glyphData.width = static_cast<uint32>((maxx < 1) ? advance : maxx + 1);
+    glyphData.height = static_cast<uint32>(glyph->h);
+    glyphData.border = (m_type == Type::SDF) ? sdfBorder : 0;
+
+    //SDF glyphs have a border so the field can extend beyond the edges
+    auto& bitmap = glyphData.bitmap;
+    bitmap.width = static_cast<int32>(std::max(glyphData.width, static_cast<uint32>(glyph->w)) + (glyphData.border * 2));
+    bitmap.height = static_cast<int32>(glyphData.height + (glyphData.border * 2));
+    bitmap.pixels.assign(bitmap.width * bitmap.height, 0);
+
+    auto stride = glyph->format->BytesPerPixel;
+    const auto* pixels = static_cast<const uint8*>(glyph->pixels);
+    for (auto y = 0; y < glyph->h; ++y)
+    {
+        const auto* src = pixels + (y * glyph->pitch);
+        auto* dst = &bitmap.pixels[((y + glyphData.border) * bitmap.width) + glyphData.border];
+        for (auto x = 0; x < glyph->w; ++x)
+        {
+            dst[x] = src[x * stride];
+        }
+    }
+    SDL_FreeSurface(glyph);
+
+    return true;
+}
+
+bool Font::addGlyph(Page& page, uint32 codepoint, const GlyphData& glyphData) const
+{
+    const auto& bitmap = glyphData.bitmap;
+    auto bitmapWidth = static_cast<uint32>(bitmap.width);
+    auto bitmapHeight = static_cast<uint32>(bitmap.height);
+
+    Slot slot;
+    if (!allocateSlot(page, slotWidth(bitmapWidth), bitmapHeight + padding, slot))
+    {
+        LOG("Font atlas full, unable to add glyph " + std::to_string(codepoint), Logger::Type::Warning);
+        return false;
+    }
+    const auto& shelf = page.shelves[slot.shelf];
+
+    //copy the glyph upside down as texture rows start at the bottom.
+    //The entire slot is written so that any previous glyph is cleared
+    std::vector<uint8> imgData(slot.width * shelf.height);
+    std::memset(imgData.data(), 0, imgData.size());
+    auto copyWidth = std::min(bitmapWidth, slot.width);
+    for (auto y = 0u; y < bitmapHeight; ++y)
+    {
+        const auto* src = &bitmap.pixels[(bitmapHeight - 1 - y) * bitmapWidth];
+        std::memcpy(&imgData[y * slot.width], src, copyWidth);
+    }
+
+    page.texture.update(imgData.data(), false, { slot.left, shelf.bottom, slot.width, shelf.height });
+
+    if (!page.pixels.empty())
+    {
+        auto pageWidth = page.texture.getSize().x;
+        for (auto y = 0u; y < shelf.height; ++y)
+        {
+            std::memcpy(&page.pixels[((shelf.bottom + y) * pageWidth) + slot.left], &imgData[y * slot.width], slot.width);
         }
+    }
 
+    //the glyph rect excludes any border so that text is laid out the same for both font types
+    AtlasGlyph atlasGlyph;
+    atlasGlyph.rect = { static_cast<float>(slot.left + glyphData.border), static_cast<float>(shelf.bottom + glyphData.border),
+                        static_cast<float>(glyphData.width), static_cast<float>(glyphData.height) };
+    atlasGlyph.slot = slot;
+    page.glyphs.insert(std::make_pair(codepoint, atlasGlyph));
 
-        //load the glyphs into an image atlas
-        auto imgWidth = pow2(celWidth * charCountX);
-        auto glyphCountX = imgWidth / celWidth;
-        auto glyphCountY = (charCount / glyphCountX) + 1;
-        auto imgHeight = pow2(celHeight * glyphCountY);
-        auto imgSize = imgWidth * imgHeight;
+    return true;
+}
 
-        std::vector<uint8> imgData(imgSize);
-        std::memset(imgData.data(), 0, imgSize);
-        FloatRect subRect(0.f, 0.f, static_cast<float>(celWidth), static_cast<float>(celHeight));
+bool Font::allocateSlot(Page& page, uint32 width, uint32 height, Slot& slot) const
+{
+    const auto pageSize = page.texture.getSize();
+
+    auto takeSlot = [&](Slot freeSlot)
+    {
+        slot = freeSlot;
+        slot.width = width;
+
+        //return any unused width to the free list
+        if (freeSlot.width > width)
+        {
+            freeSlot.left += width;
+            freeSlot.width -= width;
+            page.freeSlots.push_back(freeSlot);
+        }
+    };
 
-        std::size_t i = firstChar;
-        for (auto y = 0u; y < glyphCountY; ++y)
+    //reuse space left by an evicted glyph
+    auto bestFree = page.freeSlots.end();
+    for (auto it = page.freeSlots.begin(); it != page.freeSlots.end(); ++it)
+    {
+        if (it->width >= width && page.shelves[it->shelf].height >= height
+            && (bestFree == page.freeSlots.end() || it->width < bestFree->width))
         {
-            for (auto x = 0u; x < glyphCountX && i < lastChar; ++x, ++i)
+            bestFree = it;
+        }
+    }
+    if (bestFree != page.freeSlots.end())
+    {
+        auto freeSlot = *bestFree;
+        page.freeSlots.erase(bestFree);
+        takeSlot(freeSlot);
+        return true;
+    }
+
+    //add to the end of the shortest shelf which will fit
+    auto bestShelf = page.shelves.size();
+    for (auto i = 0u; i < page.shelves.size(); ++i)
+    {
+        const auto& shelf = page.shelves[i];
+        if (shelf.height >= height && pageSize.x - shelf.width >= width
+            && (bestShelf == page.shelves.size() || shelf.height < page.shelves[bestShelf].height))
+        {
+            bestShelf = i;
+        }
+    }
+
+    //else open a new shelf
+    if (bestShelf == page.shelves.size())
+    {
+        auto top = page.shelves.empty() ? 0 : page.shelves.back().bottom + page.shelves.back().height;
+        if (top + height <= pageSize.y && width <= pageSize.x)
+        {
+            Shelf shelf;
+            shelf.bottom = top;
+            shelf.height = height;
+            page.shelves.push_back(shelf);
+        }
+    }
+
+    if (bestShelf < page.shelves.size())
+    {
+        auto& shelf = page.shelves[bestShelf];
+        slot.shelf = bestShelf;
+        slot.left = shelf.width;
+        slot.width = width;
+        shelf.width += width;
+        return true;
+    }
+
+    //the page is full, so replace the least recently used glyph which has enough space
+    auto oldest = page.glyphs.end();
+    for (auto it = page.glyphs.begin(); it != page.glyphs.end(); ++it)
+    {
+        if (it->second.slot.width >= width && page.shelves[it->second.slot.shelf].height >= height
+            && (oldest == page.glyphs.end() || it->second.lastUsed < oldest->second.lastUsed))
+        {
+            oldest = it;
+        }
+    }
+
+    if (oldest != page.glyphs.end())
+    {
+        auto freeSlot = oldest->second.slot;
+        evict(page, oldest);
+        takeSlot(freeSlot);
+        return true;
+    }
+
+    //no single glyph is wide enough so empty the least recently used shelf
+    auto shelfIndex = page.shelves.size();
+    uint64 shelfLastUsed = 0;
+    for (auto i = 0u; i < page.shelves.size(); ++i)
+    {
+        if (page.shelves[i].height < height)
+        {
+            continue;
+        }
+
+        uint64 lastUsed = 0;
+        for (const auto& g : page.glyphs)
+        {
+            if (g.second.slot.shelf == i)
             {
-                auto cx = celWidth * x;
-                auto cy = celHeight * y;
-
-                auto index = i - firstChar;
-                subRect.left = static_cast<float>(cx);
-                subRect.bottom = static_cast<float>(imgHeight - (cy + celHeight));
-                subRect.width = static_cast<float>((metricData[index].maxx < 1) ? celWidth / 2 : metricData[index].maxx + 1);
-                page.subrects.insert(std::make_pair(static_cast<uint8>(i), subRect));
-
-                //copy row by row
-                for (auto j = 0u; j < glyphData[index].height; ++j)
-                {
-                    std::memcpy(&imgData[((j + cy) * imgWidth) + cx], &glyphData[index].data[j * glyphData[index].width], glyphData[index].width);
-                }
+                lastUsed = std::max(lastUsed, g.second.lastUsed);
             }
         }
 
-        //flip
-        std::vector<uint8> flippedData(imgData.size());
-        auto dst = flippedData.data();
-        auto src = imgData.data() + ((flippedData.size()) - imgWidth);
-        for (i = 0u; i < imgHeight; ++i)
+        if (shelfIndex == page.shelves.size() || lastUsed < shelfLastUsed)
         {
-            std::memcpy(dst, src, imgWidth);
-            dst += imgWidth;
-            src -= imgWidth;
+            shelfIndex = i;
+            shelfLastUsed = lastUsed;
         }
+    }
 
-        page.texture.create(imgWidth, imgHeight, ImageFormat::A);
-        //page.texture.setSmooth(true);
-
-        TTF_CloseFont(m_font);
-        m_font = nullptr;
+    if (shelfIndex == page.shelves.size() || width > pageSize.x)
+    {
+        return false;
+    }
 
-        return page.texture.update(flippedData.data());
+    for (auto it = page.glyphs.begin(); it != page.glyphs.end();)
+    {
+        auto current = it++;
+        if (current->second.slot.shelf == shelfIndex)
+        {
+            evict(page, current);
+        }
     }
-    else
+    page.freeSlots.erase(std::remove_if(page.freeSlots.begin(), page.freeSlots.end(),
+        [shelfIndex](const Slot& s) { return s.shelf == shelfIndex; }), page.freeSlots.end());
+
+    auto& shelf = page.shelves[shelfIndex];
+    slot.shelf = shelfIndex;
+    slot.left = 0;
+    slot.width = width;
+    shelf.width = width;
+    return true;
+}
+
+void Font::evict(Page& page, std::map<uint32, AtlasGlyph>::iterator glyph) const
+{
+    //any text using the old glyph needs to fetch its glyphs again
+    page.generation++;
+    page.evictions[glyph->first] = page.generation;
+    page.glyphs.erase(glyph);
+}
+
+void Font::clearPages()
+{
+    for (auto& page : m_pages)
     {
-        Logger::log("Failed opening font " + m_path + " at size " + std::to_string(charSize), Logger::Type::Error);
+        if (page.second.font)
+        {
+            TTF_CloseFont(page.second.font);
+        }
     }
-    return false;
+    m_pages.clear();
 }
\ No newline at end of file
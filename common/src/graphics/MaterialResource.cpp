@@ -125,6 +125,16 @@ Material::Data& MaterialResource::add(int32 ID, const Shader& shader)
             data.uniforms[Material::ShadowMapProjection] = uniform.second;
             data.optionalUniforms[data.optionalUniformCount++] = Material::ShadowMapProjection;
         }
+        else if (uniform.first == "u_cascadeViewProjectionMatrix[0]")
+        {
+            data.uniforms[Material::ShadowMapCascades] = uniform.second;
+            data.optionalUniforms[data.optionalUniformCount++] = Material::ShadowMapCascades;
+        }
+        else if (uniform.first == "u_cascadeCount")
+        {
+            data.uniforms[Material::ShadowMapCascadeCount] = uniform.second;
+            data.optionalUniforms[data.optionalUniformCount++] = Material::ShadowMapCascadeCount;
+        }
         else if (uniform.first == "u_shadowMap")
         {
             data.uniforms[Material::ShadowMapSampler] = uniform.second;
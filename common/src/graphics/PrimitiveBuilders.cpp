@@ -96,7 +96,7 @@ Mesh::Data QuadBuilder::build() const
 
     //spatial bounds
     meshData.boundingBox[0] = { -halfSizeX, -halfSizeY, -0.01f };
-    meshData.boundingBox[1] = { halfSizeX, halfSizeX, 0.01f };
+    meshData.boundingBox[1] = { halfSizeX, halfSizeY, 0.01f };
     meshData.boundingSphere.radius = glm::length(meshData.boundingBox[0]);
 
     return meshData;
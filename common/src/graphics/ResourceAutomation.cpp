@@ -49,6 +49,70 @@ namespace
     {
         {"VertexLit", "Unlit"}
     };
+
+    std::unique_ptr<MeshBuilder> createMeshBuilder(const ConfigObject& cfg, const std::string& path, bool& checkSkeleton)
+    {
+        auto meshPath = cfg.findProperty("mesh");
+        if (!meshPath)
+        {
+            Logger::log(path + ": " + cfg.getName() + " node contains no mesh value", Logger::Type::Error);
+            return nullptr;
+        }
+
+        const std::string& meshValue = meshPath->getValue<std::string>();
+        auto ext = Util::String::getFileExtension(meshValue);
+        std::unique_ptr<MeshBuilder> meshBuilder;
+        if (ext == ".cmf")
+        {
+            //we have a static mesh
+            meshBuilder = std::make_unique<StaticMeshBuilder>(meshValue);
+        }
+        else if (ext == ".iqm")
+        {
+            //use iqm loader
+            meshBuilder = std::make_unique<IqmBuilder>(meshValue);
+            checkSkeleton = true;
+        }
+        else if (Util::String::toLower(meshValue) == "sphere")
+        {
+            if (auto* prop = cfg.findProperty("radius"))
+            {
+                float rad = prop->getValue<float>();
+                meshBuilder = std::make_unique<SphereBuilder>(rad, 8);
+            }
+        }
+        else if (Util::String::toLower(meshValue) == "cube")
+        {
+            meshBuilder = std::make_unique<CubeBuilder>();
+        }
+        else if (Util::String::toLower(meshValue) == "quad")
+        {
+            glm::vec2 uv(1.f);
+            if (auto* prop = cfg.findProperty("uv"))
+            {
+                uv = prop->getValue<glm::vec2>();
+            }
+        
+            if (auto* prop = cfg.findProperty("size"))
+            {
+                glm::vec2 size = prop->getValue<glm::vec2>();
+                meshBuilder = std::make_unique<QuadBuilder>(size, uv);
+            }
+        }
+        else
+        {
+            //t'aint valid bruh
+            Logger::log(ext + ": invalid model file type.", Logger::Type::Error);
+            return nullptr;
+        }
+
+        //check builder was created OK
+        if (!meshBuilder)
+        {
+            Logger::log(path + ": could not create mesh builder instance", Logger::Type::Error);
+        }
+        return meshBuilder;
+    }
 }
 
 bool ModelDefinition::loadFromFile(const std::string& path, ResourceCollection& rc)
@@ -71,66 +135,48 @@ bool ModelDefinition::loadFromFile(const std::string& path, ResourceCollection&
         return false;
     }
 
-    auto meshPath = cfg.findProperty("mesh");
-    if (!meshPath)
+    bool checkSkeleton = false;
+    auto meshBuilder = createMeshBuilder(cfg, path, checkSkeleton);
+    if (!meshBuilder)
     {
-        Logger::log(path + ": Model node contains no mesh value", Logger::Type::Error);
         return false;
     }
 
-    const std::string& meshValue = meshPath->getValue<std::string>();
-    auto ext = Util::String::getFileExtension(meshValue);
-    std::unique_ptr<MeshBuilder> meshBuilder;
-    bool checkSkeleton = false;
-    if (ext == ".cmf")
-    {
-        //we have a static mesh
-        meshBuilder = std::make_unique<StaticMeshBuilder>(meshValue);
-    }
-    else if (ext == ".iqm")
-    {
-        //use iqm loader
-        meshBuilder = std::make_unique<IqmBuilder>(meshValue);
-        checkSkeleton = true;
-    }
-    else if (Util::String::toLower(meshValue) == "sphere")
+    //check for optional levels of detail
+    std::vector<std::pair<std::unique_ptr<MeshBuilder>, LevelOfDetail>> lodBuilders;
+    for (const auto& obj : cfg.getObjects())
     {
-        if (auto* prop = cfg.findProperty("radius"))
+        if (Util::String::toLower(obj.getName()) == "lod")
         {
-            float rad = prop->getValue<float>();
-            meshBuilder = std::make_unique<SphereBuilder>(rad, 8);
-        }
-    }
-    else if (Util::String::toLower(meshValue) == "cube")
-    {
-        meshBuilder = std::make_unique<CubeBuilder>();
-    }
-    else if (Util::String::toLower(meshValue) == "quad")
-    {
-        glm::vec2 uv(1.f);
-        if (auto* prop = cfg.findProperty("uv"))
-        {
-            uv = prop->getValue<glm::vec2>();
-        }
-        
-        if (auto* prop = cfg.findProperty("size"))
-        {
-            glm::vec2 size = prop->getValue<glm::vec2>();
-            meshBuilder = std::make_unique<QuadBuilder>(size, uv);
+            bool isIqm = false;
+            auto lodBuilder = createMeshBuilder(obj, path, isIqm);
+            if (!lodBuilder)
+            {
+                return false;
+            }
+
+            LevelOfDetail lod;
+            if (auto* prop = obj.findProperty("distance"))
+            {
+                lod.distance = prop->getValue<float>();
+            }
+            if (auto* prop = obj.findProperty("screen_size"))
+            {
+                lod.screenSize = prop->getValue<float>();
+            }
+
+            if (lod.distance <= 0 && lod.screenSize <= 0)
+            {
+                Logger::log(path + ": LOD has no distance or screen_size value", Logger::Type::Error);
+                return false;
+            }
+            lodBuilders.emplace_back(std::move(lodBuilder), lod);
         }
     }
-    else
-    {
-        //t'aint valid bruh
-        Logger::log(ext + ": invalid model file type.", Logger::Type::Error);
-        return false;
-    }
 
-    //check builder was created OK
-    if (!meshBuilder)
+    if (auto* prop = cfg.findProperty("lod_hysteresis"))
     {
-        Logger::log(path + ": could not create mesh builder instance", Logger::Type::Error);
-        return false;
+        m_lodHysteresis = std::min(0.99f, std::max(0.f, prop->getValue<float>()));
     }
 
     //check we have at least one material with a valid shader type
@@ -169,6 +215,27 @@ bool ModelDefinition::loadFromFile(const std::string& path, ResourceCollection&
         return false;
     }
 
+    m_levelsOfDetail.clear();
+    const auto baseMesh = rc.meshes.getMesh(m_meshID);
+    for (auto& builder : lodBuilders)
+    {
+        auto lod = builder.second;
+        lod.meshID = rc.meshes.loadMesh(*builder.first.get());
+        if (lod.meshID == 0)
+        {
+            Logger::log(path + ": preloading LOD mesh failed", Logger::Type::Error);
+            continue;
+        }
+
+        //LODs share the model materials so need the same layout
+        if (rc.meshes.getMesh(lod.meshID).attributes != baseMesh.attributes)
+        {
+            Logger::log(path + ": LOD mesh has different vertex attributes to model mesh, skipping...", Logger::Type::Warning);
+            continue;
+        }
+        m_levelsOfDetail.push_back(lod);
+    }
+
     if (checkSkeleton)
     {
         auto skel = dynamic_cast<IqmBuilder*>(meshBuilder.get())->getSkeleton();
@@ -404,6 +471,12 @@ bool ModelDefinition::createModel(Entity entity, ResourceCollection& rc)
 
         }
 
+        for (const auto& lod : m_levelsOfDetail)
+        {
+            model.addLevelOfDetail(rc.meshes.getMesh(lod.meshID), lod.distance, lod.screenSize);
+        }
+        model.setLevelOfDetailHysteresis(m_lodHysteresis);
+
         if (hasSkeleton())
         {
             entity.addComponent<cro::Skeleton>() = *m_skeleton;
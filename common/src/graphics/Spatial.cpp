@@ -32,6 +32,9 @@ source distribution.
 #include <glm/vec3.hpp>
 #include <glm/geometric.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 using namespace cro;
 
 float Spatial::distance(Plane plane, glm::vec3 point)
@@ -67,4 +70,93 @@ Planar Spatial::intersects(Plane plane, Box box)
         return Planar::Intersection;
     }
     return (dist > 0) ? Planar::Front : Planar::Back;
+}
+
+Sphere Spatial::transform(const glm::mat4& matrix, Sphere sphere)
+{
+    sphere.centre = glm::vec3(matrix * glm::vec4(sphere.centre, 1.f));
+
+    const float scale = std::max(glm::length(glm::vec3(matrix[0])),
+        std::max(glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2]))));
+    sphere.radius *= scale;
+
+    return sphere;
+}
+
+Box Spatial::transform(const glm::mat4& matrix, Box box)
+{
+    const glm::vec3 centre = glm::vec3(matrix * glm::vec4((box[0] + box[1]) / 2.f, 1.f));
+    const glm::vec3 extents = (box[1] - box[0]) / 2.f;
+
+    //project the extents onto each world axis using the absolute of the rotation/scale
+    glm::vec3 worldExtents;
+    for (auto i = 0; i < 3; ++i)
+    {
+        worldExtents[i] = std::abs(matrix[0][i]) * extents.x
+            + std::abs(matrix[1][i]) * extents.y
+            + std::abs(matrix[2][i]) * extents.z;
+    }
+
+    return { centre - worldExtents, centre + worldExtents };
+}
+
+Frustum Spatial::getFrustum(const glm::mat4& viewProjection)
+{
+    Frustum frustum =
+    {
+        { Plane //left
+        (
+            viewProjection[0][3] + viewProjection[0][0],
+            viewProjection[1][3] + viewProjection[1][0],
+            viewProjection[2][3] + viewProjection[2][0],
+            viewProjection[3][3] + viewProjection[3][0]
+        ),
+        Plane //right
+        (
+            viewProjection[0][3] - viewProjection[0][0],
+            viewProjection[1][3] - viewProjection[1][0],
+            viewProjection[2][3] - viewProjection[2][0],
+            viewProjection[3][3] - viewProjection[3][0]
+        ),
+        Plane //bottom
+        (
+            viewProjection[0][3] + viewProjection[0][1],
+            viewProjection[1][3] + viewProjection[1][1],
+            viewProjection[2][3] + viewProjection[2][1],
+            viewProjection[3][3] + viewProjection[3][1]
+        ),
+        Plane //top
+        (
+            viewProjection[0][3] - viewProjection[0][1],
+            viewProjection[1][3] - viewProjection[1][1],
+            viewProjection[2][3] - viewProjection[2][1],
+            viewProjection[3][3] - viewProjection[3][1]
+        ),
+        Plane //near
+        (
+            viewProjection[0][3] + viewProjection[0][2],
+            viewProjection[1][3] + viewProjection[1][2],
+            viewProjection[2][3] + viewProjection[2][2],
+            viewProjection[3][3] + viewProjection[3][2]
+        ),
+        Plane //far
+        (
+            viewProjection[0][3] - viewProjection[0][2],
+            viewProjection[1][3] - viewProjection[1][2],
+            viewProjection[2][3] - viewProjection[2][2],
+            viewProjection[3][3] - viewProjection[3][2]
+        ) }
+    };
+
+    //normalise the planes
+    for (auto& p : frustum)
+    {
+        const float factor = 1.f / std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+        p.x *= factor;
+        p.y *= factor;
+        p.z *= factor;
+        p.w *= factor;
+    }
+
+    return frustum;
 }
\ No newline at end of file
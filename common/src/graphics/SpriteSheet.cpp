@@ -30,6 +30,8 @@ source distribution.
 #include <crogine/core/ConfigFile.hpp>
 #include <crogine/graphics/SpriteSheet.hpp>
 #include <crogine/graphics/TextureResource.hpp>
+#include <crogine/graphics/TextureAtlas.hpp>
+#include <crogine/graphics/Image.hpp>
 
 using namespace cro;
 
@@ -47,17 +49,53 @@ bool SpriteSheet::loadFromFile(const std::string& path, TextureResource& texture
         return false;
     }
 
-    m_sprites.clear();
+    Texture* texture = nullptr;
+    if (auto* p = sheetFile.findProperty("src"))
+    {
+        texture = &textures.get(p->getValue<std::string>());
+    }
+    else
+    {
+        LOG(sheetFile.getId() + " missing texture property", Logger::Type::Error);
+        return false;
+    }
 
-    std::size_t count = 0;
+    if (auto* p = sheetFile.findProperty("smooth"))
+    {
+        texture->setSmooth(p->getValue<bool>());
+    }
 
-    Texture* texture = nullptr;
-    Material::BlendMode blendMode = Material::BlendMode::Alpha;
+    return loadSprites(sheetFile, *texture, {});
+}
 
-    //validate sprites, increase count
+bool SpriteSheet::loadFromFile(const std::string& path, TextureAtlas& atlas)
+{
+    ConfigFile sheetFile;
+    if (!sheetFile.loadFromFile(path))
+    {
+        return false;
+    }
+
+    const TextureAtlas::Region* region = nullptr;
     if (auto* p = sheetFile.findProperty("src"))
     {
-        texture = &textures.get(p->getValue<std::string>());
+        auto imagePath = p->getValue<std::string>();
+        region = atlas.getRegion(imagePath);
+        if (!region)
+        {
+            Image image;
+            if (!image.loadFromFile(imagePath))
+            {
+                LOG("Failed to load " + imagePath, Logger::Type::Error);
+                return false;
+            }
+            region = atlas.add(imagePath, image);
+        }
+
+        if (!region)
+        {
+            return false;
+        }
     }
     else
     {
@@ -65,6 +103,45 @@ bool SpriteSheet::loadFromFile(const std::string& path, TextureResource& texture
         return false;
     }
 
+    if (auto* p = sheetFile.findProperty("smooth"))
+    {
+        //this applies to the entire atlas
+        atlas.setSmooth(p->getValue<bool>());
+    }
+
+    return loadSprites(sheetFile, *region->texture, region->area);
+}
+
+Sprite SpriteSheet::getSprite(const std::string& name) const
+{
+    if (m_sprites.count(name) != 0)
+    {
+        return m_sprites[name];
+    }
+    LOG(name + " not found in sprite sheet", Logger::Type::Warning);
+    return {};
+}
+
+//private
+bool SpriteSheet::loadSprites(const ConfigObject& sheetFile, const Texture& texture, URect area)
+{
+    m_sprites.clear();
+
+    std::size_t count = 0;
+    Material::BlendMode blendMode = Material::BlendMode::Alpha;
+
+    //when loaded in to an atlas all the sprite rects are offset by the image position
+    const bool useArea = (area.width > 0 && area.height > 0);
+    auto offsetRect = [useArea, area](FloatRect rect)
+    {
+        if (useArea)
+        {
+            rect.left += static_cast<float>(area.left);
+            rect.bottom += static_cast<float>(area.bottom);
+        }
+        return rect;
+    };
+
     if (auto* p = sheetFile.findProperty("blendmode"))
     {
         std::string mode = p->getValue<std::string>();
@@ -73,11 +150,6 @@ bool SpriteSheet::loadFromFile(const std::string& path, TextureResource& texture
         else if (mode == "none") blendMode = Material::BlendMode::None;
     }
 
-    if (auto* p = sheetFile.findProperty("smooth"))
-    {
-        texture->setSmooth(p->getValue<bool>());
-    }
-
     const auto& sheetObjs = sheetFile.getObjects();
     for (const auto& spr : sheetObjs)
     {
@@ -91,7 +163,12 @@ bool SpriteSheet::loadFromFile(const std::string& path, TextureResource& texture
             }
 
             Sprite spriteComponent;
-            spriteComponent.setTexture(*texture);
+            spriteComponent.setTexture(texture);
+            if (useArea)
+            {
+                spriteComponent.setTextureRect({ static_cast<float>(area.left), static_cast<float>(area.bottom),
+                    static_cast<float>(area.width), static_cast<float>(area.height) });
+            }
 
             if (auto* p = spr.findProperty("blendmode"))
             {
@@ -108,7 +185,7 @@ bool SpriteSheet::loadFromFile(const std::string& path, TextureResource& texture
 
             if (auto* p = spr.findProperty("bounds"))
             {
-                spriteComponent.setTextureRect(p->getValue<FloatRect>());
+                spriteComponent.setTextureRect(offsetRect(p->getValue<FloatRect>()));
             }
 
             if (auto* p = spr.findProperty("colour"))
@@ -128,7 +205,7 @@ bool SpriteSheet::loadFromFile(const std::string& path, TextureResource& texture
                         if (name == "frame")
                         {
                             auto& anim = spriteComponent.m_animations[spriteComponent.m_animationCount];
-                            anim.frames[anim.frameCount++] = p.getValue<FloatRect>();
+                            anim.frames[anim.frameCount++] = offsetRect(p.getValue<FloatRect>());
                         }
                         else if (name == "framerate")
                         {
@@ -151,13 +228,3 @@ bool SpriteSheet::loadFromFile(const std::string& path, TextureResource& texture
     //LOG("Found " + std::to_string(count) + " sprites in " + path, Logger::Type::Info);
     return count > 0;
 }
-
-Sprite SpriteSheet::getSprite(const std::string& name) const
-{
-    if (m_sprites.count(name) != 0)
-    {
-        return m_sprites[name];
-    }
-    LOG(name + " not found in sprite sheet", Logger::Type::Warning);
-    return {};
-}
@@ -0,0 +1,280 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include <crogine/graphics/StreamBuffer.hpp>
+#include <crogine/core/Log.hpp>
+#include <crogine/detail/Assert.hpp>
+
+#include "../detail/GLCheck.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace cro;
+
+namespace
+{
+    //keeps the start of each upload aligned for any vertex format
+    const std::size_t Alignment = 16;
+
+    //how long to wait for the GPU in nanoseconds before trying again
+    const GLuint64 WaitTimeout = 1000000000;
+
+    std::size_t align(std::size_t size)
+    {
+        return (size + (Alignment - 1)) & ~(Alignment - 1);
+    }
+}
+
+StreamBuffer::StreamBuffer(std::size_t capacity)
+    : m_vbo         (0),
+    m_capacity      (0),
+    m_offset        (0),
+    m_frameStart    (0),
+    m_frameUsed     (0),
+    m_useMapping    (false)
+{
+    //these are all available in GL3 and GLES3, but not GLES2
+    m_useMapping = (glMapBufferRange != nullptr && glUnmapBuffer != nullptr
+        && glFenceSync != nullptr && glClientWaitSync != nullptr && glDeleteSync != nullptr);
+
+    createBuffer(align(std::max(capacity, Alignment)));
+    glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+
+    LOG(std::string("Created stream buffer, using ") + (m_useMapping ? "buffer mapping" : "orphaning"), Logger::Type::Info);
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    clearFences();
+
+    m_retiredBuffers.push_back(m_vbo);
+    for (auto vbo : m_retiredBuffers)
+    {
+        if (vbo)
+        {
+            glCheck(glDeleteBuffers(1, &vbo));
+        }
+    }
+}
+
+//public
+StreamBuffer::Allocation StreamBuffer::upload(const void* data, std::size_t size)
+{
+    CRO_ASSERT(data && size > 0, "Invalid data");
+
+    auto alignedSize = align(size);
+
+    //wrap to the start if there's not enough room at the end
+    auto offset = m_offset;
+    auto skipped = std::size_t(0);
+    bool wrapped = false;
+    if (offset + alignedSize > m_capacity)
+    {
+        skipped = m_capacity - offset;
+        offset = 0;
+        wrapped = true;
+    }
+
+    if (m_frameUsed + skipped + alignedSize > m_capacity)
+    {
+        //this frame has used the entire buffer, which would overwrite
+        //data not yet drawn, so grow a new buffer instead.
+        createBuffer(std::max(m_capacity * 2, alignedSize * 2));
+        m_stats.resizes++;
+
+        offset = 0;
+        skipped = 0;
+    }
+    else if (m_useMapping)
+    {
+        waitForRange(offset, alignedSize);
+    }
+    else if (wrapped)
+    {
+        //without mapping the start of the buffer can't be checked, and may
+        //still be in use by a previous frame. Orphaning here would also discard
+        //data this frame has yet to draw, so the driver is left to synchronise.
+        m_stats.stalls++;
+    }
+
+    glCheck(glBindBuffer(GL_ARRAY_BUFFER, m_vbo));
+
+    void* dst = nullptr;
+    if (m_useMapping)
+    {
+        glCheck(dst = glMapBufferRange(GL_ARRAY_BUFFER, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+    }
+
+    if (dst)
+    {
+        std::memcpy(dst, data, size);
+        glCheck(glUnmapBuffer(GL_ARRAY_BUFFER));
+    }
+    else
+    {
+        glCheck(glBufferSubData(GL_ARRAY_BUFFER, offset, size, data));
+    }
+
+    m_offset = offset + alignedSize;
+    m_frameUsed += skipped + alignedSize;
+
+    m_stats.uploads++;
+    m_stats.bytesUploaded += size;
+
+    Allocation allocation;
+    allocation.vbo = m_vbo;
+    allocation.offset = offset;
+    allocation.size = size;
+    return allocation;
+}
+
+void StreamBuffer::beginFrame()
+{
+    if (m_useMapping)
+    {
+        if (m_frameUsed > 0)
+        {
+            Fence fence;
+            fence.start = m_frameStart;
+            fence.size = m_frameUsed;
+            glCheck(fence.sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+            m_fences.push_back(fence);
+        }
+
+        //remove any fences which have already passed so the queue doesn't grow
+        while (!m_fences.empty())
+        {
+            auto sync = static_cast<GLsync>(m_fences.front().sync);
+            GLenum result = GL_TIMEOUT_EXPIRED;
+            glCheck(result = glClientWaitSync(sync, 0, 0));
+            if (result == GL_TIMEOUT_EXPIRED)
+            {
+                break;
+            }
+            glCheck(glDeleteSync(sync));
+            m_fences.pop_front();
+        }
+    }
+
+    m_lastStats = m_stats;
+    m_stats = {};
+    m_stats.capacity = m_capacity;
+
+    if (!m_useMapping
+        && m_offset + m_frameUsed > m_capacity)
+    {
+        //assume the next frame is as large as this one, and if it won't
+        //fit orphan the current storage rather than waiting for the GPU
+        glCheck(glBindBuffer(GL_ARRAY_BUFFER, m_vbo));
+        glCheck(glBufferData(GL_ARRAY_BUFFER, m_capacity, nullptr, GL_STREAM_DRAW));
+        glCheck(glBindBuffer(GL_ARRAY_BUFFER, 0));
+        m_offset = 0;
+        m_stats.orphans++;
+    }
+
+    for (auto vbo : m_retiredBuffers)
+    {
+        glCheck(glDeleteBuffers(1, &vbo));
+    }
+    m_retiredBuffers.clear();
+
+    m_frameStart = m_offset;
+    m_frameUsed = 0;
+}
+
+//private
+void StreamBuffer::createBuffer(std::size_t size)
+{
+    //previous buffer may still be in use by this frame
+    if (m_vbo)
+    {
+        m_retiredBuffers.push_back(m_vbo);
+    }
+    clearFences();
+
+    glCheck(glGenBuffers(1, &m_vbo));
+    glCheck(glBindBuffer(GL_ARRAY_BUFFER, m_vbo));
+    glCheck(glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW));
+
+    m_capacity = size;
+    m_offset = 0;
+    m_frameStart = 0;
+    m_frameUsed = 0;
+    m_stats.capacity = size;
+}
+
+void StreamBuffer::waitForRange(std::size_t start, std::size_t size)
+{
+    //fence ranges may wrap around the end of the buffer
+    auto overlaps = [&, start, size](const Fence& fence)
+    {
+        auto end = fence.start + fence.size;
+        if (end > m_capacity)
+        {
+            return (start < end - m_capacity) || (start + size > fence.start);
+        }
+        return (start < end) && (start + size > fence.start);
+    };
+
+    //fences are in frame order, so waiting on the newest overlapping
+    //fence means all those before it are also complete
+    auto last = std::find_if(m_fences.rbegin(), m_fences.rend(), overlaps);
+    if (last == m_fences.rend())
+    {
+        return;
+    }
+
+    auto count = std::distance(last, m_fences.rend());
+    for (auto i = 0; i < count; ++i)
+    {
+        auto sync = static_cast<GLsync>(m_fences.front().sync);
+        GLenum result = GL_TIMEOUT_EXPIRED;
+        glCheck(result = glClientWaitSync(sync, 0, 0));
+        if (result == GL_TIMEOUT_EXPIRED)
+        {
+            m_stats.stalls++;
+            do
+            {
+                glCheck(result = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, WaitTimeout));
+            } while (result == GL_TIMEOUT_EXPIRED);
+        }
+        glCheck(glDeleteSync(sync));
+        m_fences.pop_front();
+    }
+}
+
+void StreamBuffer::clearFences()
+{
+    for (const auto& fence : m_fences)
+    {
+        glCheck(glDeleteSync(static_cast<GLsync>(fence.sync)));
+    }
+    m_fences.clear();
+}
\ No newline at end of file
@@ -0,0 +1,285 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include <crogine/graphics/TextureAtlas.hpp>
+#include <crogine/graphics/Image.hpp>
+#include <crogine/core/Log.hpp>
+#include <crogine/detail/Assert.hpp>
+
+#include <algorithm>
+#include <limits>
+
+using namespace cro;
+
+TextureAtlas::TextureAtlas(uint32 pageSize, uint32 padding)
+    : m_pageSize    (std::min(pageSize, Texture::getMaxTextureSize())),
+    m_padding       (padding)
+{
+    CRO_ASSERT(m_pageSize > 0, "Invalid page size");
+}
+
+//public
+const TextureAtlas::Region* TextureAtlas::add(const std::string& name, const Image& image)
+{
+    if (auto* region = getRegion(name))
+    {
+        return region;
+    }
+
+    auto size = image.getSize();
+    if (size.x == 0 || size.y == 0
+        || size.x + m_padding > m_pageSize || size.y + m_padding > m_pageSize)
+    {
+        Logger::log(name + ": image is too large to add to texture atlas", Logger::Type::Error);
+        return nullptr;
+    }
+
+    //atlas pages are always RGBA
+    std::vector<uint8> rgba;
+    const uint8* pixels = image.getPixelData();
+    if (image.getFormat() != ImageFormat::RGBA)
+    {
+        auto channels = (image.getFormat() == ImageFormat::RGB) ? 3u : 1u;
+        rgba.resize(size.x * size.y * 4);
+        for (auto i = 0u; i < size.x * size.y; ++i)
+        {
+            const auto* src = &pixels[i * channels];
+            auto* dst = &rgba[i * 4];
+            if (channels == 3)
+            {
+                dst[0] = src[0];
+                dst[1] = src[1];
+                dst[2] = src[2];
+                dst[3] = 255;
+            }
+            else
+            {
+                //alpha only images keep their transparency
+                dst[0] = 255;
+                dst[1] = 255;
+                dst[2] = 255;
+                dst[3] = src[0];
+            }
+        }
+        pixels = rgba.data();
+    }
+
+    //try existing pages first, newest first as older pages are likely full
+    glm::uvec2 position;
+    auto page = m_pages.rbegin();
+    for (; page != m_pages.rend(); ++page)
+    {
+        if (insert(*page, size.x, size.y, position))
+        {
+            break;
+        }
+    }
+
+    Page* dst = nullptr;
+    if (page == m_pages.rend())
+    {
+        dst = &createPage();
+        insert(*dst, size.x, size.y, position);
+    }
+    else
+    {
+        dst = &(*page);
+    }
+
+    auto region = std::make_unique<Region>();
+    region->texture = dst->texture.get();
+    region->area = { position.x, position.y, size.x, size.y };
+    dst->texture->update(pixels, false, region->area);
+    dst->usedArea += size.x * size.y;
+
+    auto* result = region.get();
+    m_regions.insert(std::make_pair(name, std::move(region)));
+    return result;
+}
+
+const TextureAtlas::Region* TextureAtlas::getRegion(const std::string& name) const
+{
+    auto result = m_regions.find(name);
+    if (result != m_regions.end())
+    {
+        return result->second.get();
+    }
+    return nullptr;
+}
+
+const Texture& TextureAtlas::getTexture(std::size_t page) const
+{
+    CRO_ASSERT(page < m_pages.size(), "Page index out of range");
+    return *m_pages[page].texture;
+}
+
+void TextureAtlas::setSmooth(bool smooth)
+{
+    for (auto& page : m_pages)
+    {
+        page.texture->setSmooth(smooth);
+    }
+}
+
+float TextureAtlas::getPackingEfficiency() const
+{
+    if (m_pages.empty())
+    {
+        return 0.f;
+    }
+
+    uint64 used = 0;
+    for (const auto& page : m_pages)
+    {
+        used += page.usedArea;
+    }
+    return static_cast<float>(static_cast<double>(used) / (static_cast<double>(m_pageSize) * m_pageSize * m_pages.size()));
+}
+
+//private
+TextureAtlas::Page& TextureAtlas::createPage()
+{
+    Page page;
+    page.texture = std::make_unique<Texture>();
+    page.texture->create(m_pageSize, m_pageSize, ImageFormat::RGBA);
+
+    //clear the padding so nothing bleeds into filtered images
+    std::vector<uint8> blank(m_pageSize * m_pageSize * 4, 0);
+    page.texture->update(blank.data(), false);
+
+    SkylineNode node;
+    node.width = m_pageSize;
+    page.skyline.push_back(node);
+
+    m_pages.push_back(std::move(page));
+    LOG("Created texture atlas page " + std::to_string(m_pages.size()), Logger::Type::Info);
+    return m_pages.back();
+}
+
+bool TextureAtlas::insert(Page& page, uint32 width, uint32 height, glm::uvec2& position)
+{
+    width += m_padding;
+    height += m_padding;
+
+    //find the position which leaves the lowest skyline
+    auto bestIndex = page.skyline.size();
+    auto bestHeight = std::numeric_limits<uint32>::max();
+    auto bestWidth = std::numeric_limits<uint32>::max();
+    for (auto i = 0u; i < page.skyline.size(); ++i)
+    {
+        uint32 y = 0;
+        if (fit(page, i, width, height, y))
+        {
+            if (y + height < bestHeight
+                || (y + height == bestHeight && page.skyline[i].width < bestWidth))
+            {
+                bestIndex = i;
+                bestHeight = y + height;
+                bestWidth = page.skyline[i].width;
+            }
+        }
+    }
+
+    if (bestIndex == page.skyline.size())
+    {
+        return false;
+    }
+
+    SkylineNode node;
+    node.x = page.skyline[bestIndex].x;
+    node.y = bestHeight;
+    node.width = width;
+    position = { node.x, bestHeight - height };
+    page.skyline.insert(page.skyline.begin() + bestIndex, node);
+
+    //shrink or remove the nodes now covered by the new one
+    for (auto i = bestIndex + 1; i < page.skyline.size();)
+    {
+        const auto& previous = page.skyline[i - 1];
+        auto& current = page.skyline[i];
+        auto previousEnd = previous.x + previous.width;
+        if (current.x >= previousEnd)
+        {
+            break;
+        }
+
+        auto shrink = previousEnd - current.x;
+        if (current.width <= shrink)
+        {
+            page.skyline.erase(page.skyline.begin() + i);
+        }
+        else
+        {
+            current.x += shrink;
+            current.width -= shrink;
+            break;
+        }
+    }
+
+    //merge neighbours at the same height
+    for (auto i = 0u; i + 1 < page.skyline.size();)
+    {
+        if (page.skyline[i].y == page.skyline[i + 1].y)
+        {
+            page.skyline[i].width += page.skyline[i + 1].width;
+            page.skyline.erase(page.skyline.begin() + i + 1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    return true;
+}
+
+bool TextureAtlas::fit(const Page& page, std::size_t index, uint32 width, uint32 height, uint32& y) const
+{
+    auto x = page.skyline[index].x;
+    if (x + width > m_pageSize)
+    {
+        return false;
+    }
+
+    //the image sits on the highest node it spans
+    y = 0;
+    auto remaining = static_cast<int32>(width);
+    while (remaining > 0)
+    {
+        CRO_ASSERT(index < page.skyline.size(), "Skyline out of range");
+        y = std::max(y, page.skyline[index].y);
+        if (y + height > m_pageSize)
+        {
+            return false;
+        }
+        remaining -= page.skyline[index].width;
+        index++;
+    }
+    return true;
+}
\ No newline at end of file
@@ -96,6 +96,37 @@ namespace cro
                 })";
 
             const static std::string FragmentDesktop = R"()";
+
+            //copies the cached static caster layer into the depth map,
+            //restoring the depth buffer from the packed colour values
+            const static std::string CacheVertex = R"(
+                attribute vec2 a_position;
+
+                varying vec2 v_texCoord;
+
+                void main()
+                {
+                    gl_Position = vec4(a_position * 2.0 - 1.0, 0.0, 1.0);
+                    v_texCoord = a_position;
+                })";
+
+            const static std::string CacheFragment = R"(
+                uniform sampler2D u_texture;
+
+                varying vec2 v_texCoord;
+
+                float unpack(vec4 colour)
+                {
+                    const vec4 bitshift = vec4(1.0 / 16777216.0, 1.0 / 65536.0, 1.0 / 256.0, 1.0);
+                    return dot(colour, bitshift);
+                }
+
+                void main()
+                {
+                    vec4 colour = texture2D(u_texture, v_texCoord);
+                    gl_FragColor = colour;
+                    gl_FragDepth = unpack(colour);
+                })";
         }
     }
 }
@@ -42,13 +42,14 @@ namespace cro
                 attribute vec4 a_position;
                 attribute LOW vec4 a_colour;
                 attribute MED vec2 a_texCoord0;
-                attribute MED vec2 a_texCoord1; //this actually has the matrix index in the x component
+                attribute MED vec2 a_texCoord1; //this actually has the matrix index in the x component and texture index in y
 
                 uniform mat4 u_projectionMatrix;
                 uniform mat4 u_worldMatrix[MAX_MATRICES];               
                
                 varying LOW vec4 v_colour;
                 varying MED vec2 v_texCoord0;
+                varying MED float v_textureIndex;
 
                 void main()
                 {
@@ -57,22 +58,72 @@ namespace cro
                     v_colour = a_colour;
                     //v_colour *= a_texCoord1.y;
                     v_texCoord0 = a_texCoord0;// * a_texCoord1;
+                    v_textureIndex = a_texCoord1.y;
                 })";
 
+            //samplers can only be indexed with constant expressions
+            //so the texture is selected with a branch per texture.
             const static std::string Fragment = R"(
-                uniform sampler2D u_texture;
+                uniform sampler2D u_texture[MAX_TEXTURES];
                 
                 varying LOW vec4 v_colour;
                 varying MED vec2 v_texCoord0;
+                varying MED float v_textureIndex;
 
                 void main()
                 {
-                    gl_FragColor = texture2D(u_texture, v_texCoord0) * v_colour;
+                    LOW vec4 colour;
+                #if MAX_TEXTURES > 7
+                    if (v_textureIndex > 6.5) colour = texture2D(u_texture[7], v_texCoord0); else
+                #endif
+                #if MAX_TEXTURES > 6
+                    if (v_textureIndex > 5.5) colour = texture2D(u_texture[6], v_texCoord0); else
+                #endif
+                #if MAX_TEXTURES > 5
+                    if (v_textureIndex > 4.5) colour = texture2D(u_texture[5], v_texCoord0); else
+                #endif
+                #if MAX_TEXTURES > 4
+                    if (v_textureIndex > 3.5) colour = texture2D(u_texture[4], v_texCoord0); else
+                #endif
+                #if MAX_TEXTURES > 3
+                    if (v_textureIndex > 2.5) colour = texture2D(u_texture[3], v_texCoord0); else
+                #endif
+                #if MAX_TEXTURES > 2
+                    if (v_textureIndex > 1.5) colour = texture2D(u_texture[2], v_texCoord0); else
+                #endif
+                #if MAX_TEXTURES > 1
+                    if (v_textureIndex > 0.5) colour = texture2D(u_texture[1], v_texCoord0); else
+                #endif
+                    colour = texture2D(u_texture[0], v_texCoord0);
+
+                    gl_FragColor = colour * v_colour;
                 })";
         }
 
         namespace Text
         {
+            const static std::string Vertex = R"(
+                attribute vec4 a_position;
+                attribute LOW vec4 a_colour;
+                attribute MED vec2 a_texCoord0;
+                attribute MED vec2 a_texCoord1; //matrix index in the x component and SDF edge smoothing in y
+
+                uniform mat4 u_projectionMatrix;
+                uniform mat4 u_worldMatrix[MAX_MATRICES];
+
+                varying LOW vec4 v_colour;
+                varying MED vec2 v_texCoord0;
+                varying MED float v_smoothing;
+
+                void main()
+                {
+                    int idx = int(clamp(a_texCoord1.x, 0.0, float(MAX_MATRICES - 1)));
+                    gl_Position = u_projectionMatrix * u_worldMatrix[idx] * a_position;
+                    v_colour = a_colour;
+                    v_texCoord0 = a_texCoord0;
+                    v_smoothing = a_texCoord1.y;
+                })";
+
             const static std::string BitmapFragment = R"(
                 uniform sampler2D u_texture;
                 
@@ -91,16 +142,12 @@ namespace cro
                 
                 varying LOW vec4 v_colour;
                 varying MED vec2 v_texCoord0;
-
-                MED float spread = 4.0;
-                MED float scale = 5.0;
-                MED float smoothing = 1.0 / 16.0;
+                varying MED float v_smoothing;
 
                 void main()
                 {
-                    //smoothing = 0.25 / (spread * scale);
                     MED float value = texture2D(u_texture, v_texCoord0).r;
-                    MED float alpha = smoothstep(0.5 - smoothing, 0.5 + smoothing, value);
+                    MED float alpha = smoothstep(0.5 - v_smoothing, 0.5 + v_smoothing, value);
                     gl_FragColor = vec4(v_colour.rgb, v_colour.a * alpha);
                 })";
         }
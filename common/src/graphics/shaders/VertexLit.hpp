@@ -72,7 +72,7 @@ namespace cro
                 uniform mat3 u_normalMatrix;                
                 uniform mat4 u_projectionMatrix;
 
-                #if defined(RX_SHADOWS)
+                #if defined(RX_SHADOWS) && defined(MOBILE)
                 uniform mat4 u_lightViewProjectionMatrix;
                 #endif
 
@@ -124,7 +124,12 @@ namespace cro
                     gl_Position = wvp * position;
 
                 #if defined (RX_SHADOWS)
+                #if defined (MOBILE)
                     v_lightWorldPosition = u_lightViewProjectionMatrix * u_worldMatrix * position;
+                #else
+                    //cascades are selected per fragment so pass on the world position
+                    v_lightWorldPosition = u_worldMatrix * position;
+                #endif
                 #endif
 
                     v_worldPosition = (u_worldMatrix * a_position).xyz;
@@ -264,24 +269,47 @@ namespace cro
                     vec2(0.14383161, -0.14100790)
                 );
                 const int filterSize = 3;
-                float shadowAmount(vec4 lightWorldPos)
-                {
-                    vec3 projectionCoords = lightWorldPos.xyz / lightWorldPos.w;
-                    projectionCoords = projectionCoords * 0.5 + 0.5;
 
-                    if(projectionCoords.z > 1.0) return 1.0;
+                #define MAX_CASCADES 4
+                uniform mat4 u_cascadeViewProjectionMatrix[MAX_CASCADES];
+                uniform int u_cascadeCount;
 
-                    float shadow = 0.0;
+                float shadowAmount(vec4 worldPos)
+                {
+                    //cascades are packed into a 2x2 grid when there are more than one
+                    float cellSize = (u_cascadeCount > 1) ? 0.5 : 1.0;
                     vec2 texelSize = 1.0 / textureSize(u_shadowMap, 0).xy;
-                    for(int x = 0; x < filterSize; ++x)
+                    vec2 margin = (texelSize * 2.0) / cellSize;
+
+                    for(int i = 0; i < MAX_CASCADES; ++i)
                     {
-                        for(int y = 0; y < filterSize; ++y)
+                        if(i == u_cascadeCount) break;
+
+                        vec4 lightWorldPos = u_cascadeViewProjectionMatrix[i] * worldPos;
+                        vec3 projectionCoords = lightWorldPos.xyz / lightWorldPos.w;
+                        projectionCoords = projectionCoords * 0.5 + 0.5;
+
+                        //use the first (most detailed) cascade which contains the fragment
+                        //leaving a border so the filter doesn't sample neighbouring cascades
+                        if(projectionCoords.z > 1.0
+                            || any(lessThan(projectionCoords.xy, margin))
+                            || any(greaterThan(projectionCoords.xy, 1.0 - margin))) continue;
+
+                        vec2 cellOffset = vec2(mod(float(i), 2.0), floor(float(i) / 2.0)) * cellSize;
+                        projectionCoords.xy = projectionCoords.xy * cellSize + cellOffset;
+
+                        float shadow = 0.0;
+                        for(int x = 0; x < filterSize; ++x)
                         {
-                            float pcfDepth = unpack(texture2D(u_shadowMap, projectionCoords.xy + kernel[y * filterSize + x] * texelSize));
-                            shadow += (projectionCoords.z - 0.001) > pcfDepth ? 0.4 : 0.0;
+                            for(int y = 0; y < filterSize; ++y)
+                            {
+                                float pcfDepth = unpack(texture2D(u_shadowMap, projectionCoords.xy + kernel[y * filterSize + x] * texelSize));
+                                shadow += (projectionCoords.z - 0.001) > pcfDepth ? 0.4 : 0.0;
+                            }
                         }
+                        return 1.0 - (shadow / 9.0);
                     }
-                    return 1.0 - (shadow / 9.0);
+                    return 1.0;
                 }
                 #endif
 
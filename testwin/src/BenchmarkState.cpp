@@ -0,0 +1,115 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine test application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include "BenchmarkState.hpp"
+
+#include <crogine/core/App.hpp>
+#include <crogine/ecs/components/Text.hpp>
+#include <crogine/ecs/components/Camera.hpp>
+#include <crogine/ecs/components/Transform.hpp>
+#include <crogine/ecs/systems/TextRenderer.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+const glm::vec2 BenchmarkState::SceneSize(1920.f, 1080.f);
+
+BenchmarkState::BenchmarkState(cro::StateStack& stack, cro::State::Context context)
+    : cro::State    (stack, context),
+    m_scene         (context.appInstance.getMessageBus()),
+    m_uiScene       (context.appInstance.getMessageBus()),
+    m_resultText    (0),
+    m_sceneTime     (0.f),
+    m_sampleCount   (0)
+{
+    m_uiScene.addSystem<cro::TextRenderer>(context.appInstance.getMessageBus());
+
+    m_font.loadFromFile("assets/fonts/VeraMono.ttf");
+    auto entity = m_uiScene.createEntity();
+    entity.addComponent<cro::Text>(m_font).setCharSize(30);
+    entity.getComponent<cro::Text>().setString("Measuring...");
+    entity.addComponent<cro::Transform>().setPosition({ 40.f, 200.f, 0.f });
+    m_resultText = entity.getIndex();
+
+    entity = m_uiScene.createEntity();
+    entity.addComponent<cro::Transform>();
+    entity.addComponent<cro::Camera>().projection = glm::ortho(0.f, SceneSize.x, 0.f, SceneSize.y, -0.1f, 10.f);
+    m_uiScene.setActiveCamera(entity);
+}
+
+//public
+bool BenchmarkState::handleEvent(const cro::Event& evt)
+{
+    m_scene.forwardEvent(evt);
+    m_uiScene.forwardEvent(evt);
+    return false;
+}
+
+void BenchmarkState::handleMessage(const cro::Message& msg)
+{
+    m_scene.forwardMessage(msg);
+    m_uiScene.forwardMessage(msg);
+}
+
+bool BenchmarkState::simulate(cro::Time dt)
+{
+    //samples are completed before the next frame is started so
+    //that every frame in a sample is both simulated and drawn
+    if (m_sampleCount == SampleFrames)
+    {
+        onSample(m_sceneTime / m_sampleCount);
+        m_sceneTime = 0.f;
+        m_sampleCount = 0;
+    }
+
+    update(dt);
+    m_sceneTime += measure([&]() { m_scene.simulate(dt); });
+    postUpdate();
+    m_sampleCount++;
+
+    m_uiScene.simulate(dt);
+    return false;
+}
+
+void BenchmarkState::render()
+{
+    m_scene.render();
+    postRender();
+    m_uiScene.render();
+}
+
+//protected
+void BenchmarkState::setResults(const std::string& results)
+{
+    m_uiScene.getEntity(m_resultText).getComponent<cro::Text>().setString(results);
+}
+
+void BenchmarkState::setResultPosition(glm::vec2 position)
+{
+    m_uiScene.getEntity(m_resultText).getComponent<cro::Transform>().setPosition({ position.x, position.y, 0.f });
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine test application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#ifndef TL_BENCHMARK_STATE_HPP_
+#define TL_BENCHMARK_STATE_HPP_
+
+#include <crogine/core/State.hpp>
+#include <crogine/ecs/Scene.hpp>
+#include <crogine/graphics/Font.hpp>
+
+#include <glm/vec2.hpp>
+
+#include <chrono>
+#include <string>
+
+/*
+Shared base for the benchmark and test states which are opened with
+the function keys in MyApp::handleEvent(). The workload is added to
+the scene returned by getScene(), the simulation of which is timed
+every frame. Results are displayed by a separate UI scene which is not
+measured. Once every SampleFrames frames onSample() is called with the
+averaged scene time, so that the state can update its results and
+switch to the next configuration it measures.
+*/
+class BenchmarkState : public cro::State
+{
+public:
+    BenchmarkState(cro::StateStack&, cro::State::Context);
+    virtual ~BenchmarkState() = default;
+
+    bool handleEvent(const cro::Event&) override;
+    void handleMessage(const cro::Message&) override;
+    bool simulate(cro::Time) override;
+    void render() override;
+
+protected:
+    static const glm::vec2 SceneSize;
+    static const std::size_t SampleFrames = 60; //results are averaged over this many frames
+
+    cro::Scene& getScene() { return m_scene; }
+    const cro::Scene& getScene() const { return m_scene; }
+    const cro::Font& getFont() const { return m_font; }
+
+    void setResults(const std::string&);
+    void setResultPosition(glm::vec2);
+
+    //returns the average time in milliseconds taken by a single call to func
+    template <typename T>
+    static float measure(T&& func, std::size_t iterations = 1)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (auto i = 0u; i < iterations; ++i)
+        {
+            func();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<float, std::milli>(end - start).count() / iterations;
+    }
+
+    //called every frame before the scene is simulated
+    virtual void update(cro::Time) {}
+
+    //called every frame after the scene is simulated
+    virtual void postUpdate() {}
+
+    //called every frame once the scene has been drawn
+    virtual void postRender() {}
+
+    //called when a sample is complete, with the average time in
+    //milliseconds taken to simulate the scene during it
+    virtual void onSample(float) {}
+
+private:
+
+    cro::Scene m_scene;
+    cro::Scene m_uiScene;
+    cro::Font m_font;
+    cro::Entity::ID m_resultText;
+
+    float m_sceneTime; //accumulated milliseconds
+    std::size_t m_sampleCount;
+};
+
+#endif //TL_BENCHMARK_STATE_HPP_
\ No newline at end of file
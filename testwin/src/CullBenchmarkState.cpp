@@ -0,0 +1,186 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine test application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include "CullBenchmarkState.hpp"
+
+#include <crogine/util/Constants.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+    const std::size_t VolumeCount = 20000;
+    const float WorldSize = 200.f; //volumes are placed within a cube this size around the camera
+    const std::size_t Iterations = 10; //each function is run this many times per frame
+}
+
+CullBenchmarkState::CullBenchmarkState(cro::StateStack& stack, cro::State::Context context)
+    : BenchmarkState    (stack, context),
+    m_randomEngine      (1234),
+    m_sphereTime        (0.f),
+    m_sphereScalarTime  (0.f),
+    m_boxTime           (0.f),
+    m_boxScalarTime     (0.f),
+    m_visibleCount      (0),
+    m_mismatchCount     (0),
+    m_testCount         (0)
+{
+    m_spheres.reserve(VolumeCount);
+    m_boxes.reserve(VolumeCount);
+
+    setResultPosition({ 40.f, SceneSize.y - 100.f });
+}
+
+//private
+void CullBenchmarkState::update(cro::Time)
+{
+    createVolumes();
+    auto frustum = createFrustum();
+
+    using namespace cro::Detail::Culling;
+    m_sphereTime += measure([&]() { frustumCull(frustum, m_spheres, m_results); m_visibleCount += m_results[0]; }, Iterations);
+    m_sphereScalarTime += measure([&]() { frustumCullScalar(frustum, m_spheres, m_scalarResults); m_visibleCount += m_scalarResults[0]; }, Iterations);
+    m_boxTime += measure([&]() { frustumCull(frustum, m_boxes, m_results); m_visibleCount += m_results[0]; }, Iterations);
+    m_boxScalarTime += measure([&]() { frustumCullScalar(frustum, m_boxes, m_scalarResults); m_visibleCount += m_scalarResults[0]; }, Iterations);
+
+    m_mismatchCount += validate(frustum);
+}
+
+void CullBenchmarkState::onSample(float)
+{
+    auto result = [](const std::string& name, float time, float scalarTime)
+    {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(3);
+        ss << name << ": " << time << "ms, scalar: " << scalarTime << "ms";
+        ss << std::setprecision(2) << " (x" << (time > 0 ? scalarTime / time : 0.f) << ")\n";
+        return ss.str();
+    };
+
+    std::stringstream ss;
+    ss << VolumeCount << " volumes\n";
+    ss << result("Spheres", m_sphereTime / SampleFrames, m_sphereScalarTime / SampleFrames);
+    ss << result("Boxes", m_boxTime / SampleFrames, m_boxScalarTime / SampleFrames);
+    ss << "Mismatched results: " << m_mismatchCount << " of " << m_testCount << " tested";
+    setResults(ss.str());
+
+    m_sphereTime = 0.f;
+    m_sphereScalarTime = 0.f;
+    m_boxTime = 0.f;
+    m_boxScalarTime = 0.f;
+}
+
+void CullBenchmarkState::createVolumes()
+{
+    std::uniform_real_distribution<float> position(-WorldSize / 2.f, WorldSize / 2.f);
+    std::uniform_real_distribution<float> size(0.1f, 10.f);
+
+    m_spheres.clear();
+    m_boxes.clear();
+    for (auto i = 0u; i < VolumeCount; ++i)
+    {
+        glm::vec3 centre(position(m_randomEngine), position(m_randomEngine), position(m_randomEngine));
+
+        cro::Sphere sphere;
+        sphere.centre = centre;
+        sphere.radius = size(m_randomEngine);
+        m_spheres.push_back(sphere);
+
+        glm::vec3 extent(size(m_randomEngine), size(m_randomEngine), size(m_randomEngine));
+        m_boxes.push_back({ centre - extent, centre + extent });
+    }
+}
+
+cro::Frustum CullBenchmarkState::createFrustum()
+{
+    //a camera at the origin looking in a random direction
+    std::uniform_real_distribution<float> angle(-cro::Util::Const::PI, cro::Util::Const::PI);
+    auto view = glm::rotate(glm::mat4(1.f), angle(m_randomEngine), glm::vec3(0.f, 1.f, 0.f));
+    view = glm::rotate(view, angle(m_randomEngine) / 2.f, glm::vec3(1.f, 0.f, 0.f));
+
+    auto projection = glm::perspective(0.6f, SceneSize.x / SceneSize.y, 0.1f, WorldSize / 2.f);
+    return cro::Spatial::getFrustum(projection * view);
+}
+
+std::size_t CullBenchmarkState::validate(const cro::Frustum& frustum)
+{
+    //each volume is tested individually against the planes with Spatial
+    //and compared with both the batched and the scalar array functions
+    auto isVisible = [&frustum](const auto& volume)
+    {
+        for (const auto& plane : frustum)
+        {
+            if (cro::Spatial::intersects(plane, volume) == cro::Planar::Back)
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    using namespace cro::Detail::Culling;
+    std::size_t mismatches = 0;
+
+    frustumCull(frustum, m_spheres, m_results);
+    frustumCullScalar(frustum, m_spheres, m_scalarResults);
+    for (auto i = 0u; i < m_spheres.size(); ++i)
+    {
+        cro::Sphere sphere;
+        sphere.centre = { m_spheres.getX()[i], m_spheres.getY()[i], m_spheres.getZ()[i] };
+        sphere.radius = m_spheres.getRadius()[i];
+
+        bool visible = isVisible(sphere);
+        if ((m_results[i] != 0) != visible
+            || (m_scalarResults[i] != 0) != visible)
+        {
+            mismatches++;
+        }
+    }
+
+    frustumCull(frustum, m_boxes, m_results);
+    frustumCullScalar(frustum, m_boxes, m_scalarResults);
+    for (auto i = 0u; i < m_boxes.size(); ++i)
+    {
+        glm::vec3 centre(m_boxes.getX()[i], m_boxes.getY()[i], m_boxes.getZ()[i]);
+        glm::vec3 extent(m_boxes.getExtentX()[i], m_boxes.getExtentY()[i], m_boxes.getExtentZ()[i]);
+
+        bool visible = isVisible(cro::Box({ centre - extent, centre + extent }));
+        if ((m_results[i] != 0) != visible
+            || (m_scalarResults[i] != 0) != visible)
+        {
+            mismatches++;
+        }
+    }
+
+    m_testCount += m_spheres.size() + m_boxes.size();
+    return mismatches;
+}
\ No newline at end of file
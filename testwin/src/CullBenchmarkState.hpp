@@ -0,0 +1,81 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine test application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#ifndef TL_CULL_BENCHMARK_STATE_HPP_
+#define TL_CULL_BENCHMARK_STATE_HPP_
+
+#include "BenchmarkState.hpp"
+#include "StateIDs.hpp"
+
+#include <crogine/detail/Culling.hpp>
+
+#include <random>
+
+/*
+Compares the output of the batched frustum culling functions with the
+scalar Spatial tests on sets of randomly placed spheres and boxes, and
+measures the time taken by each. New volumes and a new view are created
+every frame, and any result which differs from testing each volume
+against the frustum planes one at a time is counted as a mismatch.
+*/
+class CullBenchmarkState final : public BenchmarkState
+{
+public:
+    CullBenchmarkState(cro::StateStack&, cro::State::Context);
+    ~CullBenchmarkState() = default;
+
+    cro::StateID getStateID() const override { return States::CullBenchmark; }
+
+private:
+
+    std::mt19937 m_randomEngine;
+    cro::Detail::SphereArray m_spheres;
+    cro::Detail::BoxArray m_boxes;
+    std::vector<cro::uint8> m_results;
+    std::vector<cro::uint8> m_scalarResults;
+
+    //accumulated milliseconds
+    float m_sphereTime;
+    float m_sphereScalarTime;
+    float m_boxTime;
+    float m_boxScalarTime;
+
+    std::size_t m_visibleCount; //so the results can't be optimised away
+    std::size_t m_mismatchCount;
+    std::size_t m_testCount;
+
+    void createVolumes();
+    cro::Frustum createFrustum();
+    std::size_t validate(const cro::Frustum&);
+
+    void update(cro::Time) override;
+    void onSample(float) override;
+};
+
+#endif //TL_CULL_BENCHMARK_STATE_HPP_
\ No newline at end of file
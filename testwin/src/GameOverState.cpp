@@ -275,7 +275,7 @@ void GameOverState::load()
     (cro::Entity, cro::uint64 flags)
     {
         if ((flags & cro::UISystem::LeftMouse)
-            /*|| flags & cro::UISystem::Finger*/)
+            || flags & cro::UISystem::Finger)
         {
             //insert name / score into high score list           
             cro::ConfigFile scores;
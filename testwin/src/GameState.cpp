@@ -486,7 +486,8 @@ void GameState::createHUD()
         msg->button = UIEvent::Pause;
         msg->type = UIEvent::ButtonReleased;
 
-        if (flags & cro::UISystem::LeftMouse)
+        if ((flags & cro::UISystem::LeftMouse)
+            || flags & cro::UISystem::Finger)
         {
             requestStackPush(States::PauseMenu);
         }
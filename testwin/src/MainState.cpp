@@ -73,6 +73,9 @@ namespace
 {
 #include "MenuConsts.inl"
 
+    //can be toggled in the status window to compare the draw count
+    bool useMenuAtlas = true;
+
     void outputIcon(const cro::Image& img)
     {
         CRO_ASSERT(img.getFormat() == cro::ImageFormat::RGBA, "");
@@ -109,7 +112,8 @@ MainState::MainState(cro::StateStack& stack, cro::State::Context context, Resour
     m_menuScene         (context.appInstance.getMessageBus()),
     m_sharedResources   (*sharedResources),
     m_commandSystem     (nullptr),
-    m_uiSystem          (nullptr)
+    m_uiSystem          (nullptr),
+    m_logDrawCount      (true)
 {
     /*registerStatusControls(
         []()
@@ -123,6 +127,18 @@ MainState::MainState(cro::StateStack& stack, cro::State::Context context, Resour
         cro::Nim::slider("Channel 0", value, 0.f, 5.f);
         cro::AudioMixer::setVolume(value, 0);
     });*/
+
+    registerStatusControls([&]()
+    {
+        bool lastValue = useMenuAtlas;
+        cro::Nim::checkbox("Menu Texture Atlas", &useMenuAtlas);
+        if (lastValue != useMenuAtlas)
+        {
+            //reload the menu with the new setting
+            requestStackClear();
+            requestStackPush(States::MainMenu);
+        }
+    });
     
     context.mainWindow.loadResources([this, &context]()
     {
@@ -164,6 +180,8 @@ bool MainState::simulate(cro::Time dt)
     m_backgroundScene.simulate(dt);
     m_menuScene.simulate(dt);
 
+    DPRINT("Menu draw calls", std::to_string(m_menuScene.getSystem<cro::SpriteRenderer>().getDrawCount()));
+
     //auto size = getContext().mainWindow.getSize();
     //DPRINT("window size", std::to_string(size.x) + ", " + std::to_string(size.y));
 
@@ -174,6 +192,23 @@ void MainState::render()
 {    
     m_backgroundScene.render();
     m_menuScene.render();
+
+    if (m_logDrawCount)
+    {
+        //the draw count is only known once the menu has been drawn
+        auto msg = "Main menu sprites drawn with " + std::to_string(m_menuScene.getSystem<cro::SpriteRenderer>().getDrawCount()) + " draw calls";
+        if (useMenuAtlas)
+        {
+            msg += " using a texture atlas of " + std::to_string(m_menuAtlas.getPageCount()) + " page(s), "
+                + std::to_string(static_cast<cro::int32>(m_menuAtlas.getPackingEfficiency() * 100.f)) + "% packed";
+        }
+        else
+        {
+            msg += " without a texture atlas";
+        }
+        cro::Logger::log(msg, cro::Logger::Type::Info);
+        m_logDrawCount = false;
+    }
 }
 
 //private
@@ -326,13 +361,21 @@ void MainState::createScene()
 void MainState::createMenus()
 {
     cro::SpriteSheet spriteSheetButtons;
-    spriteSheetButtons.loadFromFile("assets/sprites/ui_menu.spt", m_sharedResources.textures);
+    cro::SpriteSheet spriteSheetIcons;
+    if (useMenuAtlas)
+    {
+        //buttons and their icons are drawn together so they share a texture
+        spriteSheetButtons.loadFromFile("assets/sprites/ui_menu.spt", m_menuAtlas);
+        spriteSheetIcons.loadFromFile("assets/sprites/ui_icons.spt", m_menuAtlas);
+    }
+    else
+    {
+        spriteSheetButtons.loadFromFile("assets/sprites/ui_menu.spt", m_sharedResources.textures);
+        spriteSheetIcons.loadFromFile("assets/sprites/ui_icons.spt", m_sharedResources.textures);
+    }
     const auto buttonNormalArea = spriteSheetButtons.getSprite("button_inactive").getTextureRect();
     const auto buttonHighlightArea = spriteSheetButtons.getSprite("button_active").getTextureRect();
 
-    cro::SpriteSheet spriteSheetIcons;
-    spriteSheetIcons.loadFromFile("assets/sprites/ui_icons.spt", m_sharedResources.textures);
-
     auto mouseEnterCallback = m_uiSystem->addCallback([&, buttonHighlightArea](cro::Entity e, glm::vec2)
     {
         e.getComponent<cro::Sprite>().setTextureRect(buttonHighlightArea);
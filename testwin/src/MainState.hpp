@@ -33,6 +33,7 @@ source distribution.
 #include <crogine/core/State.hpp>
 #include <crogine/ecs/Scene.hpp>
 #include <crogine/graphics/ResourceAutomation.hpp>
+#include <crogine/graphics/TextureAtlas.hpp>
 #include <crogine/gui/GuiClient.hpp>
 
 #include "StateIDs.hpp"
@@ -64,6 +65,7 @@ public:
 
 private:
     cro::ResourceCollection m_resources; //destruction order important!
+    cro::TextureAtlas m_menuAtlas;
     cro::Scene m_backgroundScene;
     cro::Scene m_menuScene;
     SharedResources& m_sharedResources;
@@ -72,6 +74,7 @@ private:
 
     cro::CommandSystem* m_commandSystem;
     cro::UISystem* m_uiSystem;
+    bool m_logDrawCount;
 
     void addSystems();
     void loadAssets();
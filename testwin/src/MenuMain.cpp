@@ -95,7 +95,7 @@ void MainState::createMainMenu(cro::uint32 mouseEnterCallback, cro::uint32 mouse
     (cro::Entity, cro::uint64 flags)
     {
         if ((flags & cro::UISystem::LeftMouse)
-            /*|| flags & cro::UISystem::Finger*/)
+            || flags & cro::UISystem::Finger)
         {
             cro::Command cmd;
             cmd.targetFlags = CommandID::MenuController;
@@ -143,7 +143,7 @@ void MainState::createMainMenu(cro::uint32 mouseEnterCallback, cro::uint32 mouse
     (cro::Entity, cro::uint64 flags)
     {
         if ((flags & cro::UISystem::LeftMouse)
-            /*|| (flags & cro::UISystem::Finger)*/)
+            || (flags & cro::UISystem::Finger))
         {
             cro::Command cmd;
             cmd.targetFlags = CommandID::MenuController;
@@ -188,7 +188,7 @@ void MainState::createMainMenu(cro::uint32 mouseEnterCallback, cro::uint32 mouse
     (cro::Entity e, cro::uint64 flags)
     {
         if ((flags & cro::UISystem::LeftMouse)
-            /*|| (flags & cro::UISystem::Finger)*/)
+            || (flags & cro::UISystem::Finger))
         {
             cro::Command cmd;
             cmd.targetFlags = CommandID::MenuController;
@@ -242,7 +242,7 @@ void MainState::createMainMenu(cro::uint32 mouseEnterCallback, cro::uint32 mouse
     auto quitCallback = m_uiSystem->addCallback([this](cro::Entity, cro::uint64 flags)
     {
         if ((flags & cro::UISystem::LeftMouse)
-            /*|| flags & cro::UISystem::Finger*/)
+            || flags & cro::UISystem::Finger)
         {
             cro::Command cmd;
             cmd.targetFlags = CommandID::MenuController;
@@ -269,7 +269,7 @@ void MainState::createMapSelect(cro::Entity parentEnt,
     auto backCallback = m_uiSystem->addCallback([this](cro::Entity, cro::uint64 flags)
     {
         if ((flags & cro::UISystem::LeftMouse)
-            /*|| flags & cro::UISystem::Finger*/)
+            || flags & cro::UISystem::Finger)
         {
             cro::Command cmd;
             cmd.targetFlags = CommandID::MenuController;
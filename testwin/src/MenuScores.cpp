@@ -243,13 +243,20 @@ void MainState::createScoreMenu(cro::uint32 mouseEnterCallback, cro::uint32 mous
     entity.addComponent<cro::UIInput>().callbacks[cro::UIInput::MouseMotion] = m_uiSystem->addCallback(
         [scroll](cro::Entity entity, glm::vec2 delta)
     {
-        if (entity.getComponent<cro::UIDraggable>().flags & cro::UISystem::LeftMouse)
+        if (entity.getComponent<cro::UIDraggable>().flags & (cro::UISystem::LeftMouse | cro::UISystem::Finger))
         {
             //add some momentum
             entity.getComponent<cro::UIDraggable>().velocity.y += scroll(entity, delta.y);
             entity.getComponent<cro::Callback>().active = true;
         }
     });
+    //touches don't raise motion events, instead dragging a finger which started on the list scrolls it
+    entity.getComponent<cro::UIInput>().callbacks[cro::UIInput::Drag] = m_uiSystem->addCallback(
+        [scroll](cro::Entity entity, glm::vec2 delta)
+    {
+        entity.getComponent<cro::UIDraggable>().velocity.y += scroll(entity, delta.y);
+        entity.getComponent<cro::Callback>().active = true;
+    });
     entity.getComponent<cro::UIInput>().callbacks[cro::UIInput::MouseDown] = m_uiSystem->addCallback(
         [](cro::Entity entity, cro::uint64 flags)
     {
@@ -318,7 +325,8 @@ void MainState::createScoreMenu(cro::uint32 mouseEnterCallback, cro::uint32 mous
     entity.getComponent<cro::UIInput>().callbacks[cro::UIInput::MouseDown] = m_uiSystem->addCallback(
         [](cro::Entity entity, cro::uint64 flags)
     {
-        if (flags & cro::UISystem::LeftMouse)
+        if ((flags & cro::UISystem::LeftMouse)
+            || flags & cro::UISystem::Finger)
         {
             entity.getComponent<cro::Callback>().active = true;
         }
@@ -326,7 +334,8 @@ void MainState::createScoreMenu(cro::uint32 mouseEnterCallback, cro::uint32 mous
     entity.getComponent<cro::UIInput>().callbacks[cro::UIInput::MouseUp] = m_uiSystem->addCallback(
         [scoreEnt](cro::Entity entity, cro::uint64 flags) mutable
     {
-        if (flags & cro::UISystem::LeftMouse)
+        if ((flags & cro::UISystem::LeftMouse)
+            || flags & cro::UISystem::Finger)
         {
             entity.getComponent<cro::Callback>().active = false;
             scoreEnt.getComponent<cro::UIDraggable>().velocity.y = -scrollSpeed / 2.f;
@@ -357,7 +366,8 @@ void MainState::createScoreMenu(cro::uint32 mouseEnterCallback, cro::uint32 mous
     entity.getComponent<cro::UIInput>().callbacks[cro::UIInput::MouseDown] = m_uiSystem->addCallback(
         [](cro::Entity entity, cro::uint64 flags)
     {
-        if (flags & cro::UISystem::LeftMouse)
+        if ((flags & cro::UISystem::LeftMouse)
+            || flags & cro::UISystem::Finger)
         {
             entity.getComponent<cro::Callback>().active = true;
         }
@@ -365,7 +375,8 @@ void MainState::createScoreMenu(cro::uint32 mouseEnterCallback, cro::uint32 mous
     entity.getComponent<cro::UIInput>().callbacks[cro::UIInput::MouseUp] = m_uiSystem->addCallback(
         [scoreEnt](cro::Entity entity, cro::uint64 flags) mutable
     {
-        if (flags & cro::UISystem::LeftMouse)
+        if ((flags & cro::UISystem::LeftMouse)
+            || flags & cro::UISystem::Finger)
         {
             entity.getComponent<cro::Callback>().active = false;
             scoreEnt.getComponent<cro::UIDraggable>().velocity.y = scrollSpeed / 2.f;
@@ -34,6 +34,12 @@ source distribution.
 #include "PauseState.hpp"
 #include "GameOverState.hpp"
 #include "RoundEndState.hpp"
+#include "TextBenchmarkState.hpp"
+#include "ParticleBenchmarkState.hpp"
+#include "CullBenchmarkState.hpp"
+#include "SpriteBenchmarkState.hpp"
+#include "OcclusionBenchmarkState.hpp"
+#include "RecorderTestState.hpp"
 #include "LoadingScreen.hpp"
 #include "icon.hpp"
 #include "Messages.hpp"
@@ -55,6 +61,12 @@ MyApp::MyApp()
     m_stateStack.registerState<PauseState>(States::ID::PauseMenu, m_sharedResources);
     m_stateStack.registerState<GameOverState>(States::ID::GameOver, m_sharedResources);
     m_stateStack.registerState<RoundEndState>(States::ID::RoundEnd, m_sharedResources);
+    m_stateStack.registerState<TextBenchmarkState>(States::ID::TextBenchmark);
+    m_stateStack.registerState<ParticleBenchmarkState>(States::ID::ParticleBenchmark);
+    m_stateStack.registerState<CullBenchmarkState>(States::ID::CullBenchmark);
+    m_stateStack.registerState<SpriteBenchmarkState>(States::ID::SpriteBenchmark);
+    m_stateStack.registerState<OcclusionBenchmarkState>(States::ID::OcclusionBenchmark);
+    m_stateStack.registerState<RecorderTestState>(States::ID::RecorderTest);
 	m_stateStack.pushState(States::MainMenu);
 }
 
@@ -70,6 +82,32 @@ void MyApp::handleEvent(const cro::Event& evt)
 		case SDLK_AC_BACK:
             App::quit();
 			break;
+#ifdef PLATFORM_DESKTOP
+        case SDLK_F8:
+            m_stateStack.clearStates();
+            m_stateStack.pushState(States::TextBenchmark);
+            break;
+        case SDLK_F9:
+            m_stateStack.clearStates();
+            m_stateStack.pushState(States::ParticleBenchmark);
+            break;
+        case SDLK_F10:
+            m_stateStack.clearStates();
+            m_stateStack.pushState(States::CullBenchmark);
+            break;
+        case SDLK_F11:
+            m_stateStack.clearStates();
+            m_stateStack.pushState(States::SpriteBenchmark);
+            break;
+        case SDLK_F12:
+            m_stateStack.clearStates();
+            m_stateStack.pushState(States::OcclusionBenchmark);
+            break;
+        case SDLK_F7:
+            m_stateStack.clearStates();
+            m_stateStack.pushState(States::RecorderTest);
+            break;
+#endif //PLATFORM_DESKTOP
 		}
 	}
 	
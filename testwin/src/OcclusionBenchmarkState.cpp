@@ -0,0 +1,156 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine test application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include "OcclusionBenchmarkState.hpp"
+
+#include <crogine/core/App.hpp>
+#include <crogine/ecs/components/Model.hpp>
+#include <crogine/ecs/components/Camera.hpp>
+#include <crogine/ecs/components/Occluder.hpp>
+#include <crogine/ecs/components/Transform.hpp>
+#include <crogine/ecs/systems/ModelRenderer.hpp>
+#include <crogine/graphics/CubeBuilder.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+namespace
+{
+    const std::size_t GridWidth = 30;
+    const std::size_t GridHeight = 20;
+    const float PanSpeed = 0.5f;
+    const float PanAngle = 0.4f;
+
+    enum ResourceID
+    {
+        Cube, Wall
+    };
+}
+
+OcclusionBenchmarkState::OcclusionBenchmarkState(cro::StateStack& stack, cro::State::Context context)
+    : BenchmarkState(stack, context),
+    m_camera        (0),
+    m_cameraTime    (0.f),
+    m_drawCount     (0),
+    m_visibleCount  (0)
+{
+    load();
+}
+
+//private
+void OcclusionBenchmarkState::load()
+{
+    auto& scene = getScene();
+    scene.addSystem<cro::ModelRenderer>(getContext().appInstance.getMessageBus()).setCullingVolume(cro::BoundingVolume::Box);
+
+    m_resources.meshes.loadMesh(ResourceID::Cube, cro::CubeBuilder());
+    auto shaderID = m_resources.shaders.preloadBuiltIn(cro::ShaderResource::Unlit, cro::ShaderResource::DiffuseColour);
+    m_resources.materials.add(ResourceID::Cube, m_resources.shaders.get(shaderID)).setProperty("u_colour", cro::Colour::Cyan());
+    m_resources.materials.add(ResourceID::Wall, m_resources.shaders.get(shaderID)).setProperty("u_colour", cro::Colour(0.3f, 0.3f, 0.3f));
+
+    //the wall's occluder is the same as its mesh
+    auto entity = scene.createEntity();
+    entity.addComponent<cro::Transform>().setPosition({ 0.f, 0.f, -12.f });
+    entity.getComponent<cro::Transform>().setScale({ 14.f, 9.f, 1.f });
+    entity.addComponent<cro::Model>(m_resources.meshes.getMesh(ResourceID::Cube), m_resources.materials.get(ResourceID::Wall));
+    entity.addComponent<cro::Occluder>(cro::Box({ glm::vec3(-0.5f), glm::vec3(0.5f) }));
+    m_models.push_back(entity);
+
+    //cubes behind the wall, some of which are visible at the edges
+    std::mt19937 randomEngine(1234);
+    std::uniform_real_distribution<float> depth(-60.f, -20.f);
+    for (auto y = 0u; y < GridHeight; ++y)
+    {
+        for (auto x = 0u; x < GridWidth; ++x)
+        {
+            entity = scene.createEntity();
+            entity.addComponent<cro::Transform>().setPosition({ (static_cast<float>(x) - (GridWidth / 2.f)) * 3.f, (static_cast<float>(y) - (GridHeight / 2.f)) * 2.f, depth(randomEngine) });
+            entity.addComponent<cro::Model>(m_resources.meshes.getMesh(ResourceID::Cube), m_resources.materials.get(ResourceID::Cube));
+            m_models.push_back(entity);
+        }
+    }
+
+    entity = scene.createEntity();
+    entity.addComponent<cro::Transform>();
+    entity.addComponent<cro::Camera>().projection = glm::perspective(1.f, SceneSize.x / SceneSize.y, 0.1f, 100.f);
+    scene.setActiveCamera(entity);
+    m_camera = entity.getIndex();
+
+    setResultPosition({ 40.f, 160.f });
+}
+
+void OcclusionBenchmarkState::update(cro::Time dt)
+{
+    m_cameraTime += dt.asSeconds();
+    getScene().getEntity(m_camera).getComponent<cro::Transform>().setRotation({ 0.f, std::sin(m_cameraTime * PanSpeed) * PanAngle, 0.f });
+}
+
+void OcclusionBenchmarkState::postRender()
+{
+    //the draw count is only known once the scene has been drawn
+    m_drawCount += getScene().getSystem<cro::ModelRenderer>().getDrawCount();
+    for (const auto& model : m_models)
+    {
+        if (model.getComponent<cro::Model>().isVisible())
+        {
+            m_visibleCount++;
+        }
+    }
+}
+
+void OcclusionBenchmarkState::onSample(float sceneTime)
+{
+    auto& renderer = getScene().getSystem<cro::ModelRenderer>();
+    auto& result = m_results[renderer.getOcclusionCulling() ? 1 : 0];
+    result.processTime = sceneTime;
+    result.drawCount = static_cast<float>(m_drawCount) / SampleFrames;
+    result.visibleCount = static_cast<float>(m_visibleCount) / SampleFrames;
+
+    std::stringstream ss;
+    ss << std::fixed;
+    ss << "Models: " << m_models.size() << "\n";
+    const std::array<std::string, 2u> names = { "Occlusion off", "Occlusion on" };
+    for (auto i = 0u; i < m_results.size(); ++i)
+    {
+        ss << names[i] << ": " << std::setprecision(0) << m_results[i].drawCount << " draw calls, ";
+        ss << m_results[i].visibleCount << " models visible, ";
+        ss << "process " << std::setprecision(3) << m_results[i].processTime << "ms\n";
+    }
+    setResults(ss.str());
+
+    m_drawCount = 0;
+    m_visibleCount = 0;
+
+    //measure the other setting
+    renderer.setOcclusionCulling(!renderer.getOcclusionCulling());
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine test application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#ifndef TL_OCCLUSION_BENCHMARK_STATE_HPP_
+#define TL_OCCLUSION_BENCHMARK_STATE_HPP_
+
+#include "BenchmarkState.hpp"
+#include "StateIDs.hpp"
+
+#include <crogine/graphics/ResourceAutomation.hpp>
+
+#include <array>
+#include <vector>
+
+/*
+Draws a grid of 600 cubes, most of which are hidden behind a large wall
+which is used as an occluder. Occlusion culling in the model renderer is
+switched on and off every sample, and the number of draw calls and the
+time taken to process the scene are shown for each, while the camera pans
+back and forth so that the occluded area changes.
+*/
+class OcclusionBenchmarkState final : public BenchmarkState
+{
+public:
+    OcclusionBenchmarkState(cro::StateStack&, cro::State::Context);
+    ~OcclusionBenchmarkState() = default;
+
+    cro::StateID getStateID() const override { return States::OcclusionBenchmark; }
+
+private:
+
+    cro::ResourceCollection m_resources;
+
+    std::vector<cro::Entity> m_models;
+    cro::Entity::ID m_camera;
+    float m_cameraTime;
+
+    //accumulated over the current sample
+    std::size_t m_drawCount;
+    std::size_t m_visibleCount;
+
+    struct Result final
+    {
+        float processTime = 0.f;
+        float drawCount = 0.f;
+        float visibleCount = 0.f;
+    };
+    std::array<Result, 2u> m_results; //off, on
+
+    void load();
+
+    void update(cro::Time) override;
+    void postRender() override;
+    void onSample(float) override;
+};
+
+#endif //TL_OCCLUSION_BENCHMARK_STATE_HPP_
\ No newline at end of file
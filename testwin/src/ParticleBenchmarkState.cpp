@@ -0,0 +1,137 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine test application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include "ParticleBenchmarkState.hpp"
+
+#include <crogine/core/App.hpp>
+#include <crogine/ecs/components/Camera.hpp>
+#include <crogine/ecs/components/Transform.hpp>
+#include <crogine/ecs/components/ParticleEmitter.hpp>
+#include <crogine/ecs/systems/ParticleSystem.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+    const std::size_t EmitterCount = 64;
+    const std::array<std::size_t, 4u> ThreadCounts = { 1, 2, 4, 8 };
+}
+
+ParticleBenchmarkState::ParticleBenchmarkState(cro::StateStack& stack, cro::State::Context context)
+    : BenchmarkState(stack, context),
+    m_currentPool   (0)
+{
+    m_results.fill(0.f);
+
+    //the calling thread also does work, so pools need one less worker
+    for (auto i = 1u; i < ThreadCounts.size(); ++i)
+    {
+        m_workerPools[i] = std::make_unique<cro::WorkerPool>(ThreadCounts[i] - 1);
+    }
+
+    load();
+}
+
+//private
+void ParticleBenchmarkState::load()
+{
+    auto& scene = getScene();
+    scene.addSystem<cro::ParticleSystem>(getContext().appInstance.getMessageBus()).setWorkerPool(m_workerPools[m_currentPool].get());
+
+    //emitters live long enough to fill to their limit
+    cro::EmitterSettings settings;
+    settings.loadFromFile("assets/particles/smoke.cps", m_textures);
+    settings.lifetime = 1000.f;
+    settings.lifetimeVariance = 0.f;
+    settings.emitRate = 1000.f;
+    settings.initialVelocity = {};
+    settings.forces = {};
+    settings.gravity = {};
+    settings.spawnRadius = 50.f;
+    settings.scaleModifier = 0.f;
+    settings.size = 4.f;
+
+    const std::size_t columns = 16;
+    const glm::vec2 cellSize(SceneSize.x / columns, (SceneSize.y - 200.f) / (EmitterCount / columns));
+    for (auto i = 0u; i < EmitterCount; ++i)
+    {
+        auto entity = scene.createEntity();
+        entity.addComponent<cro::Transform>().setPosition({ ((i % columns) + 0.5f) * cellSize.x, SceneSize.y - (((i / columns) + 0.5f) * cellSize.y), 0.f });
+        entity.addComponent<cro::ParticleEmitter>().emitterSettings = settings;
+        entity.getComponent<cro::ParticleEmitter>().setRandomSeed(i);
+        entity.getComponent<cro::ParticleEmitter>().start();
+        m_emitters.push_back(entity);
+    }
+
+    auto entity = scene.createEntity();
+    entity.addComponent<cro::Transform>();
+    entity.addComponent<cro::Camera>().projection = glm::ortho(0.f, SceneSize.x, 0.f, SceneSize.y, -10.f, 10.f);
+    scene.setActiveCamera(entity);
+}
+
+std::size_t ParticleBenchmarkState::getParticleCount() const
+{
+    std::size_t count = 0;
+    for (const auto& e : m_emitters)
+    {
+        count += e.getComponent<cro::ParticleEmitter>().getParticleCount();
+    }
+    return count;
+}
+
+void ParticleBenchmarkState::onSample(float sceneTime)
+{
+    auto particleCount = getParticleCount();
+    m_results[m_currentPool] = sceneTime;
+
+    auto& particles = getScene().getSystem<cro::ParticleSystem>();
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << "Particles: " << particleCount << "\n";
+    ss << "Draw calls: " << particles.getDrawCount() << "\n";
+    for (auto i = 0u; i < ThreadCounts.size(); ++i)
+    {
+        auto frameTime = m_results[i];
+        ss << ThreadCounts[i] << " threads: " << std::setprecision(3) << frameTime << "ms, ";
+        ss << std::setprecision(0) << (frameTime > 0 ? particleCount / frameTime : 0.f) << " particles per ms";
+        if (frameTime > 0 && m_results[0] > 0)
+        {
+            ss << std::setprecision(2) << " (x" << m_results[0] / frameTime << ")";
+        }
+        ss << "\n";
+    }
+    setResults(ss.str());
+
+    //measure the next thread count
+    m_currentPool = (m_currentPool + 1) % ThreadCounts.size();
+    particles.setWorkerPool(m_workerPools[m_currentPool].get());
+}
\ No newline at end of file
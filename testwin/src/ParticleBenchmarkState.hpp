@@ -0,0 +1,73 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine test application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#ifndef TL_PARTICLE_BENCHMARK_STATE_HPP_
+#define TL_PARTICLE_BENCHMARK_STATE_HPP_
+
+#include "BenchmarkState.hpp"
+#include "StateIDs.hpp"
+
+#include <crogine/core/WorkerPool.hpp>
+#include <crogine/graphics/TextureResource.hpp>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+/*
+Measures the cost of simulating 64 particle emitters, each of which
+is allowed to fill to its 1000 particle limit. The simulation is
+repeatedly measured with 1, 2, 4 and 8 threads to show how it scales,
+along with the speed up of each compared to a single thread.
+*/
+class ParticleBenchmarkState final : public BenchmarkState
+{
+public:
+    ParticleBenchmarkState(cro::StateStack&, cro::State::Context);
+    ~ParticleBenchmarkState() = default;
+
+    cro::StateID getStateID() const override { return States::ParticleBenchmark; }
+
+private:
+
+    cro::TextureResource m_textures;
+    std::vector<cro::Entity> m_emitters;
+
+    static constexpr std::size_t TestCount = 4;
+    std::array<std::unique_ptr<cro::WorkerPool>, TestCount> m_workerPools;
+    std::array<float, TestCount> m_results;
+    std::size_t m_currentPool;
+
+    void load();
+    std::size_t getParticleCount() const;
+
+    void onSample(float) override;
+};
+
+#endif //TL_PARTICLE_BENCHMARK_STATE_HPP_
\ No newline at end of file
@@ -322,8 +322,8 @@ void PauseState::createMenu(const cro::SpriteSheet& spriteSheet, const cro::Spri
     entity.getComponent<cro::UIInput>().callbacks[cro::UIInput::MouseUp] = m_uiSystem->addCallback(
         [&](cro::Entity, cro::uint64 flags)
     {
-        if ((flags & cro::UISystem::LeftMouse) //gets raised even on touch
-            /*|| flags & cro::UISystem::Finger*/)
+        if ((flags & cro::UISystem::LeftMouse)
+            || flags & cro::UISystem::Finger)
         {
             requestStackPop();
             //LOG("POP!", cro::Logger::Type::Info);
@@ -385,7 +385,7 @@ void PauseState::createMenu(const cro::SpriteSheet& spriteSheet, const cro::Spri
     buttonEntity.getComponent<cro::UIInput>().callbacks[cro::UIInput::MouseDown] = m_uiSystem->addCallback([this](cro::Entity, cro::uint64 flags)
     {
         if ((flags & cro::UISystem::LeftMouse)
-            /*|| flags & cro::UISystem::Finger*/)
+            || flags & cro::UISystem::Finger)
         {
             requestStackClear();
             requestStackPush(States::MainMenu);
@@ -418,7 +418,8 @@ void PauseState::createMenu(const cro::SpriteSheet& spriteSheet, const cro::Spri
     buttonEntity.getComponent<cro::UIInput>().callbacks[cro::UIInput::MouseExit] = mouseExitCallback;
     buttonEntity.getComponent<cro::UIInput>().callbacks[cro::UIInput::MouseDown] = m_uiSystem->addCallback([this](cro::Entity, cro::uint64 flags)
     {
-        if ((flags & cro::UISystem::LeftMouse))
+        if ((flags & cro::UISystem::LeftMouse)
+            || flags & cro::UISystem::Finger)
         {
             cro::Command cmd;
             cmd.targetFlags = CommandID::MenuController;
@@ -0,0 +1,306 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine test application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include "RecorderTestState.hpp"
+
+#include <crogine/core/App.hpp>
+#include <crogine/core/Log.hpp>
+#include <crogine/ecs/components/Text.hpp>
+#include <crogine/ecs/components/Model.hpp>
+#include <crogine/ecs/components/Sprite.hpp>
+#include <crogine/ecs/components/Camera.hpp>
+#include <crogine/ecs/components/Transform.hpp>
+#include <crogine/ecs/components/ParticleEmitter.hpp>
+#include <crogine/ecs/systems/TextRenderer.hpp>
+#include <crogine/ecs/systems/ModelRenderer.hpp>
+#include <crogine/ecs/systems/SpriteRenderer.hpp>
+#include <crogine/ecs/systems/ParticleSystem.hpp>
+#include <crogine/graphics/CubeBuilder.hpp>
+#include <crogine/graphics/StreamBuffer.hpp>
+#include <crogine/graphics/ResourceAutomation.hpp>
+#include <crogine/detail/OpenGL.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+namespace
+{
+    const std::size_t CubeIndexCount = 36;
+    const std::size_t ParticleCount = 50;
+
+    using GLRecorder = cro::Detail::GLRecorder;
+    using Command = GLRecorder::Command;
+}
+
+RecorderTestState::RecorderTestState(cro::StateStack& stack, cro::State::Context context)
+    : BenchmarkState(stack, context)
+{
+    load();
+}
+
+//private
+std::vector<RecorderTestState::DrawCall> RecorderTestState::replay(const std::vector<Command>& commands)
+{
+    std::vector<DrawCall> drawCalls;
+    DrawCall current;
+    std::size_t activeUnit = 0;
+
+    for (const auto& cmd : commands)
+    {
+        switch (cmd.type)
+        {
+        default: break;
+        case Command::UseProgram:
+            current.program = cmd.args[1];
+            break;
+        case Command::BindBuffer:
+            if (cmd.args[0] == GL_ELEMENT_ARRAY_BUFFER)
+            {
+                current.elementBuffer = cmd.args[1];
+            }
+            else
+            {
+                current.arrayBuffer = cmd.args[1];
+            }
+            break;
+        case Command::BindTexture:
+            if (current.textures.size() <= activeUnit)
+            {
+                current.textures.resize(activeUnit + 1);
+            }
+            current.textures[activeUnit] = cmd.args[1];
+            break;
+        case Command::State:
+            if (std::string(cmd.name) == "glActiveTexture")
+            {
+                activeUnit = static_cast<std::size_t>(cmd.args[0] - GL_TEXTURE0);
+            }
+            break;
+        case Command::Upload:
+            current.uploadsBefore++;
+            break;
+        case Command::Draw:
+            current.name = cmd.name;
+            current.mode = cmd.args[0];
+            //glDrawArrays(mode, first, count), glDrawElements(mode, count, type, offset)
+            current.count = (current.name == "glDrawArrays") ? cmd.args[2] : cmd.args[1];
+            drawCalls.push_back(current);
+            current.uploadsBefore = 0;
+            break;
+        }
+    }
+    return drawCalls;
+}
+
+void RecorderTestState::recordFrame(cro::Scene& scene)
+{
+    GLRecorder::reset();
+    scene.simulate(cro::seconds(0.1f));
+    scene.render();
+}
+
+void RecorderTestState::testModels()
+{
+    //resources are declared before the scene so that they outlive it
+    cro::ResourceCollection resources;
+    cro::Scene scene(getContext().appInstance.getMessageBus());
+    auto& renderer = scene.addSystem<cro::ModelRenderer>(getContext().appInstance.getMessageBus());
+    renderer.setWorkerPool(nullptr);
+
+    resources.meshes.loadMesh(0, cro::CubeBuilder());
+    auto shaderID = resources.shaders.preloadBuiltIn(cro::ShaderResource::Unlit, cro::ShaderResource::DiffuseColour);
+    auto& material = resources.materials.add(0, resources.shaders.get(shaderID));
+    material.setProperty("u_colour", cro::Colour::Cyan());
+    const auto mesh = resources.meshes.getMesh(0);
+
+    //one cube in front of the camera and one behind which should be culled
+    auto entity = scene.createEntity();
+    entity.addComponent<cro::Transform>().setPosition({ 0.f, 0.f, -5.f });
+    entity.addComponent<cro::Model>(mesh, material);
+
+    entity = scene.createEntity();
+    entity.addComponent<cro::Transform>().setPosition({ 0.f, 0.f, 5.f });
+    entity.addComponent<cro::Model>(mesh, material);
+
+    recordFrame(scene);
+    auto drawCalls = replay(GLRecorder::getCommands());
+
+    Result result;
+    result.name = "ModelRenderer";
+    result.check(drawCalls.size() == 1, "expected 1 draw call, recorded " + std::to_string(drawCalls.size()));
+    result.check(renderer.getDrawCount() == drawCalls.size(), "draw count does not match recorded draw calls");
+    if (!drawCalls.empty())
+    {
+        const auto& draw = drawCalls[0];
+        result.check(draw.name == "glDrawElements" && draw.mode == GL_TRIANGLES, "expected glDrawElements(GL_TRIANGLES)");
+        result.check(draw.count == static_cast<cro::int64>(CubeIndexCount), "expected " + std::to_string(CubeIndexCount) + " indices");
+        result.check(draw.program == material.shader, "material shader was not bound");
+        result.check(draw.arrayBuffer == mesh.vbo, "mesh vertex buffer was not bound");
+        result.check(draw.elementBuffer == mesh.indexData[0].ibo, "mesh index buffer was not bound");
+    }
+    m_results.push_back(result);
+}
+
+void RecorderTestState::testSprites()
+{
+    std::array<cro::Texture, 2u> textures;
+    for (auto& texture : textures)
+    {
+        texture.create(4, 4);
+    }
+
+    cro::Scene scene(getContext().appInstance.getMessageBus());
+    auto& renderer = scene.addSystem<cro::SpriteRenderer>(getContext().appInstance.getMessageBus());
+    scene.getActiveCamera().getComponent<cro::Camera>().projection = glm::ortho(0.f, SceneSize.x, 0.f, SceneSize.y, -0.1f, 10.f);
+
+    //sprites with different textures are drawn in one batch
+    const std::array<std::size_t, 3u> spriteTextures = { 0, 1, 0 };
+    for (auto i = 0u; i < spriteTextures.size(); ++i)
+    {
+        auto entity = scene.createEntity();
+        entity.addComponent<cro::Transform>().setPosition({ 100.f + (i * 100.f), 100.f, 0.f });
+        entity.addComponent<cro::Sprite>().setTexture(textures[spriteTextures[i]]);
+    }
+
+    recordFrame(scene);
+    auto drawCalls = replay(GLRecorder::getCommands());
+
+    Result result;
+    result.name = "SpriteRenderer";
+    result.check(drawCalls.size() == 1, "expected 1 draw call, recorded " + std::to_string(drawCalls.size()));
+    result.check(renderer.getDrawCount() == drawCalls.size(), "draw count does not match recorded draw calls");
+    if (!drawCalls.empty())
+    {
+        const auto& draw = drawCalls[0];
+        result.check(draw.name == "glDrawElements" && draw.mode == GL_TRIANGLES, "expected glDrawElements(GL_TRIANGLES)");
+        result.check(draw.count == static_cast<cro::int64>(spriteTextures.size() * 6), "expected 6 indices per sprite");
+        result.check(draw.program != 0 && draw.arrayBuffer != 0 && draw.elementBuffer != 0, "shader or buffers were not bound");
+        result.check(draw.uploadsBefore > 0, "sprite vertices were not uploaded");
+        for (const auto& texture : textures)
+        {
+            result.check(std::find(draw.textures.begin(), draw.textures.end(), texture.getGLHandle()) != draw.textures.end(),
+                "texture " + std::to_string(texture.getGLHandle()) + " was not bound");
+        }
+    }
+    m_results.push_back(result);
+}
+
+void RecorderTestState::testText()
+{
+    cro::Font font;
+    font.loadFromFile("assets/fonts/VeraMono.ttf");
+
+    cro::Scene scene(getContext().appInstance.getMessageBus());
+    scene.addSystem<cro::TextRenderer>(getContext().appInstance.getMessageBus());
+    scene.getActiveCamera().getComponent<cro::Camera>().projection = glm::ortho(0.f, SceneSize.x, 0.f, SceneSize.y, -0.1f, 10.f);
+
+    auto entity = scene.createEntity();
+    entity.addComponent<cro::Text>(font).setCharSize(30);
+    entity.getComponent<cro::Text>().setString("Recorded");
+    entity.addComponent<cro::Transform>().setPosition({ 100.f, 100.f, 0.f });
+
+    recordFrame(scene);
+    auto drawCalls = replay(GLRecorder::getCommands());
+
+    Result result;
+    result.name = "TextRenderer";
+    result.check(drawCalls.size() == 1, "expected 1 draw call, recorded " + std::to_string(drawCalls.size()));
+    if (!drawCalls.empty())
+    {
+        const auto& draw = drawCalls[0];
+        result.check(draw.name == "glDrawArrays" && draw.mode == GL_TRIANGLE_STRIP, "expected glDrawArrays(GL_TRIANGLE_STRIP)");
+        result.check(draw.count > 0, "no vertices were drawn");
+        result.check(draw.program != 0 && draw.arrayBuffer != 0, "shader or vertex buffer was not bound");
+        result.check(!draw.textures.empty() && draw.textures[0] == font.getTexture(30).getGLHandle(), "font texture was not bound");
+    }
+    m_results.push_back(result);
+}
+
+void RecorderTestState::testParticles()
+{
+    //the App's stream buffer was created with the driver
+    cro::StreamBuffer streamBuffer;
+
+    cro::Scene scene(getContext().appInstance.getMessageBus());
+    auto& particles = scene.addSystem<cro::ParticleSystem>(getContext().appInstance.getMessageBus());
+    particles.setWorkerPool(nullptr);
+    particles.setStreamBuffer(&streamBuffer);
+
+    auto entity = scene.createEntity();
+    entity.addComponent<cro::Transform>().setPosition({ 0.f, 0.f, -5.f });
+    auto& emitter = entity.addComponent<cro::ParticleEmitter>();
+    emitter.emitterSettings.lifetime = 5.f;
+    emitter.burst(ParticleCount);
+
+    streamBuffer.beginFrame();
+    recordFrame(scene);
+    auto drawCalls = replay(GLRecorder::getCommands());
+
+    Result result;
+    result.name = "ParticleSystem";
+    result.check(drawCalls.size() == 1, "expected 1 draw call, recorded " + std::to_string(drawCalls.size()));
+    result.check(particles.getDrawCount() == drawCalls.size(), "draw count does not match recorded draw calls");
+    if (!drawCalls.empty())
+    {
+        const auto& draw = drawCalls[0];
+        result.check(draw.name == "glDrawArrays" && draw.mode == GL_POINTS, "expected glDrawArrays(GL_POINTS)");
+        result.check(draw.count == static_cast<cro::int64>(emitter.getParticleCount()), "expected one point per particle");
+        result.check(emitter.getParticleCount() == ParticleCount, "expected " + std::to_string(ParticleCount) + " particles");
+        result.check(draw.program != 0 && draw.arrayBuffer != 0, "shader or vertex buffer was not bound");
+        result.check(draw.uploadsBefore > 0, "particle vertices were not uploaded");
+    }
+    m_results.push_back(result);
+}
+
+void RecorderTestState::load()
+{
+    //every GL resource used by the tests is created and destroyed
+    //while the recorder is installed, so each is run in its own scope
+    GLRecorder::install();
+    testModels();
+    testSprites();
+    testText();
+    testParticles();
+    GLRecorder::uninstall();
+
+    std::stringstream ss;
+    for (const auto& result : m_results)
+    {
+        ss << result.name << ": " << (result.failures.empty() ? "PASS" : "FAIL") << "\n";
+        for (const auto& failure : result.failures)
+        {
+            ss << "    " << failure << "\n";
+            cro::Logger::log(result.name + ": " + failure, cro::Logger::Type::Error);
+        }
+    }
+    setResults(ss.str());
+    setResultPosition({ 40.f, SceneSize.y - 40.f });
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine test application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#ifndef TL_RECORDER_TEST_STATE_HPP_
+#define TL_RECORDER_TEST_STATE_HPP_
+
+#include "BenchmarkState.hpp"
+#include "StateIDs.hpp"
+
+#include <crogine/detail/GLRecorder.hpp>
+
+#include <string>
+#include <vector>
+
+/*
+Installs the headless GL recorder and renders a single frame with each
+of the model, sprite, text and particle renderers. The recorded command
+stream is replayed to find the state bound for each draw call, which is
+checked against what was submitted to the scene. The tests are run once
+when the state is loaded, and any failures are also written to the log.
+*/
+class RecorderTestState final : public BenchmarkState
+{
+public:
+    RecorderTestState(cro::StateStack&, cro::State::Context);
+    ~RecorderTestState() = default;
+
+    cro::StateID getStateID() const override { return States::RecorderTest; }
+
+private:
+
+    struct Result final
+    {
+        std::string name;
+        std::vector<std::string> failures;
+        void check(bool passed, const std::string& msg)
+        {
+            if (!passed) failures.push_back(msg);
+        }
+    };
+    std::vector<Result> m_results;
+
+    //GL state at the time of a recorded draw call
+    struct DrawCall final
+    {
+        std::string name;
+        cro::int64 mode = 0;
+        cro::int64 count = 0;
+        cro::int64 program = 0;
+        cro::int64 arrayBuffer = 0;
+        cro::int64 elementBuffer = 0;
+        std::vector<cro::int64> textures; //< one per texture unit
+        std::size_t uploadsBefore = 0; //< uploads since the previous draw
+    };
+    static std::vector<DrawCall> replay(const std::vector<cro::Detail::GLRecorder::Command>&);
+    static void recordFrame(cro::Scene&);
+
+    void testModels();
+    void testSprites();
+    void testText();
+    void testParticles();
+
+    void load();
+};
+
+#endif //TL_RECORDER_TEST_STATE_HPP_
\ No newline at end of file
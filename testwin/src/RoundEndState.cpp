@@ -227,7 +227,7 @@ void RoundEndState::load()
     (cro::Entity, cro::uint64 flags)
     {
         if ((flags & cro::UISystem::LeftMouse)
-            /*|| flags & cro::UISystem::Finger*/)
+            || flags & cro::UISystem::Finger)
         {
             //TODO continue to next round or load next map
             //TODO change background colour on round change
@@ -0,0 +1,294 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine test application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include "SpriteBenchmarkState.hpp"
+
+#include <crogine/core/App.hpp>
+#include <crogine/detail/Sort.hpp>
+#include <crogine/ecs/components/Sprite.hpp>
+#include <crogine/ecs/components/Camera.hpp>
+#include <crogine/ecs/components/Transform.hpp>
+#include <crogine/ecs/systems/SpriteRenderer.hpp>
+#include <crogine/graphics/Image.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <tuple>
+
+namespace
+{
+    const std::size_t SpriteCount = 10000;
+    const std::size_t DepthLayers = 8;
+    const std::size_t MovedPerFrame = SpriteCount / 100; //when not shuffling
+    const std::array<std::string, 2u> TestNames = { "Nearly sorted", "Shuffled" };
+
+    //the same order as the sprite renderer's sort keys
+    struct SortItem final
+    {
+        float depth;
+        cro::int32 texture;
+        cro::Material::BlendMode blendMode;
+        cro::Entity entity;
+    };
+
+    bool isLess(const SortItem& a, const SortItem& b)
+    {
+        return std::tie(a.depth, a.texture, a.blendMode) < std::tie(b.depth, b.texture, b.blendMode);
+    }
+}
+
+SpriteBenchmarkState::SpriteBenchmarkState(cro::StateStack& stack, cro::State::Context context)
+    : BenchmarkState    (stack, context),
+    m_randomEngine      (1234),
+    m_shuffle           (false),
+    m_insertionSortTime (0.f),
+    m_stableSortTime    (0.f),
+    m_results           (),
+    m_orderErrors       (0),
+    m_batchErrors       (0),
+    m_bufferCount       (0)
+{
+    load();
+}
+
+//private
+void SpriteBenchmarkState::load()
+{
+    auto& scene = getScene();
+    scene.addSystem<cro::SpriteRenderer>(getContext().appInstance.getMessageBus());
+
+    //more textures than can be bound to a single batch
+    for (auto i = 0u; i < TextureCount; ++i)
+    {
+        const float hue = static_cast<float>(i) / TextureCount;
+        cro::Image image;
+        image.create(8, 8, cro::Colour(hue, 1.f - hue, 0.5f));
+
+        m_textures[i].create(8, 8);
+        m_textures[i].update(image.getPixelData(), false);
+    }
+
+    std::uniform_real_distribution<float> x(0.f, SceneSize.x - 8.f);
+    std::uniform_real_distribution<float> y(300.f, SceneSize.y - 8.f);
+    std::uniform_int_distribution<std::size_t> texture(0, TextureCount - 1);
+    std::uniform_int_distribution<std::size_t> layer(0, DepthLayers - 1);
+
+    for (auto i = 0u; i < SpriteCount; ++i)
+    {
+        auto entity = scene.createEntity();
+        entity.addComponent<cro::Transform>().setPosition({ x(m_randomEngine), y(m_randomEngine), -static_cast<float>(layer(m_randomEngine)) });
+
+        SpriteInfo info;
+        const auto& tex = m_textures[texture(m_randomEngine)];
+        info.texture = tex.getGLHandle();
+        info.blendMode = (i % 16 == 0) ? cro::Material::BlendMode::Additive : cro::Material::BlendMode::Alpha;
+        entity.addComponent<cro::Sprite>().setTexture(tex);
+        entity.getComponent<cro::Sprite>().setBlendMode(info.blendMode);
+
+        if (entity.getIndex() >= m_spriteInfo.size())
+        {
+            m_spriteInfo.resize(entity.getIndex() + 1);
+        }
+        m_spriteInfo[entity.getIndex()] = info;
+        m_sprites.push_back(entity);
+    }
+    //the renderer starts with the sprites in the order they were created
+    m_previousOrder = m_sprites;
+
+    auto entity = scene.createEntity();
+    entity.addComponent<cro::Transform>();
+    entity.addComponent<cro::Camera>().projection = glm::ortho(0.f, SceneSize.x, 0.f, SceneSize.y, -10.f, 10.f);
+    scene.setActiveCamera(entity);
+
+    setResultPosition({ 40.f, 240.f });
+}
+
+void SpriteBenchmarkState::update(cro::Time)
+{
+    updateDepths();
+}
+
+void SpriteBenchmarkState::postUpdate()
+{
+    compareSorts();
+    validateBatches();
+}
+
+void SpriteBenchmarkState::onSample(float sceneTime)
+{
+    auto& result = m_results[m_shuffle ? 1 : 0];
+    result[0] = sceneTime;
+    result[1] = m_insertionSortTime / SampleFrames;
+    result[2] = m_stableSortTime / SampleFrames;
+
+    const auto& renderer = getScene().getSystem<cro::SpriteRenderer>();
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << "Sprites: " << renderer.getVisibleCount() << " in " << m_bufferCount << " VBOs of " << renderer.getSpritesPerBuffer() << "\n";
+    ss << "Draw calls: " << renderer.getDrawCount() << "\n";
+    for (auto i = 0u; i < m_results.size(); ++i)
+    {
+        ss << TestNames[i] << ": process " << m_results[i][0] << "ms, ";
+        ss << "insertion sort " << m_results[i][1] << "ms, std::stable_sort " << m_results[i][2] << "ms\n";
+    }
+    ss << "Draw order errors: " << m_orderErrors << ", batch errors: " << m_batchErrors;
+    setResults(ss.str());
+
+    m_insertionSortTime = 0.f;
+    m_stableSortTime = 0.f;
+    m_shuffle = !m_shuffle;
+}
+
+void SpriteBenchmarkState::updateDepths()
+{
+    std::uniform_int_distribution<std::size_t> layer(0, DepthLayers - 1);
+    std::uniform_int_distribution<std::size_t> sprite(0, SpriteCount - 1);
+
+    const auto count = m_shuffle ? SpriteCount : MovedPerFrame;
+    for (auto i = 0u; i < count; ++i)
+    {
+        auto& tx = m_sprites[m_shuffle ? i : sprite(m_randomEngine)].getComponent<cro::Transform>();
+        auto position = tx.getPosition();
+        position.z = -static_cast<float>(layer(m_randomEngine));
+        tx.setPosition(position);
+    }
+}
+
+void SpriteBenchmarkState::compareSorts()
+{
+    //sort the previous draw order with the same keys the renderer just used
+    std::vector<SortItem> items;
+    items.reserve(m_previousOrder.size());
+    for (auto entity : m_previousOrder)
+    {
+        const auto& info = m_spriteInfo[entity.getIndex()];
+        items.push_back({ entity.getComponent<cro::Transform>().getWorldTransform()[3].z, info.texture, info.blendMode, entity });
+    }
+    auto stableItems = items;
+
+    m_insertionSortTime += measure([&]() { cro::Detail::insertionSort(items.begin(), items.end(), isLess); });
+    m_stableSortTime += measure([&]() { std::stable_sort(stableItems.begin(), stableItems.end(), isLess); });
+
+    //all the sprites are in view so every one of them should be drawn
+    const auto& drawOrder = getScene().getSystem<cro::SpriteRenderer>().getVisibleEntities();
+    if (drawOrder.size() != items.size())
+    {
+        m_orderErrors++;
+    }
+    else
+    {
+        for (auto i = 0u; i < items.size(); ++i)
+        {
+            if (items[i].entity.getIndex() != stableItems[i].entity.getIndex()
+                || drawOrder[i].getIndex() != stableItems[i].entity.getIndex())
+            {
+                m_orderErrors++;
+                break;
+            }
+        }
+    }
+    m_previousOrder = drawOrder;
+}
+
+void SpriteBenchmarkState::validateBatches()
+{
+    const auto& renderer = getScene().getSystem<cro::SpriteRenderer>();
+    const auto& sprites = renderer.getVisibleEntities();
+    const auto batches = renderer.getBatches();
+    const auto spritesPerBuffer = renderer.getSpritesPerBuffer();
+
+    std::size_t errors = 0;
+    std::size_t nextSprite = 0;
+    std::size_t bufferStart = 0;
+    m_bufferCount = 0;
+
+    for (auto i = 0u; i < batches.size(); ++i)
+    {
+        const auto& batch = batches[i];
+
+        //batches should cover the sprites in order without gaps
+        if (batch.firstSprite != nextSprite
+            || batch.spriteCount == 0
+            || batch.firstSprite + batch.spriteCount > sprites.size())
+        {
+            errors++;
+            break;
+        }
+
+        if (i == 0 || batch.vbo != batches[i - 1].vbo)
+        {
+            //every VBO except the last should be full
+            if (batch.firstSprite % spritesPerBuffer != 0)
+            {
+                errors++;
+            }
+            bufferStart = batch.firstSprite;
+            m_bufferCount++;
+        }
+        else
+        {
+            //a batch should only be broken when the blend mode changes or
+            //when the previous batch was missing the next sprite's texture
+            const auto& previous = batches[i - 1];
+            const auto& info = m_spriteInfo[sprites[batch.firstSprite].getIndex()];
+            if (info.blendMode == previous.blendMode
+                && std::find(previous.textures.begin(), previous.textures.end(), info.texture) != previous.textures.end())
+            {
+                errors++;
+            }
+        }
+
+        if (batch.firstSprite + batch.spriteCount - bufferStart > spritesPerBuffer)
+        {
+            errors++;
+        }
+
+        for (auto j = batch.firstSprite; j < batch.firstSprite + batch.spriteCount; ++j)
+        {
+            const auto& info = m_spriteInfo[sprites[j].getIndex()];
+            if (info.blendMode != batch.blendMode
+                || std::find(batch.textures.begin(), batch.textures.end(), info.texture) == batch.textures.end())
+            {
+                errors++;
+                break;
+            }
+        }
+        nextSprite += batch.spriteCount;
+    }
+
+    if (nextSprite != sprites.size()
+        || m_bufferCount != (sprites.size() + spritesPerBuffer - 1) / spritesPerBuffer)
+    {
+        errors++;
+    }
+    m_batchErrors += errors;
+}
\ No newline at end of file
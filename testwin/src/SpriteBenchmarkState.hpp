@@ -0,0 +1,97 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine test application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#ifndef TL_SPRITE_BENCHMARK_STATE_HPP_
+#define TL_SPRITE_BENCHMARK_STATE_HPP_
+
+#include "BenchmarkState.hpp"
+#include "StateIDs.hpp"
+
+#include <crogine/graphics/Texture.hpp>
+#include <crogine/graphics/MaterialData.hpp>
+
+#include <array>
+#include <random>
+#include <vector>
+
+/*
+Draws 10000 sprites spread across several VBOs, using more textures than
+a single batch can bind and a mix of blend modes. Each frame the sprites
+are moved between depth layers and the batches created by the sprite
+renderer are checked, as is its draw order, which is compared with the
+result of std::stable_sort. The insertion sort used by the renderer is
+timed against std::stable_sort, both when only a few sprites change depth
+and when they are all shuffled. The two cases alternate each sample.
+*/
+class SpriteBenchmarkState final : public BenchmarkState
+{
+public:
+    SpriteBenchmarkState(cro::StateStack&, cro::State::Context);
+    ~SpriteBenchmarkState() = default;
+
+    cro::StateID getStateID() const override { return States::SpriteBenchmark; }
+
+private:
+
+    static constexpr std::size_t TextureCount = 12;
+    std::array<cro::Texture, TextureCount> m_textures;
+
+    //what the sprite renderer should sort each sprite by, indexed by entity ID
+    struct SpriteInfo final
+    {
+        cro::int32 texture = 0;
+        cro::Material::BlendMode blendMode = cro::Material::BlendMode::Alpha;
+    };
+    std::vector<SpriteInfo> m_spriteInfo;
+    std::vector<cro::Entity> m_sprites;
+    std::vector<cro::Entity> m_previousOrder;
+
+    std::mt19937 m_randomEngine;
+    bool m_shuffle; //else only a few sprites change depth each frame
+
+    //accumulated milliseconds
+    float m_insertionSortTime;
+    float m_stableSortTime;
+    std::array<std::array<float, 3u>, 2u> m_results; //per test, per timing
+
+    std::size_t m_orderErrors;
+    std::size_t m_batchErrors;
+    std::size_t m_bufferCount;
+
+    void load();
+    void updateDepths();
+    void compareSorts();
+    void validateBatches();
+
+    void update(cro::Time) override;
+    void postUpdate() override;
+    void onSample(float) override;
+};
+
+#endif //TL_SPRITE_BENCHMARK_STATE_HPP_
\ No newline at end of file
@@ -38,7 +38,13 @@ namespace States
         PauseMenu,
         GamePlaying,
         RoundEnd,
-        GameOver
+        GameOver,
+        TextBenchmark,
+        ParticleBenchmark,
+        CullBenchmark,
+        SpriteBenchmark,
+        OcclusionBenchmark,
+        RecorderTest
 	};
 }
 
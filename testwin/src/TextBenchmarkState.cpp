@@ -0,0 +1,116 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine test application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#include "TextBenchmarkState.hpp"
+
+#include <crogine/core/App.hpp>
+#include <crogine/ecs/components/Text.hpp>
+#include <crogine/ecs/components/Camera.hpp>
+#include <crogine/ecs/components/Transform.hpp>
+#include <crogine/ecs/systems/TextRenderer.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+    const std::size_t LabelCount = 500;
+    const std::size_t CounterCount = 5;
+}
+
+TextBenchmarkState::TextBenchmarkState(cro::StateStack& stack, cro::State::Context context)
+    : BenchmarkState(stack, context),
+    m_textRenderer  (nullptr),
+    m_frameCount    (0),
+    m_updateCount   (0)
+{
+    load();
+}
+
+//private
+void TextBenchmarkState::load()
+{
+    auto& scene = getScene();
+    m_textRenderer = &scene.addSystem<cro::TextRenderer>(getContext().appInstance.getMessageBus());
+
+    //static labels
+    const std::size_t columns = 20;
+    const glm::vec2 cellSize(SceneSize.x / columns, (SceneSize.y - 200.f) / (LabelCount / columns));
+    for (auto i = 0u; i < LabelCount; ++i)
+    {
+        auto entity = scene.createEntity();
+        entity.addComponent<cro::Text>(getFont()).setString("Label " + std::to_string(i));
+        entity.getComponent<cro::Text>().setCharSize(16);
+        entity.addComponent<cro::Transform>().setPosition({ (i % columns) * cellSize.x, SceneSize.y - ((i / columns) * cellSize.y), 0.f });
+    }
+
+    //counters which change every frame
+    for (auto i = 0u; i < CounterCount; ++i)
+    {
+        auto entity = scene.createEntity();
+        entity.addComponent<cro::Text>(getFont()).setCharSize(30);
+        entity.getComponent<cro::Text>().setColour(cro::Colour::Yellow());
+        entity.addComponent<cro::Transform>().setPosition({ 40.f + (i * 300.f), 160.f, 0.f });
+        m_counters.push_back(entity);
+    }
+
+    auto entity = scene.createEntity();
+    entity.addComponent<cro::Transform>();
+    entity.addComponent<cro::Camera>().projection = glm::ortho(0.f, SceneSize.x, 0.f, SceneSize.y, -0.1f, 10.f);
+    scene.setActiveCamera(entity);
+
+    setResultPosition({ 40.f, 100.f });
+}
+
+void TextBenchmarkState::update(cro::Time)
+{
+    m_frameCount++;
+    for (auto i = 0u; i < m_counters.size(); ++i)
+    {
+        m_counters[i].getComponent<cro::Text>().setString(std::to_string(m_frameCount * (i + 1)));
+    }
+}
+
+void TextBenchmarkState::postUpdate()
+{
+    m_updateCount += m_textRenderer->getUpdateCount();
+}
+
+void TextBenchmarkState::onSample(float sceneTime)
+{
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << "Scene update: " << sceneTime << "ms\n";
+    ss << "Texts uploaded per frame: " << (m_updateCount / SampleFrames);
+    setResults(ss.str());
+
+    m_updateCount = 0;
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+/*-----------------------------------------------------------------------
+
+Matt Marchant 2017
+http://trederia.blogspot.com
+
+crogine test application - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty.In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions :
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+
+-----------------------------------------------------------------------*/
+
+#ifndef TL_TEXT_BENCHMARK_STATE_HPP_
+#define TL_TEXT_BENCHMARK_STATE_HPP_
+
+#include "BenchmarkState.hpp"
+#include "StateIDs.hpp"
+
+#include <vector>
+
+namespace cro
+{
+    class TextRenderer;
+}
+
+/*
+Measures the cost of updating the text renderer with a scene made up of
+500 static labels and 5 counters which change every frame, similar to a HUD.
+The number of texts which had to be uploaded each frame is shown with the
+update time, and should only include the counters.
+*/
+class TextBenchmarkState final : public BenchmarkState
+{
+public:
+    TextBenchmarkState(cro::StateStack&, cro::State::Context);
+    ~TextBenchmarkState() = default;
+
+    cro::StateID getStateID() const override { return States::TextBenchmark; }
+
+private:
+
+    cro::TextRenderer* m_textRenderer;
+
+    std::vector<cro::Entity> m_counters;
+    cro::uint32 m_frameCount;
+    std::size_t m_updateCount;
+
+    void load();
+
+    void update(cro::Time) override;
+    void postUpdate() override;
+    void onSample(float) override;
+};
+
+#endif //TL_TEXT_BENCHMARK_STATE_HPP_
\ No newline at end of file